@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../strategies/order_book_imbalance.hpp"
+#include "../core/instrument_master.hpp"
+#include "../core/volatility_estimator.hpp"
 #include <cmath>
 
 namespace trading {
@@ -11,9 +13,18 @@ namespace trading {
 class CryptoOBIOptimized {
 public:
     // ✅ JANE STREET PRINCIPLE #1: Adaptive volatility-based thresholds
+    // Symbol may be canonical ("BTCUSDT") or any venue spelling ("BTC-USD")
     static OrderBookImbalanceStrategy::Config get_adaptive_config(
         const std::string& symbol,
         double current_volatility_bps)
+    {
+        return get_adaptive_config(InstrumentMaster::instance().resolve_any(symbol),
+                                   current_volatility_bps);
+    }
+    
+    static OrderBookImbalanceStrategy::Config get_adaptive_config(
+        SymbolRegistry::SymbolId symbol_id,
+        double current_volatility_bps)
     {
         OrderBookImbalanceStrategy::Config config;
         
@@ -40,13 +51,11 @@ public:
             config.signal_decay_ms = 100;
         }
         
-        // Symbol-specific overrides
-        if (symbol == "SOLUSD") {
-            config.imbalance_threshold -= 0.03;     // SOL more volatile, be aggressive
-            config.target_profit_bps += 1.0;
-        } else if (symbol == "BTCUSD" || symbol == "ETHUSD") {
-            config.imbalance_threshold += 0.02;     // Major pairs tighter spreads
-            config.target_profit_bps -= 0.5;
+        // Symbol-specific overrides from the instrument master
+        // (SOL more volatile -> aggressive; majors tighter spreads -> selective)
+        if (const Instrument* instrument = InstrumentMaster::instance().get(symbol_id)) {
+            config.imbalance_threshold += instrument->obi_threshold_offset;
+            config.target_profit_bps += instrument->obi_target_offset_bps;
         }
         
         config.num_levels = 12;                     // Deep analysis
@@ -105,49 +114,55 @@ public:
         return base_position_size * performance_multiplier;
     }
     
-    // Calculate current volatility (helper function)
+    // Current volatility from the shared per-symbol estimator (O(1), no allocation)
+    // horizon indexes VolatilityEstimator::Config::realized_windows (default 60 samples)
+    static double calculate_volatility_bps(
+        const VolatilityEstimator& volatility,
+        size_t horizon = 1,
+        int lookback_minutes = 60)
+    {
+        return annualize_bps(volatility.realized_stdev(horizon), lookback_minutes);
+    }
+    
+    // Calculate current volatility (helper function) - single pass, no allocation
     static double calculate_volatility_bps(
         const std::vector<double>& recent_prices,
         int lookback_minutes = 60)
     {
         if (recent_prices.size() < 2) return 0.0;
         
-        // Calculate returns
-        std::vector<double> returns;
+        // Welford running mean/variance of returns
+        double mean = 0.0;
+        double m2 = 0.0;
+        size_t n = 0;
         for (size_t i = 1; i < recent_prices.size(); ++i) {
             double ret = (recent_prices[i] - recent_prices[i-1]) / recent_prices[i-1];
-            returns.push_back(ret);
+            double delta = ret - mean;
+            mean += delta / static_cast<double>(++n);
+            m2 += delta * (ret - mean);
         }
         
-        // Calculate standard deviation
-        double mean = 0.0;
-        for (double ret : returns) mean += ret;
-        mean /= returns.size();
-        
-        double variance = 0.0;
-        for (double ret : returns) {
-            variance += (ret - mean) * (ret - mean);
-        }
-        variance /= returns.size();
+        double std_dev = std::sqrt(m2 / static_cast<double>(n));
         
-        double std_dev = std::sqrt(variance);
-        
-        // Annualize and convert to bps
-        // sqrt(525600 minutes/year) × std_dev × 10000 bps
-        double annualized_vol_bps = std_dev * std::sqrt(525600.0 / lookback_minutes) * 10000.0;
-        
-        return annualized_vol_bps;
+        return annualize_bps(std_dev, lookback_minutes);
+    }
+    
+private:
+    // Annualize and convert to bps
+    // sqrt(525600 minutes/year) × std_dev × 10000 bps
+    static double annualize_bps(double std_dev, int lookback_minutes) {
+        return std_dev * std::sqrt(525600.0 / lookback_minutes) * 10000.0;
     }
 };
 
 // USAGE EXAMPLE:
 //
-// // Calculate current volatility
-// std::vector<double> last_60_prices = get_recent_prices("BTCUSD", 60);
-// double vol_bps = CryptoOBIOptimized::calculate_volatility_bps(last_60_prices);
+// // Calculate current volatility (shared estimator fed by the coordinator)
+// const VolatilityEstimator* vol = coordinator.volatility().get(symbols::BTCUSDT);
+// double vol_bps = vol ? CryptoOBIOptimized::calculate_volatility_bps(*vol) : 0.0;
 //
 // // Get adaptive config
-// auto config = CryptoOBIOptimized::get_adaptive_config("BTCUSD", vol_bps);
+// auto config = CryptoOBIOptimized::get_adaptive_config("BTCUSDT", vol_bps);
 // OrderBookImbalanceStrategy obi_strategy(config);
 //
 // // Calculate Kelly position size
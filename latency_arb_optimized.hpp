@@ -1,7 +1,11 @@
 #pragma once
 
 #include "../strategies/latency_arbitrage.hpp"
+#include "../strategies/arb_sizing.hpp"
+#include "../core/fee_engine.hpp"
+#include "../core/instrument_master.hpp"
 #include "../core/types.hpp"
+#include "../market_data/consolidated_bbo.hpp"
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
@@ -88,8 +92,11 @@ public:
         {}
     };
     
-    explicit LatencyArbOptimized(const Config& config)
+    // Fees from the engine (tiered, live); without one, the instrument
+    // master's static per-venue rates
+    explicit LatencyArbOptimized(const Config& config, const FeeEngine* fees = nullptr)
         : config_(config)
+        , fees_(fees ? fees : &static_fees())
         , active_arbs_(0)
         , opportunities_last_minute_(0)
         , last_opportunity_time_(Clock::now())
@@ -100,6 +107,22 @@ public:
         const std::string& symbol,
         const std::unordered_map<Venue, OrderBook>& books,
         const std::unordered_map<Venue, TimePoint>& timestamps)
+    {
+        auto now = Clock::now();
+        InstrumentBBO bbo;
+        for (const auto& [venue, book] : books) {
+            auto ts_it = timestamps.find(venue);
+            bbo.update(venue, book, ts_it != timestamps.end() ? ts_it->second : now);
+        }
+        return detect_global_best_opportunity(symbol, bbo, books);
+    }
+    
+    // Global best from the consolidated BBO: best buy/sell venues are the
+    // tournament roots (O(1)); books are only walked for the slippage check
+    std::optional<EnhancedArbOpportunity> detect_global_best_opportunity(
+        const std::string& symbol,
+        const InstrumentBBO& bbo,
+        const std::unordered_map<Venue, OrderBook>& books)
     {
         auto start = Clock::now();
         
@@ -107,39 +130,24 @@ public:
             return std::nullopt;
         }
         
-        // Find cheapest venue to buy (lowest ask)
-        Venue best_buy_venue = Venue::UNKNOWN;
-        double best_buy_price = std::numeric_limits<double>::max();
-        double best_buy_liquidity = 0.0;
+        // Cheapest venue to buy (lowest ask), most expensive to sell (highest bid)
+        Venue best_buy_venue = bbo.best_ask_venue();
+        Venue best_sell_venue = bbo.best_bid_venue();
         
-        for (const auto& [venue, book] : books) {
-            double ask = book.get_best_ask();
-            if (ask > 0.0 && ask < best_buy_price) {
-                best_buy_price = ask;
-                best_buy_venue = venue;
-                
-                const auto& asks = book.get_asks();
-                if (!asks.empty()) {
-                    best_buy_liquidity = asks.begin()->second;
-                }
-            }
-        }
-        
-        // Find most expensive venue to sell (highest bid)
-        Venue best_sell_venue = Venue::UNKNOWN;
-        double best_sell_price = 0.0;
-        double best_sell_liquidity = 0.0;
-        
-        for (const auto& [venue, book] : books) {
-            double bid = book.get_best_bid();
-            if (bid > best_sell_price) {
-                best_sell_price = bid;
-                best_sell_venue = venue;
-                
-                const auto& bids = book.get_bids();
-                if (!bids.empty()) {
-                    best_sell_liquidity = bids.begin()->second;
-                }
+        // Both on one venue: take the better runner-up on either side
+        if (best_buy_venue != Venue::UNKNOWN && best_buy_venue == best_sell_venue) {
+            Venue other_buy = bbo.best_ask_venue_excluding(best_sell_venue);
+            Venue other_sell = bbo.best_bid_venue_excluding(best_buy_venue);
+            
+            double spread_other_buy = other_buy == Venue::UNKNOWN ? -1.0
+                : bbo.touch(best_sell_venue).bid / bbo.touch(other_buy).ask;
+            double spread_other_sell = other_sell == Venue::UNKNOWN ? -1.0
+                : bbo.touch(other_sell).bid / bbo.touch(best_buy_venue).ask;
+            
+            if (spread_other_buy >= spread_other_sell) {
+                best_buy_venue = other_buy;
+            } else {
+                best_sell_venue = other_sell;
             }
         }
         
@@ -150,6 +158,13 @@ public:
             return std::nullopt;
         }
         
+        const auto& buy_touch = bbo.touch(best_buy_venue);
+        const auto& sell_touch = bbo.touch(best_sell_venue);
+        double best_buy_price = buy_touch.ask;
+        double best_sell_price = sell_touch.bid;
+        double best_buy_liquidity = buy_touch.ask_qty;
+        double best_sell_liquidity = sell_touch.bid_qty;
+        
         // Build opportunity
         EnhancedArbOpportunity opp;
         opp.symbol = symbol;
@@ -163,20 +178,24 @@ public:
         // Calculate gross profit
         opp.gross_profit_bps = ((best_sell_price - best_buy_price) / best_buy_price) * 10000.0;
         
-        // Calculate fees
-        opp.fees_bps = get_fee_bps(best_buy_venue) + get_fee_bps(best_sell_venue);
+        // Calculate fees (taker on both legs); venue spellings ("BTC-USD") resolve too
+        SymbolRegistry::SymbolId symbol_id = InstrumentMaster::instance().resolve_any(symbol);
+        double buy_fee_bps = taker_fee_bps(symbol_id, best_buy_venue);
+        double sell_fee_bps = taker_fee_bps(symbol_id, best_sell_venue);
+        opp.fees_bps = buy_fee_bps + sell_fee_bps;
         
-        // ✅ ESTIMATE SLIPPAGE (adverse selection protection)
+        // ✅ SIZE AGAINST DEPTH - one merge walk of both ladders gives the
+        // profit-maximizing size and its slippage (adverse selection protection)
         auto buy_book_it = books.find(best_buy_venue);
         auto sell_book_it = books.find(best_sell_venue);
         
+        ArbSizing sizing;
         if (buy_book_it != books.end() && sell_book_it != books.end()) {
-            double target_qty = config_.position_size_usd / best_buy_price;
-            
-            double buy_slippage = estimate_slippage(buy_book_it->second, target_qty, Side::BUY);
-            double sell_slippage = estimate_slippage(sell_book_it->second, target_qty, Side::SELL);
+            sizing = optimize_arb_size(buy_book_it->second.ask_ladder(), buy_fee_bps,
+                                       sell_book_it->second.bid_ladder(), sell_fee_bps,
+                                       config_.position_size_usd);
             
-            opp.slippage_bps = (buy_slippage + sell_slippage) * 10000.0;
+            opp.slippage_bps = sizing.slippage_bps(best_buy_price, best_sell_price);
             
             // ✅ REJECT if slippage too high (adverse selection)
             if (opp.slippage_bps > config_.max_slippage_bps) {
@@ -192,14 +211,11 @@ public:
         auto now = Clock::now();
         int64_t max_age = 0;
         
-        for (const auto& venue : {best_buy_venue, best_sell_venue}) {
-            auto ts_it = timestamps.find(venue);
-            if (ts_it != timestamps.end()) {
-                auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now - ts_it->second
-                ).count();
-                max_age = std::max(max_age, age);
-            }
+        for (const auto& touch : {buy_touch, sell_touch}) {
+            auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - touch.updated
+            ).count();
+            max_age = std::max<int64_t>(max_age, age);
         }
         
         opp.orderbook_age_ms = max_age;
@@ -217,15 +233,20 @@ public:
             return opp;
         }
         
-        // Calculate execution size
-        double max_qty_buy = best_buy_liquidity;
-        double max_qty_sell = best_sell_liquidity;
-        double max_qty = std::min(max_qty_buy, max_qty_sell);
-        double max_notional = max_qty * best_buy_price;
-        
-        double target_notional = std::min(config_.position_size_usd, max_notional);
-        opp.execute_quantity = target_notional / best_buy_price;
-        opp.expected_profit_usd = (opp.net_profit_bps / 10000.0) * target_notional;
+        // Calculate execution size (touch only when a book is missing)
+        if (sizing.quantity > 0.0) {
+            opp.buy_price = sizing.buy_limit;
+            opp.sell_price = sizing.sell_limit;
+            opp.execute_quantity = sizing.quantity;
+            opp.expected_profit_usd = sizing.expected_pnl;
+        } else {
+            double max_qty = std::min(best_buy_liquidity, best_sell_liquidity);
+            double max_notional = max_qty * best_buy_price;
+            
+            double target_notional = std::min(config_.position_size_usd, max_notional);
+            opp.execute_quantity = target_notional / best_buy_price;
+            opp.expected_profit_usd = (opp.net_profit_bps / 10000.0) * target_notional;
+        }
         
         // Detection latency
         auto end = Clock::now();
@@ -257,6 +278,7 @@ public:
     
 private:
     Config config_;
+    const FeeEngine* fees_;
     std::atomic<int> active_arbs_;
     std::atomic<int> opportunities_last_minute_;
     TimePoint last_opportunity_time_;
@@ -276,30 +298,13 @@ private:
         return config_.base_min_profit_bps;
     }
     
-    // ✅ SLIPPAGE ESTIMATION
-    double estimate_slippage(const OrderBook& book, double quantity, Side side) const {
-        double total_value = 0.0;
-        double remaining_qty = quantity;
-        
-        const auto& levels = (side == Side::BUY) ? book.get_asks() : book.get_bids();
-        
-        for (const auto& [price, level_qty] : levels) {
-            double fill_qty = std::min(remaining_qty, level_qty);
-            total_value += fill_qty * price;
-            remaining_qty -= fill_qty;
-            
-            if (remaining_qty <= 0.0) break;
+    // Engine schedule, else the instrument's static fee; with neither
+    // (unknown symbol, no schedule) a conservative retail taker rate
+    double taker_fee_bps(SymbolRegistry::SymbolId symbol_id, Venue venue) const {
+        if (fees_->has_schedule(symbol_id, venue) || InstrumentMaster::instance().contains(symbol_id)) {
+            return fees_->taker_bps(symbol_id, venue);
         }
         
-        if (total_value == 0.0) return 0.0;
-        
-        double vwap = total_value / quantity;
-        double best_price = (side == Side::BUY) ? book.get_best_ask() : book.get_best_bid();
-        
-        return std::abs(vwap - best_price) / best_price;
-    }
-    
-    double get_fee_bps(Venue venue) const {
         switch (venue) {
             case Venue::BINANCE: return 10.0;   // 0.10% taker
             case Venue::KRAKEN: return 16.0;    // 0.16% taker
@@ -307,6 +312,11 @@ private:
             default: return 20.0;
         }
     }
+    
+    static const FeeEngine& static_fees() {
+        static const FeeEngine fees;
+        return fees;
+    }
 };
 
 // USAGE EXAMPLE:
@@ -314,11 +324,12 @@ private:
 // LatencyArbOptimized::Config config;
 // config.enable_global_best = true;
 // config.max_slippage_bps = 8.0;
-// LatencyArbOptimized arb_strategy(config);
+// LatencyArbOptimized arb_strategy(config, &fee_engine);
 //
-// // Detect best opportunity across all venues
+// // Detect best opportunity across all venues (bbo kept current by the
+// // market data thread: consolidated.update(symbol_id, venue, book))
 // auto opp = arb_strategy.detect_global_best_opportunity(
-//     "BTCUSD", all_books, timestamps
+//     "BTCUSD", *consolidated.get(symbol_id), all_books
 // );
 //
 // if (opp.has_value() && opp->is_valid) {
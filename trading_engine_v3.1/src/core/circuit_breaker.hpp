@@ -1,11 +1,16 @@
 #pragma once
 
 #include "types.hpp"
+#include "sliding_window_counter.hpp"
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <functional>
 #include <string>
+#include <utility>
 
 namespace trading {
 
@@ -43,7 +48,13 @@ public:
     
     // Check if request is allowed
     bool allow_request() {
-        auto state = state_.load(std::memory_order_acquire);
+        // Fast path: CLOSED needs no clock read and no ordering
+        auto state = state_.load(std::memory_order_relaxed);
+        if (state == CircuitState::CLOSED) [[likely]] {
+            return true;
+        }
+        
+        state = state_.load(std::memory_order_acquire);
         
         if (state == CircuitState::OPEN) {
             // Check if timeout has elapsed
@@ -61,6 +72,7 @@ public:
                                                    std::memory_order_acq_rel)) {
                     half_open_start_ = now;
                     LOG_WARN("Circuit breaker " << name_ << " entering HALF_OPEN state");
+                    notify(CircuitState::HALF_OPEN);
                 }
                 return true;  // Allow test request
             }
@@ -102,6 +114,7 @@ public:
                     failure_count_.store(0, std::memory_order_relaxed);
                     success_count_.store(0, std::memory_order_relaxed);
                     LOG_INFO("Circuit breaker " << name_ << " CLOSED (recovered)");
+                    notify(CircuitState::CLOSED);
                 }
             }
         } else if (state == CircuitState::CLOSED) {
@@ -141,6 +154,7 @@ public:
             last_failure_time_.store(Clock::now(), std::memory_order_release);
             
             LOG_ERROR("Circuit breaker " << name_ << " OPENED: " << reason);
+            notify(CircuitState::OPEN);
         }
     }
     
@@ -151,6 +165,7 @@ public:
         success_count_.store(0, std::memory_order_relaxed);
         
         LOG_INFO("Circuit breaker " << name_ << " manually CLOSED");
+        notify(CircuitState::CLOSED);
     }
     
     // Get state
@@ -164,20 +179,151 @@ public:
     
     const std::string& name() const { return name_; }
     
+    // Called on every state transition (set once, before use)
+    void set_state_listener(std::function<void(CircuitState)> listener) {
+        state_listener_ = std::move(listener);
+    }
+    
 private:
     std::string name_;
     Config config_;
+    std::function<void(CircuitState)> state_listener_;
     
     std::atomic<CircuitState> state_;
     std::atomic<int> failure_count_;
     std::atomic<int> success_count_;
     std::atomic<TimePoint> last_failure_time_;
     TimePoint half_open_start_;
+    
+    void notify(CircuitState state) {
+        if (state_listener_) {
+            state_listener_(state);
+        }
+    }
+};
+
+// Circuit breaker registry - one breaker per (venue, order type) plus one
+// venue-wide breaker (session / connectivity) per venue.
+// Every non-CLOSED breaker has its bit set in open_mask, so the order path
+// answers "is anything tripped for this order?" with one relaxed load.
+class CircuitBreakerRegistry {
+public:
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t NUM_ORDER_TYPES = static_cast<size_t>(OrderType::STOP_LIMIT) + 1;
+    static constexpr size_t SLOTS_PER_VENUE = NUM_ORDER_TYPES + 1;  // Last slot = venue-wide
+    static constexpr size_t NUM_SLOTS = NUM_VENUES * SLOTS_PER_VENUE;
+    static_assert(NUM_SLOTS <= 64, "open mask must fit one word");
+    
+    explicit CircuitBreakerRegistry(const CircuitBreaker::Config& config = CircuitBreaker::Config()) {
+        for (size_t v = 0; v < NUM_VENUES; ++v) {
+            const char* venue_name = to_string(static_cast<Venue>(v));
+            
+            for (size_t t = 0; t < SLOTS_PER_VENUE; ++t) {
+                std::string name = std::string(venue_name) + "/" +
+                    (t < NUM_ORDER_TYPES ? to_string(static_cast<OrderType>(t)) : "*");
+                
+                size_t slot = v * SLOTS_PER_VENUE + t;
+                breakers_[slot] = std::make_unique<CircuitBreaker>(name, config);
+                breakers_[slot]->set_state_listener([this, slot](CircuitState state) {
+                    uint64_t bit = uint64_t(1) << slot;
+                    if (state == CircuitState::CLOSED) {
+                        open_mask_.fetch_and(~bit, std::memory_order_release);
+                    } else {
+                        open_mask_.fetch_or(bit, std::memory_order_release);
+                    }
+                });
+            }
+        }
+    }
+    
+    CircuitBreakerRegistry(const CircuitBreakerRegistry&) = delete;
+    CircuitBreakerRegistry& operator=(const CircuitBreakerRegistry&) = delete;
+    
+    CircuitBreaker& breaker(Venue venue, OrderType type) {
+        return *breakers_[slot(venue, type)];
+    }
+    
+    CircuitBreaker& venue_breaker(Venue venue) {
+        return *breakers_[venue_slot(venue)];
+    }
+    
+    // Bits covering an order: its (venue, type) breaker + the venue-wide one
+    static uint64_t order_bits(Venue venue, OrderType type) {
+        return (uint64_t(1) << slot(venue, type)) | (uint64_t(1) << venue_slot(venue));
+    }
+    
+    uint64_t open_mask() const {
+        return open_mask_.load(std::memory_order_relaxed);
+    }
+    
+    // Hot path: one relaxed load unless something for this order is tripped
+    bool allow(Venue venue, OrderType type) {
+        uint64_t tripped = open_mask() & order_bits(venue, type);
+        if (tripped == 0) [[likely]] {
+            return true;
+        }
+        
+        // Slow path: let the tripped breakers run their OPEN/HALF_OPEN logic
+        bool allowed = true;
+        if (tripped & (uint64_t(1) << venue_slot(venue))) {
+            allowed = venue_breaker(venue).allow_request();
+        }
+        if (allowed && (tripped & (uint64_t(1) << slot(venue, type)))) {
+            allowed = breaker(venue, type).allow_request();
+        }
+        return allowed;
+    }
+    
+    // Venue-wide breaker hard OPEN (HALF_OPEN still lets test traffic through)
+    bool venue_tripped(Venue venue) const {
+        if ((open_mask() & (uint64_t(1) << venue_slot(venue))) == 0) [[likely]] {
+            return false;
+        }
+        return breakers_[venue_slot(venue)]->is_open();
+    }
+    
+    void record_success(Venue venue, OrderType type) {
+        breaker(venue, type).record_success();
+        venue_breaker(venue).record_success();
+    }
+    
+    void record_failure(Venue venue, OrderType type, const std::string& reason = "") {
+        breaker(venue, type).record_failure(reason);
+    }
+    
+    // Connectivity / session failure - trips the whole venue
+    void record_venue_failure(Venue venue, const std::string& reason = "") {
+        venue_breaker(venue).record_failure(reason);
+    }
+    
+    // Manual override: close every tripped breaker
+    void close_all() {
+        uint64_t tripped = open_mask();
+        for (size_t slot = 0; slot < NUM_SLOTS; ++slot) {
+            if (tripped & (uint64_t(1) << slot)) {
+                breakers_[slot]->close();
+            }
+        }
+    }
+    
+private:
+    std::array<std::unique_ptr<CircuitBreaker>, NUM_SLOTS> breakers_;
+    std::atomic<uint64_t> open_mask_{0};
+    
+    static size_t slot(Venue venue, OrderType type) {
+        return static_cast<size_t>(venue) * SLOTS_PER_VENUE + static_cast<size_t>(type);
+    }
+    
+    static size_t venue_slot(Venue venue) {
+        return static_cast<size_t>(venue) * SLOTS_PER_VENUE + NUM_ORDER_TYPES;
+    }
 };
 
 // Emergency kill switch - immediately stops all trading
 class KillSwitch {
 public:
+    using HandlerId = uint64_t;
+    
     KillSwitch() : activated_(false) {}
     
     // Activate kill switch
@@ -190,9 +336,16 @@ public:
             LOG_ERROR("!!! KILL SWITCH ACTIVATED !!!");
             LOG_ERROR("Reason: " << reason);
             
-            // Execute all shutdown handlers
-            std::lock_guard<std::mutex> lock(handlers_mutex_);
-            for (auto& handler : shutdown_handlers_) {
+            // Execute all shutdown handlers (copied out: a slow handler
+            // must not block registration or re-entrant calls)
+            std::vector<std::pair<HandlerId, std::function<void()>>> handlers;
+            {
+                std::lock_guard<std::mutex> lock(handlers_mutex_);
+                handlers = shutdown_handlers_;
+            }
+            
+            std::lock_guard<std::mutex> running(dispatch_mutex_);
+            for (auto& [id, handler] : handlers) {
                 try {
                     handler();
                 } catch (const std::exception& e) {
@@ -205,9 +358,25 @@ public:
     }
     
     // Register shutdown handler (called when kill switch activated)
-    void register_shutdown_handler(std::function<void()> handler) {
+    HandlerId register_shutdown_handler(std::function<void()> handler) {
         std::lock_guard<std::mutex> lock(handlers_mutex_);
-        shutdown_handlers_.push_back(std::move(handler));
+        HandlerId id = next_handler_id_++;
+        shutdown_handlers_.emplace_back(id, std::move(handler));
+        return id;
+    }
+    
+    // Remove a handler; returns once no activation is still running it, so
+    // whatever the handler captured may be destroyed afterwards. Must not be
+    // called from inside a shutdown handler.
+    void unregister_shutdown_handler(HandlerId id) {
+        {
+            std::lock_guard<std::mutex> lock(handlers_mutex_);
+            shutdown_handlers_.erase(
+                std::remove_if(shutdown_handlers_.begin(), shutdown_handlers_.end(),
+                               [id](const auto& entry) { return entry.first == id; }),
+                shutdown_handlers_.end());
+        }
+        std::lock_guard<std::mutex> running(dispatch_mutex_);
     }
     
     // Check if activated
@@ -238,70 +407,61 @@ private:
     TimePoint activation_time_;
     
     std::mutex handlers_mutex_;
-    std::vector<std::function<void()>> shutdown_handlers_;
+    std::vector<std::pair<HandlerId, std::function<void()>>> shutdown_handlers_;
+    HandlerId next_handler_id_ = 1;
+    std::mutex dispatch_mutex_;     // Held while handlers run (see unregister)
 };
 
 // Error rate tracker (for circuit breaker decisions)
+// Bucketed sliding window: record/query are lock-free and never allocate,
+// so a reject storm costs one CAS per error instead of a locked vector erase.
 class ErrorRateTracker {
 public:
     struct Config {
         std::chrono::seconds window;    // Time window to track
         int threshold;                   // Max errors in window
+        size_t num_buckets;              // Window resolution (window / num_buckets)
         
         Config()
             : window(std::chrono::seconds(60))
             , threshold(10)
+            , num_buckets(60)
         {}
     };
     
     explicit ErrorRateTracker(const Config& config = Config())
         : config_(config)
+        , errors_(config.window, config.num_buckets)
     {}
     
     // Record error
     void record_error() {
-        auto now = Clock::now();
-        
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        // Remove old errors outside window
-        while (!error_times_.empty()) {
-            auto age = std::chrono::duration_cast<std::chrono::seconds>(
-                now - error_times_.front()
-            );
-            
-            if (age > config_.window) {
-                error_times_.erase(error_times_.begin());
-            } else {
-                break;
-            }
-        }
-        
-        error_times_.push_back(now);
+        errors_.add();
     }
     
     // Check if threshold exceeded
     bool threshold_exceeded() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return error_times_.size() >= static_cast<size_t>(config_.threshold);
+        return errors_.count() >= static_cast<uint64_t>(config_.threshold);
     }
     
     // Get current error count
     size_t get_error_count() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return error_times_.size();
+        return static_cast<size_t>(errors_.count());
+    }
+    
+    // Errors per second over the window
+    double get_error_rate() const {
+        return errors_.rate();
     }
     
     // Clear errors
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        error_times_.clear();
+        errors_.clear();
     }
     
 private:
     Config config_;
-    mutable std::mutex mutex_;
-    std::vector<TimePoint> error_times_;
+    SlidingWindowCounter errors_;
 };
 
 } // namespace trading
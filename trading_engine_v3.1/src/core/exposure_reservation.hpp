@@ -0,0 +1,366 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Exposure reserved by in-flight orders for one symbol
+struct SymbolReservation {
+    double pending_buy_qty;         // Reserved BUY quantity not yet filled/released
+    double pending_sell_qty;        // Reserved SELL quantity not yet filled/released
+
+    SymbolReservation() : pending_buy_qty(0.0), pending_sell_qty(0.0) {}
+
+    bool is_empty() const {
+        return pending_buy_qty < 0.0000001 && pending_sell_qty < 0.0000001;
+    }
+};
+
+// One leg of a group to reserve (built from an OrderIntent or Order)
+struct ReservationLeg {
+    SymbolRegistry::SymbolId symbol;
+    Side side;
+    double price;
+    double quantity;
+};
+
+// One leg of a reservation group
+struct ReservedLeg {
+    SymbolRegistry::SymbolId symbol;
+    Side side;
+    double remaining_qty;           // Reserved quantity still outstanding
+    double gross_per_unit;          // Gross exposure reserved per unit of quantity
+
+    ReservedLeg() : symbol(SymbolRegistry::INVALID_SYMBOL), side(Side::BUY),
+                    remaining_qty(0.0), gross_per_unit(0.0) {}
+};
+
+// Reservation ledger - sharded bookkeeping for in-flight exposure
+// Symbols map to independent shards (by SymbolId) so unrelated strategies
+// never contend; a multi-leg group locks only its shards (in index order,
+// deadlock-free). Gross exposure is a single atomic reserved with CAS
+// against the headroom.
+//
+// All storage is allocated up front: per-symbol pending quantities are
+// arrays indexed by SymbolId, and groups live in a fixed pool of slots with
+// a free list per shard. Reserving and releasing never touch the heap;
+// when every slot is in use, new groups are refused.
+class ExposureReservationLedger {
+public:
+    static constexpr size_t NUM_SHARDS = 16;
+    static constexpr size_t MAX_LEGS = 4;
+    static constexpr size_t DEFAULT_MAX_GROUPS = 4096;
+
+    using SymbolId = SymbolRegistry::SymbolId;
+    using ReservationId = uint64_t;
+    static constexpr ReservationId INVALID_RESERVATION = 0;
+
+    // RAII guard holding the symbol shards touched by a group of legs
+    class ShardGuard {
+    public:
+        ShardGuard(ExposureReservationLedger& ledger, std::span<const ReservationLeg> legs) {
+            std::array<bool, NUM_SHARDS> needed{};
+            for (const auto& leg : legs) {
+                needed[shard_index(leg.symbol)] = true;
+            }
+
+            // Always lock in ascending shard order
+            for (size_t i = 0; i < NUM_SHARDS; ++i) {
+                if (needed[i]) {
+                    locks_[count_++] = std::unique_lock<std::mutex>(ledger.symbol_shards_[i].mutex);
+                }
+            }
+        }
+
+        ShardGuard(const ShardGuard&) = delete;
+        ShardGuard& operator=(const ShardGuard&) = delete;
+
+    private:
+        std::array<std::unique_lock<std::mutex>, NUM_SHARDS> locks_;
+        size_t count_ = 0;
+    };
+
+    // max_groups: groups in flight at once (slots are split across shards)
+    explicit ExposureReservationLedger(size_t max_groups = DEFAULT_MAX_GROUPS)
+        : slots_per_shard_((max_groups + NUM_SHARDS - 1) / NUM_SHARDS)
+    {
+        if (max_groups == 0 || slots_per_shard_ * NUM_SHARDS > SLOT_MASK) {
+            throw std::invalid_argument("Reservation ledger max_groups out of range");
+        }
+
+        for (auto& shard : symbol_shards_) {
+            shard.symbols.resize(SYMBOLS_PER_SHARD);
+        }
+
+        slots_.resize(slots_per_shard_ * NUM_SHARDS);
+        for (size_t s = 0; s < NUM_SHARDS; ++s) {
+            auto& shard = group_shards_[s];
+            shard.free_slots.reserve(slots_per_shard_);
+            for (size_t i = slots_per_shard_; i-- > 0;) {
+                shard.free_slots.push_back(static_cast<uint32_t>(s * slots_per_shard_ + i));
+            }
+        }
+    }
+
+    ExposureReservationLedger(const ExposureReservationLedger&) = delete;
+    ExposureReservationLedger& operator=(const ExposureReservationLedger&) = delete;
+
+    // Pending exposure for symbol (caller must hold its shard via ShardGuard)
+    SymbolReservation pending_locked(SymbolId symbol) const {
+        return symbol < SymbolRegistry::MAX_SYMBOLS ? pending_slot(symbol) : SymbolReservation();
+    }
+
+    // Pending exposure for symbol (takes its shard lock; single-order checks)
+    SymbolReservation pending(SymbolId symbol) const {
+        if (symbol >= SymbolRegistry::MAX_SYMBOLS) return SymbolReservation();
+        std::lock_guard<std::mutex> lock(symbol_shards_[shard_index(symbol)].mutex);
+        return pending_slot(symbol);
+    }
+
+    // Atomically reserve gross exposure if it fits within headroom
+    bool try_reserve_gross(double amount, double headroom) {
+        double current = reserved_gross_.load(std::memory_order_relaxed);
+        while (current + amount <= headroom) {
+            if (reserved_gross_.compare_exchange_weak(current, current + amount,
+                                                      std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Give back gross reserved by try_reserve_gross (group not committed)
+    void release_gross(double amount) {
+        double current = reserved_gross_.load(std::memory_order_relaxed);
+        while (!reserved_gross_.compare_exchange_weak(current, std::max(0.0, current - amount),
+                                                      std::memory_order_acq_rel)) {
+        }
+    }
+
+    // Record a validated group (caller holds ShardGuard and already reserved
+    // gross). INVALID_RESERVATION when every group slot is in use - nothing
+    // is recorded and the caller must release the gross it reserved.
+    ReservationId commit_locked(std::span<const ReservationLeg> legs, std::span<const double> gross_impacts) {
+        uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+        size_t legs_count = std::min(legs.size(), MAX_LEGS);
+
+        // Spread groups over the shards; take a slot from the next one with room
+        for (size_t attempt = 0; attempt < NUM_SHARDS; ++attempt) {
+            auto& group_shard = group_shards_[(sequence + attempt) % NUM_SHARDS];
+            std::lock_guard<std::mutex> lock(group_shard.mutex);
+            if (group_shard.free_slots.empty()) continue;
+
+            uint32_t slot_index = group_shard.free_slots.back();
+            group_shard.free_slots.pop_back();
+
+            ReservationId id = (sequence << SLOT_BITS) | slot_index;
+            Group& group = slots_[slot_index];
+            group.id = id;
+            group.num_legs = legs_count;
+
+            for (size_t i = 0; i < legs_count; ++i) {
+                const auto& order = legs[i];
+                auto& pending = pending_slot(order.symbol);
+                if (order.side == Side::BUY) {
+                    pending.pending_buy_qty += order.quantity;
+                } else {
+                    pending.pending_sell_qty += order.quantity;
+                }
+
+                auto& leg = group.legs[i];
+                leg.symbol = order.symbol;
+                leg.side = order.side;
+                leg.remaining_qty = order.quantity;
+                leg.gross_per_unit = order.quantity > 0.0 ? gross_impacts[i] / order.quantity : 0.0;
+            }
+            return id;
+        }
+        return INVALID_RESERVATION;
+    }
+
+    // Release quantity from one leg (fill converted to position, cancel, partial reject)
+    void release_quantity(ReservationId id, size_t leg_index, double quantity) {
+        ReservedLeg released;
+
+        {
+            Group* group = find_group(id);
+            if (!group) return;
+
+            auto& group_shard = group_shards_[shard_of_slot(slot_of(id))];
+            std::lock_guard<std::mutex> lock(group_shard.mutex);
+            if (group->id != id || leg_index >= group->num_legs) {
+                return;
+            }
+
+            auto& leg = group->legs[leg_index];
+            double qty = std::min(quantity, leg.remaining_qty);
+            leg.remaining_qty -= qty;
+
+            released = leg;
+            released.remaining_qty = qty;
+
+            if (group->is_done()) {
+                free_slot_locked(group_shard, slot_of(id));
+            }
+        }
+
+        release_leg(released);
+    }
+
+    // Release everything still reserved by a group (reject/cancel of whole group)
+    void release_group(ReservationId id) {
+        Group group;
+
+        {
+            Group* slot = find_group(id);
+            if (!slot) return;
+
+            auto& group_shard = group_shards_[shard_of_slot(slot_of(id))];
+            std::lock_guard<std::mutex> lock(group_shard.mutex);
+            if (slot->id != id) {
+                return;
+            }
+            group = *slot;
+            free_slot_locked(group_shard, slot_of(id));
+        }
+
+        for (size_t i = 0; i < group.num_legs; ++i) {
+            release_leg(group.legs[i]);
+        }
+    }
+
+    double reserved_gross() const {
+        return reserved_gross_.load(std::memory_order_acquire);
+    }
+
+    size_t active_groups() const {
+        size_t total = 0;
+        for (auto& shard : group_shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += slots_per_shard_ - shard.free_slots.size();
+        }
+        return total;
+    }
+
+    size_t max_groups() const { return slots_.size(); }
+
+    // Drop all reservations (start of day)
+    void clear() {
+        for (auto& shard : symbol_shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            std::fill(shard.symbols.begin(), shard.symbols.end(), SymbolReservation());
+        }
+        for (size_t s = 0; s < NUM_SHARDS; ++s) {
+            auto& shard = group_shards_[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.free_slots.clear();
+            for (size_t i = slots_per_shard_; i-- > 0;) {
+                size_t slot_index = s * slots_per_shard_ + i;
+                slots_[slot_index].id = INVALID_RESERVATION;
+                shard.free_slots.push_back(static_cast<uint32_t>(slot_index));
+            }
+        }
+        reserved_gross_.store(0.0, std::memory_order_release);
+    }
+
+private:
+    // Reservation id = (sequence << SLOT_BITS) | slot: a released slot's old
+    // ids never match its next occupant
+    static constexpr unsigned SLOT_BITS = 24;
+    static constexpr uint64_t SLOT_MASK = (uint64_t(1) << SLOT_BITS) - 1;
+    static constexpr size_t SYMBOLS_PER_SHARD = SymbolRegistry::MAX_SYMBOLS / NUM_SHARDS;
+
+    struct Group {
+        ReservationId id = INVALID_RESERVATION;  // Occupant (INVALID = free)
+        std::array<ReservedLeg, MAX_LEGS> legs;
+        size_t num_legs = 0;
+
+        bool is_done() const {
+            for (size_t i = 0; i < num_legs; ++i) {
+                if (legs[i].remaining_qty > 0.0000001) return false;
+            }
+            return true;
+        }
+    };
+
+    struct alignas(64) SymbolShard {
+        mutable std::mutex mutex;
+        std::vector<SymbolReservation> symbols;     // Indexed by SymbolId / NUM_SHARDS
+    };
+
+    struct alignas(64) GroupShard {
+        mutable std::mutex mutex;
+        std::vector<uint32_t> free_slots;           // Capacity slots_per_shard_
+    };
+
+    std::array<SymbolShard, NUM_SHARDS> symbol_shards_;
+    std::array<GroupShard, NUM_SHARDS> group_shards_;
+    std::vector<Group> slots_;                      // Shard s owns [s * per_shard, (s + 1) * per_shard)
+    size_t slots_per_shard_;
+
+    std::atomic<uint64_t> next_sequence_{1};
+    std::atomic<double> reserved_gross_{0.0};
+
+    static size_t shard_index(SymbolId symbol) {
+        return symbol % NUM_SHARDS;
+    }
+
+    SymbolReservation& pending_slot(SymbolId symbol) {
+        return symbol_shards_[shard_index(symbol)].symbols[symbol / NUM_SHARDS];
+    }
+
+    const SymbolReservation& pending_slot(SymbolId symbol) const {
+        return symbol_shards_[shard_index(symbol)].symbols[symbol / NUM_SHARDS];
+    }
+
+    static size_t slot_of(ReservationId id) {
+        return static_cast<size_t>(id & SLOT_MASK);
+    }
+
+    size_t shard_of_slot(size_t slot_index) const {
+        return slot_index / slots_per_shard_;
+    }
+
+    // Slot an id points at (occupant must still be checked under its shard lock)
+    Group* find_group(ReservationId id) {
+        if (id == INVALID_RESERVATION) return nullptr;
+        size_t slot_index = slot_of(id);
+        return slot_index < slots_.size() ? &slots_[slot_index] : nullptr;
+    }
+
+    void free_slot_locked(GroupShard& shard, size_t slot_index) {
+        slots_[slot_index].id = INVALID_RESERVATION;
+        shard.free_slots.push_back(static_cast<uint32_t>(slot_index));
+    }
+
+    void release_leg(const ReservedLeg& leg) {
+        if (leg.remaining_qty <= 0.0) return;
+
+        {
+            auto& shard = symbol_shards_[shard_index(leg.symbol)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            auto& pending = shard.symbols[leg.symbol / NUM_SHARDS];
+            if (leg.side == Side::BUY) {
+                pending.pending_buy_qty = std::max(0.0, pending.pending_buy_qty - leg.remaining_qty);
+            } else {
+                pending.pending_sell_qty = std::max(0.0, pending.pending_sell_qty - leg.remaining_qty);
+            }
+            if (pending.is_empty()) {
+                pending = SymbolReservation();
+            }
+        }
+
+        release_gross(leg.remaining_qty * leg.gross_per_unit);
+    }
+};
+
+} // namespace trading
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "types.hpp"
+#include "instrument_master.hpp"
+#include "symbol_map.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Volume tier: rates apply once 30-day venue volume >= min_volume_usd
+// (negative maker_bps = rebate)
+struct FeeTier {
+    double min_volume_usd;
+    double maker_bps;
+    double taker_bps;
+
+    FeeTier(double min_volume = 0.0, double maker = 10.0, double taker = 10.0)
+        : min_volume_usd(min_volume), maker_bps(maker), taker_bps(taker) {}
+};
+
+// Current maker/taker rates for one (instrument, venue)
+struct FeeRates {
+    double maker_bps;
+    double taker_bps;
+
+    FeeRates(double maker = 10.0, double taker = 10.0) : maker_bps(maker), taker_bps(taker) {}
+
+    double rate_bps(bool is_maker) const { return is_maker ? maker_bps : taker_bps; }
+};
+
+// Fee engine - tiered maker/taker schedules per venue, with per-instrument
+// overrides (promo or zero-fee pairs)
+//
+// Each schedule publishes its current tier index through an atomic, so a
+// lookup is an array index plus a relaxed load. Tiers move live: the fill
+// stream adds notional to a 30-day ring of daily buckets per venue, and a
+// venue's schedules are re-tiered whenever its 30-day volume changes.
+// Without a schedule, lookups fall back to the instrument master's static
+// per-venue fees.
+// Configure schedules before trading; on_fill() / roll() from one thread.
+class FeeEngine {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t VOLUME_DAYS = 30;
+
+    FeeEngine() {
+        venue_schedule_.fill(NO_SCHEDULE);
+        for (auto& volume : volume_30d_) {
+            volume.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    FeeEngine(const FeeEngine&) = delete;
+    FeeEngine& operator=(const FeeEngine&) = delete;
+
+    // ===== Configuration =====
+
+    // Tiers sorted by ascending min_volume_usd, first tier at 0
+    void set_venue_schedule(Venue venue, std::vector<FeeTier> tiers) {
+        venue_schedule_[static_cast<size_t>(venue)] = add_schedule(venue, std::move(tiers));
+    }
+
+    void set_instrument_schedule(SymbolId instrument, Venue venue, std::vector<FeeTier> tiers) {
+        overrides_[instrument].schedule[static_cast<size_t>(venue)] = add_schedule(venue, std::move(tiers));
+    }
+
+    // Published spot schedules (VIP0 matches the instrument master defaults)
+    void load_defaults() {
+        set_venue_schedule(Venue::BINANCE, {
+            {0.0, 10.0, 10.0}, {1e6, 9.0, 10.0}, {5e6, 8.0, 10.0},
+            {20e6, 4.2, 6.0}, {100e6, 4.2, 5.4}
+        });
+        set_venue_schedule(Venue::BYBIT, {
+            {0.0, 10.0, 10.0}, {1e6, 6.75, 8.0}, {5e6, 6.5, 7.75}, {25e6, 6.25, 7.5}
+        });
+        set_venue_schedule(Venue::COINBASE, {
+            {0.0, 40.0, 60.0}, {10e3, 25.0, 40.0}, {50e3, 15.0, 25.0}, {100e3, 10.0, 20.0},
+            {1e6, 8.0, 18.0}, {15e6, 6.0, 16.0}, {75e6, 3.0, 12.0}, {250e6, 0.0, 8.0},
+            {400e6, 0.0, 5.0}
+        });
+        set_venue_schedule(Venue::KRAKEN, {
+            {0.0, 16.0, 26.0}, {50e3, 14.0, 24.0}, {100e3, 12.0, 22.0}, {250e3, 10.0, 20.0},
+            {500e3, 8.0, 18.0}, {1e6, 6.0, 16.0}, {2.5e6, 4.0, 14.0}, {5e6, 2.0, 12.0},
+            {10e6, 0.0, 10.0}
+        });
+    }
+
+    // ===== Hot path (lock-free, O(1)) =====
+
+    FeeRates rates(SymbolId instrument, Venue venue) const {
+        size_t v = static_cast<size_t>(venue);
+
+        int32_t index = venue_schedule_[v];
+        if (const Overrides* overrides = overrides_.find(instrument)) {
+            if (overrides->schedule[v] != NO_SCHEDULE) index = overrides->schedule[v];
+        }
+
+        if (index != NO_SCHEDULE) {
+            const Schedule& schedule = schedules_[static_cast<size_t>(index)];
+            const FeeTier& tier = schedule.tiers[schedule.tier.load(std::memory_order_relaxed)];
+            return FeeRates(tier.maker_bps, tier.taker_bps);
+        }
+
+        const Instrument* reference = InstrumentMaster::instance().get(instrument);
+        const FeeSchedule fees = reference ? reference->fees_on(venue) : FeeSchedule();
+        return FeeRates(fees.maker_bps, fees.taker_bps);
+    }
+
+    // A tiered schedule (venue or instrument override) prices this pair
+    bool has_schedule(SymbolId instrument, Venue venue) const {
+        size_t v = static_cast<size_t>(venue);
+        const Overrides* overrides = overrides_.find(instrument);
+        return venue_schedule_[v] != NO_SCHEDULE || (overrides && overrides->schedule[v] != NO_SCHEDULE);
+    }
+
+    double maker_bps(SymbolId instrument, Venue venue) const { return rates(instrument, venue).maker_bps; }
+    double taker_bps(SymbolId instrument, Venue venue) const { return rates(instrument, venue).taker_bps; }
+
+    // ===== Fill stream =====
+
+    // Fill notional counts toward the venue's 30-day volume; fees paid in the
+    // instrument's quote asset feed realized_fee_bps()
+    void on_fill(const Fill& fill) {
+        double notional = fill.price * fill.quantity;
+
+        const Instrument* instrument = InstrumentMaster::instance().get(get_symbol_id(fill.symbol));
+        bool quote_fee = fill.fee_currency.empty() ||
+                         (instrument && fill.fee_currency == instrument->quote_asset);
+
+        TimePoint when = fill.exchange_time != TimePoint{} ? fill.exchange_time
+                       : fill.received_time != TimePoint{} ? fill.received_time
+                       : Clock::now();
+        record_volume(fill.venue, notional, when);
+        if (quote_fee) {
+            record_fee(fill.venue, notional, fill.fee, when);
+        }
+    }
+
+    void record_volume(Venue venue, double notional, TimePoint when = Clock::now()) {
+        size_t v = static_cast<size_t>(venue);
+        VenueVolume& volume = volumes_[v];
+
+        int64_t day = day_of(when);
+        advance(volume, day);
+        if (day <= volume.day - static_cast<int64_t>(VOLUME_DAYS)) {
+            return;     // Older than the window
+        }
+
+        volume.notional[bucket_of(day)] += notional;
+        publish(v);
+    }
+
+    // Fee paid on `notional` (quote asset) - realized_fee_bps() only
+    void record_fee(Venue venue, double notional, double fee, TimePoint when = Clock::now()) {
+        VenueVolume& volume = volumes_[static_cast<size_t>(venue)];
+
+        int64_t day = day_of(when);
+        if (day > volume.day || day <= volume.day - static_cast<int64_t>(VOLUME_DAYS)) {
+            return;     // Outside the window record_volume() maintains
+        }
+
+        volume.fee_notional[bucket_of(day)] += notional;
+        volume.fees[bucket_of(day)] += fee;
+    }
+
+    // Expire days with no fills (call periodically, e.g. once a minute)
+    void roll(TimePoint now = Clock::now()) {
+        int64_t day = day_of(now);
+        for (size_t v = 0; v < NUM_VENUES; ++v) {
+            if (day > volumes_[v].day) {
+                advance(volumes_[v], day);
+                publish(v);
+            }
+        }
+    }
+
+    // Seed from the venue's reported 30-day volume (engine restart); it is
+    // carried as today's volume so it ages out with the window
+    void set_volume_30d(Venue venue, double volume_usd, TimePoint now = Clock::now()) {
+        size_t v = static_cast<size_t>(venue);
+        VenueVolume& volume = volumes_[v];
+
+        volume = VenueVolume();
+        volume.day = day_of(now);
+        volume.notional[bucket_of(volume.day)] = volume_usd;
+        publish(v);
+    }
+
+    double volume_30d(Venue venue) const {
+        return volume_30d_[static_cast<size_t>(venue)].load(std::memory_order_relaxed);
+    }
+
+    // Fees paid / notional over the window (fill thread)
+    double realized_fee_bps(Venue venue) const {
+        const VenueVolume& volume = volumes_[static_cast<size_t>(venue)];
+        double notional = 0.0, fees = 0.0;
+        for (size_t d = 0; d < VOLUME_DAYS; ++d) {
+            notional += volume.fee_notional[d];
+            fees += volume.fees[d];
+        }
+        return notional > 0.0 ? fees / notional * 10000.0 : 0.0;
+    }
+
+    // Current tier index of the venue schedule (0 if none)
+    size_t tier(Venue venue) const {
+        int32_t index = venue_schedule_[static_cast<size_t>(venue)];
+        return index == NO_SCHEDULE ? 0 : schedules_[static_cast<size_t>(index)].tier.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int32_t NO_SCHEDULE = -1;
+
+    struct Schedule {
+        Venue venue;
+        std::vector<FeeTier> tiers;
+        std::atomic<uint32_t> tier{0};
+
+        Schedule(Venue v, std::vector<FeeTier> t) : venue(v), tiers(std::move(t)) {}
+    };
+
+    struct Overrides {
+        std::array<int32_t, NUM_VENUES> schedule;
+
+        Overrides() { schedule.fill(NO_SCHEDULE); }
+    };
+
+    // Daily buckets indexed by day % VOLUME_DAYS (fill thread only)
+    struct VenueVolume {
+        int64_t day = 0;                            // Latest day seen
+        std::array<double, VOLUME_DAYS> notional{};
+        std::array<double, VOLUME_DAYS> fee_notional{};     // Fills with quote-asset fees
+        std::array<double, VOLUME_DAYS> fees{};
+    };
+
+    std::deque<Schedule> schedules_;                // Stable addresses (atomics)
+    std::array<int32_t, NUM_VENUES> venue_schedule_;
+    SymbolMap<Overrides> overrides_;
+
+    std::array<VenueVolume, NUM_VENUES> volumes_{};
+    std::array<std::atomic<double>, NUM_VENUES> volume_30d_;
+
+    int32_t add_schedule(Venue venue, std::vector<FeeTier> tiers) {
+        if (tiers.empty() || tiers.front().min_volume_usd > 0.0 ||
+            !std::is_sorted(tiers.begin(), tiers.end(), [](const FeeTier& a, const FeeTier& b) {
+                return a.min_volume_usd < b.min_volume_usd;
+            })) {
+            throw std::invalid_argument("Fee tiers must start at 0 volume and ascend");
+        }
+
+        Schedule& schedule = schedules_.emplace_back(venue, std::move(tiers));
+        schedule.tier.store(tier_for(schedule.tiers, volume_30d(venue)), std::memory_order_relaxed);
+        return static_cast<int32_t>(schedules_.size() - 1);
+    }
+
+    static int64_t day_of(TimePoint when) {
+        return std::chrono::duration_cast<std::chrono::hours>(when.time_since_epoch()).count() / 24;
+    }
+
+    static size_t bucket_of(int64_t day) {
+        return static_cast<size_t>(day % static_cast<int64_t>(VOLUME_DAYS));
+    }
+
+    // Move the window forward, clearing the days it skips over
+    static void advance(VenueVolume& volume, int64_t day) {
+        if (day <= volume.day) return;
+
+        int64_t days = std::min<int64_t>(day - volume.day, static_cast<int64_t>(VOLUME_DAYS));
+        for (int64_t d = 1; d <= days; ++d) {
+            size_t bucket = bucket_of(volume.day + d);
+            volume.notional[bucket] = 0.0;
+            volume.fee_notional[bucket] = 0.0;
+            volume.fees[bucket] = 0.0;
+        }
+        volume.day = day;
+    }
+
+    // Re-sum the window (30 adds, no drift) and re-tier the venue's schedules
+    void publish(size_t v) {
+        double total = 0.0;
+        for (double notional : volumes_[v].notional) {
+            total += notional;
+        }
+        volume_30d_[v].store(total, std::memory_order_relaxed);
+
+        for (auto& schedule : schedules_) {
+            if (static_cast<size_t>(schedule.venue) == v) {
+                schedule.tier.store(tier_for(schedule.tiers, total), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static uint32_t tier_for(const std::vector<FeeTier>& tiers, double volume) {
+        auto it = std::upper_bound(tiers.begin(), tiers.end(), volume,
+                                   [](double v, const FeeTier& tier) { return v < tier.min_volume_usd; });
+        return static_cast<uint32_t>(it - tiers.begin() - 1);
+    }
+};
+
+} // namespace trading
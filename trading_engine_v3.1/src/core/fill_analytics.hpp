@@ -0,0 +1,199 @@
+#pragma once
+
+#include "types.hpp"
+#include "circular_buffer.hpp"
+#include "string_interning.hpp"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading {
+
+// Compact fill record - no strings, fits in one cache line
+struct FillRecord {
+    TimePoint received_time;
+    double price;
+    double quantity;
+    double fee;
+    double slippage;                    // Fill::calculate_slippage() at receipt
+    SymbolRegistry::SymbolId symbol_id;
+    uint8_t strategy_id;                // Index into FillAnalytics strategy table
+    Side side;
+    Venue venue;
+    bool is_maker;
+
+    FillRecord()
+        : price(0.0)
+        , quantity(0.0)
+        , fee(0.0)
+        , slippage(0.0)
+        , symbol_id(SymbolRegistry::INVALID_SYMBOL)
+        , strategy_id(0)
+        , side(Side::BUY)
+        , venue(Venue::UNKNOWN)
+        , is_maker(false)
+    {}
+
+    double notional() const { return price * quantity; }
+};
+
+// Streaming fill aggregates - updated in O(1) per fill
+struct FillAggregate {
+    uint64_t fill_count;
+    double volume;                      // Sum of quantity
+    double notional;                    // Sum of price * quantity
+    double buy_volume;
+    double sell_volume;
+    double maker_volume;
+    double total_fees;
+    double slippage_notional;           // Sum of slippage * notional
+
+    FillAggregate()
+        : fill_count(0)
+        , volume(0.0)
+        , notional(0.0)
+        , buy_volume(0.0)
+        , sell_volume(0.0)
+        , maker_volume(0.0)
+        , total_fees(0.0)
+        , slippage_notional(0.0)
+    {}
+
+    void add(const FillRecord& fill) {
+        double fill_notional = fill.notional();
+
+        fill_count++;
+        volume += fill.quantity;
+        notional += fill_notional;
+        (fill.side == Side::BUY ? buy_volume : sell_volume) += fill.quantity;
+        if (fill.is_maker) maker_volume += fill.quantity;
+        total_fees += fill.fee;
+        slippage_notional += fill.slippage * fill_notional;
+    }
+
+    double vwap() const {
+        return volume > 0.0 ? notional / volume : 0.0;
+    }
+
+    // Notional-weighted average slippage in bps
+    double avg_slippage_bps() const {
+        return notional > 0.0 ? (slippage_notional / notional) * 10000.0 : 0.0;
+    }
+
+    double fee_bps() const {
+        return notional > 0.0 ? (total_fees / notional) * 10000.0 : 0.0;
+    }
+
+    double maker_ratio() const {
+        return volume > 0.0 ? maker_volume / volume : 0.0;
+    }
+};
+
+// Fill history + per-symbol / per-strategy analytics
+// History lives in a preallocated ring (no shifting, no allocation per fill);
+// aggregates are maintained incrementally so queries never rescan.
+// Not thread-safe: owned by RiskManager, which serializes access.
+class FillAnalytics {
+public:
+    static constexpr size_t DEFAULT_HISTORY = 1000;
+    static constexpr uint8_t UNKNOWN_STRATEGY = 0;
+
+    explicit FillAnalytics(size_t history_size = DEFAULT_HISTORY)
+        : history_(history_size)
+    {
+        strategy_names_.emplace_back("UNKNOWN");
+        by_strategy_.emplace_back();
+    }
+
+    void record(const Fill& fill, SymbolRegistry::SymbolId symbol_id, uint8_t strategy_id) {
+        FillRecord record;
+        record.received_time = fill.received_time;
+        record.price = fill.price;
+        record.quantity = fill.quantity;
+        record.fee = fill.fee;
+        record.slippage = fill.calculate_slippage();
+        record.symbol_id = symbol_id;
+        record.strategy_id = strategy_id < by_strategy_.size() ? strategy_id : UNKNOWN_STRATEGY;
+        record.side = fill.side;
+        record.venue = fill.venue;
+        record.is_maker = fill.is_maker;
+
+        history_.push_back(record);  // Overwrites oldest when full
+
+        if (symbol_id >= by_symbol_.size()) {
+            by_symbol_.resize(static_cast<size_t>(symbol_id) + 1);
+        }
+        by_symbol_[symbol_id].add(record);
+        by_strategy_[record.strategy_id].add(record);
+        total_.add(record);
+    }
+
+    // Strategy name -> small id (strategies are few; linear scan is cheapest)
+    uint8_t strategy_id(std::string_view name) {
+        if (name.empty()) return UNKNOWN_STRATEGY;
+
+        for (size_t i = 1; i < strategy_names_.size(); ++i) {
+            if (strategy_names_[i] == name) return static_cast<uint8_t>(i);
+        }
+
+        if (strategy_names_.size() >= 255) return UNKNOWN_STRATEGY;
+
+        strategy_names_.emplace_back(name);
+        by_strategy_.emplace_back();
+        return static_cast<uint8_t>(strategy_names_.size() - 1);
+    }
+
+    // Lookup without registering
+    uint8_t find_strategy(std::string_view name) const {
+        for (size_t i = 1; i < strategy_names_.size(); ++i) {
+            if (strategy_names_[i] == name) return static_cast<uint8_t>(i);
+        }
+        return UNKNOWN_STRATEGY;
+    }
+
+    const std::string& strategy_name(uint8_t id) const {
+        return strategy_names_[id < strategy_names_.size() ? id : UNKNOWN_STRATEGY];
+    }
+
+    FillAggregate symbol_stats(SymbolRegistry::SymbolId symbol_id) const {
+        return symbol_id < by_symbol_.size() ? by_symbol_[symbol_id] : FillAggregate();
+    }
+
+    FillAggregate strategy_stats(uint8_t strategy_id) const {
+        return strategy_id < by_strategy_.size() ? by_strategy_[strategy_id] : FillAggregate();
+    }
+
+    const FillAggregate& total_stats() const { return total_; }
+
+    // Most recent fills, oldest first
+    std::vector<FillRecord> recent(size_t max_count) const {
+        size_t count = std::min(max_count, history_.size());
+        std::vector<FillRecord> result;
+        result.reserve(count);
+        for (size_t i = history_.size() - count; i < history_.size(); ++i) {
+            result.push_back(history_[i]);
+        }
+        return result;
+    }
+
+    const CircularBuffer<FillRecord>& history() const { return history_; }
+    size_t history_size() const { return history_.size(); }
+
+    // Start of day: drop history and aggregates, keep strategy table
+    void clear() {
+        history_.clear();
+        by_symbol_.assign(by_symbol_.size(), FillAggregate());
+        by_strategy_.assign(by_strategy_.size(), FillAggregate());
+        total_ = FillAggregate();
+    }
+
+private:
+    CircularBuffer<FillRecord> history_;
+    std::vector<FillAggregate> by_symbol_;      // Indexed by SymbolId
+    std::vector<FillAggregate> by_strategy_;    // Indexed by strategy id
+    std::vector<std::string> strategy_names_;
+    FillAggregate total_;
+};
+
+} // namespace trading
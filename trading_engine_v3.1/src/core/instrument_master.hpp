@@ -0,0 +1,242 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <array>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace trading {
+
+// Venue trading fees for one instrument
+struct FeeSchedule {
+    double maker_bps;
+    double taker_bps;
+
+    FeeSchedule(double maker = 10.0, double taker = 10.0) : maker_bps(maker), taker_bps(taker) {}
+};
+
+// Normalized instrument - static reference data + per-strategy parameters
+struct Instrument {
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t NUM_STRATEGIES = static_cast<size_t>(StrategyKind::COUNT);
+
+    SymbolRegistry::SymbolId id;        // Canonical ID (== engine SymbolId)
+    std::string symbol;                 // Canonical engine name, e.g. "BTCUSDT"
+    std::string base_asset;             // "BTC"
+    std::string quote_asset;            // "USDT"
+    double tick_size;
+    double lot_size;
+    double min_notional;
+    std::array<FeeSchedule, NUM_VENUES> fees;
+
+    // Per-strategy parameters
+    std::array<double, NUM_STRATEGIES> base_notional;   // Default trade size in quote
+    double obi_threshold_offset;        // Added to OBI imbalance threshold
+    double obi_target_offset_bps;       // Added to OBI profit target
+
+    Instrument()
+        : id(SymbolRegistry::INVALID_SYMBOL)
+        , tick_size(0.01)
+        , lot_size(0.00001)
+        , min_notional(5.0)
+        , base_notional{3000.0, 5000.0, 5000.0, 4000.0, 2000.0}
+        , obi_threshold_offset(0.0)
+        , obi_target_offset_bps(0.0)
+    {}
+
+    double notional_for(StrategyKind kind) const {
+        return base_notional[static_cast<size_t>(kind)];
+    }
+
+    const FeeSchedule& fees_on(Venue venue) const {
+        return fees[static_cast<size_t>(venue)];
+    }
+
+    double round_price(double price) const {
+        return tick_size > 0.0 ? std::round(price / tick_size) * tick_size : price;
+    }
+
+    // Round down so we never exceed the intended size
+    double round_quantity(double quantity) const {
+        return lot_size > 0.0 ? std::floor(quantity / lot_size + 1e-9) * lot_size : quantity;
+    }
+};
+
+// Instrument master - (Venue, venue symbol) -> canonical instrument
+//
+// Each venue spells instruments its own way ("BTCUSDT", "BTC-USD", "XBTUSD");
+// adapters resolve once at the edge and everything inside the engine works
+// with the canonical SymbolId. Instruments are indexed by that ID, so
+// reference data and strategy parameters are an array lookup.
+// Loaded at startup; read-only (and therefore lock-free) while trading.
+class InstrumentMaster {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    // Process-wide master preloaded with the common instruments
+    static InstrumentMaster& instance() {
+        static InstrumentMaster master = [] {
+            InstrumentMaster m;
+            m.load_defaults();
+            return m;
+        }();
+        return master;
+    }
+
+    InstrumentMaster() = default;
+
+    // Add or replace an instrument; its canonical symbol maps on every venue
+    SymbolId add(Instrument instrument) {
+        SymbolId id = register_symbol(instrument.symbol);
+        instrument.id = id;
+
+        if (id >= instruments_.size()) {
+            instruments_.resize(static_cast<size_t>(id) + 1);
+            present_.resize(static_cast<size_t>(id) + 1, 0);
+        }
+        instruments_[id] = std::move(instrument);
+        present_[id] = 1;
+
+        for (size_t v = 0; v < Instrument::NUM_VENUES; ++v) {
+            map_venue_symbol(static_cast<Venue>(v), instruments_[id].symbol, id);
+        }
+        return id;
+    }
+
+    // Venue-specific spelling for an instrument
+    void map_venue_symbol(Venue venue, std::string_view venue_symbol, SymbolId id) {
+        auto& venue_map = venue_to_id_[static_cast<size_t>(venue)];
+        venue_map[std::string(venue_symbol)] = id;
+
+        auto& names = id_to_venue_[static_cast<size_t>(venue)];
+        if (id >= names.size()) {
+            names.resize(static_cast<size_t>(id) + 1);
+        }
+        if (names[id].empty() || venue_symbol != instruments_[id].symbol) {
+            names[id] = std::string(venue_symbol);  // Prefer the venue's own spelling
+        }
+    }
+
+    // Venue symbol -> canonical ID (INVALID_SYMBOL if unknown)
+    SymbolId resolve(Venue venue, std::string_view venue_symbol) const {
+        const auto& venue_map = venue_to_id_[static_cast<size_t>(venue)];
+        auto it = venue_map.find(venue_symbol);
+        return it != venue_map.end() ? it->second : SymbolRegistry::INVALID_SYMBOL;
+    }
+
+    // Canonical name first, then any venue's spelling
+    SymbolId resolve_any(std::string_view symbol) const {
+        SymbolId id = get_symbol_id(symbol);
+        if (contains(id)) return id;
+
+        for (size_t v = 0; v < Instrument::NUM_VENUES; ++v) {
+            id = resolve(static_cast<Venue>(v), symbol);
+            if (id != SymbolRegistry::INVALID_SYMBOL) return id;
+        }
+        return SymbolRegistry::INVALID_SYMBOL;
+    }
+
+    // Canonical ID -> venue spelling (canonical name if not mapped)
+    std::string_view venue_symbol(Venue venue, SymbolId id) const {
+        const auto& names = id_to_venue_[static_cast<size_t>(venue)];
+        if (id < names.size() && !names[id].empty()) return names[id];
+        return get_symbol_name(id);
+    }
+
+    bool contains(SymbolId id) const {
+        return id < present_.size() && present_[id];
+    }
+
+    // O(1) by ID; nullptr if unknown
+    const Instrument* get(SymbolId id) const {
+        return contains(id) ? &instruments_[id] : nullptr;
+    }
+
+    Instrument* get_mutable(SymbolId id) {
+        return contains(id) ? &instruments_[id] : nullptr;
+    }
+
+    size_t size() const {
+        size_t count = 0;
+        for (uint8_t p : present_) count += p;
+        return count;
+    }
+
+    // Common spot instruments with per-venue spellings and VIP0 fees
+    void load_defaults() {
+        struct Spec {
+            const char* symbol;
+            const char* base;
+            double tick;
+            double lot;
+            double obi_threshold_offset;
+            double obi_target_offset_bps;
+            const char* coinbase;
+            const char* kraken;
+        };
+
+        static constexpr Spec specs[] = {
+            {"BTCUSDT", "BTC", 0.01, 0.00001, 0.02, -0.5, "BTC-USD", "XBTUSD"},
+            {"ETHUSDT", "ETH", 0.01, 0.0001, 0.02, -0.5, "ETH-USD", "ETHUSD"},
+            {"SOLUSDT", "SOL", 0.01, 0.001, -0.03, 1.0, "SOL-USD", "SOLUSD"},
+            {"BNBUSDT", "BNB", 0.01, 0.001, 0.0, 0.0, "BNB-USD", "BNBUSD"},
+            {"XRPUSDT", "XRP", 0.0001, 0.1, 0.0, 0.0, "XRP-USD", "XRPUSD"},
+            {"LINKUSDT", "LINK", 0.001, 0.01, 0.0, 0.0, "LINK-USD", "LINKUSD"},
+        };
+
+        for (const auto& spec : specs) {
+            Instrument instrument;
+            instrument.symbol = spec.symbol;
+            instrument.base_asset = spec.base;
+            instrument.quote_asset = "USDT";
+            instrument.tick_size = spec.tick;
+            instrument.lot_size = spec.lot;
+            instrument.obi_threshold_offset = spec.obi_threshold_offset;
+            instrument.obi_target_offset_bps = spec.obi_target_offset_bps;
+            instrument.fees[static_cast<size_t>(Venue::BINANCE)] = FeeSchedule(10.0, 10.0);
+            instrument.fees[static_cast<size_t>(Venue::BYBIT)] = FeeSchedule(10.0, 10.0);
+            instrument.fees[static_cast<size_t>(Venue::COINBASE)] = FeeSchedule(40.0, 60.0);
+            instrument.fees[static_cast<size_t>(Venue::KRAKEN)] = FeeSchedule(16.0, 26.0);
+
+            SymbolId id = add(std::move(instrument));
+            map_venue_symbol(Venue::COINBASE, spec.coinbase, id);
+            map_venue_symbol(Venue::KRAKEN, spec.kraken, id);
+        }
+
+        // Cross pairs (quote = BTC)
+        static constexpr std::pair<const char*, const char*> crosses[] = {
+            {"ETHBTC", "ETH"}, {"SOLBTC", "SOL"}, {"BNBBTC", "BNB"}
+        };
+        for (const auto& [symbol, base] : crosses) {
+            Instrument instrument;
+            instrument.symbol = symbol;
+            instrument.base_asset = base;
+            instrument.quote_asset = "BTC";
+            instrument.tick_size = 0.000001;
+            instrument.lot_size = 0.0001;
+            instrument.min_notional = 0.0001;
+            add(std::move(instrument));
+        }
+    }
+
+private:
+    // Heterogeneous lookup: find by string_view without building a string
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    using VenueSymbolMap = std::unordered_map<std::string, SymbolId, StringHash, std::equal_to<>>;
+
+    std::vector<Instrument> instruments_;                               // Indexed by SymbolId
+    std::vector<uint8_t> present_;
+    std::array<VenueSymbolMap, Instrument::NUM_VENUES> venue_to_id_;
+    std::array<std::vector<std::string>, Instrument::NUM_VENUES> id_to_venue_;
+};
+
+} // namespace trading
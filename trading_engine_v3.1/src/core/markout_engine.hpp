@@ -0,0 +1,231 @@
+#pragma once
+
+#include "types.hpp"
+#include "symbol_map.hpp"
+#include "timer_wheel.hpp"
+#include "toxicity_board.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Markout statistics for one key (symbol, venue or flow) at one horizon
+// Markout is signed against us: positive bps = the price moved the way the
+// counterparty traded (we bought and it fell, or sold and it rose).
+struct MarkoutStats {
+    uint64_t count = 0;
+    uint64_t adverse_count = 0;
+    double ewma_markout_bps = 0.0;
+    double ewma_adverse = 0.0;          // EWMA of (markout > significant move)
+    double adverse_bps_sum = 0.0;
+    double adverse_cost = 0.0;          // Sum of adverse markout * notional (quote)
+
+    void add(double markout_bps, double notional, double alpha, double significant_bps) {
+        bool adverse = markout_bps > significant_bps;
+        if (count++ == 0) {
+            ewma_markout_bps = markout_bps;
+            ewma_adverse = adverse ? 1.0 : 0.0;
+        } else {
+            ewma_markout_bps += alpha * (markout_bps - ewma_markout_bps);
+            ewma_adverse += alpha * ((adverse ? 1.0 : 0.0) - ewma_adverse);
+        }
+        if (adverse) {
+            ++adverse_count;
+            adverse_bps_sum += markout_bps;
+            adverse_cost += markout_bps * notional / 10000.0;
+        }
+    }
+
+    // 0-1: adverse frequency blended with average markout size
+    double toxicity(double scale_bps) const {
+        double magnitude = std::clamp(ewma_markout_bps / scale_bps, 0.0, 1.0);
+        return 0.6 * ewma_adverse + 0.4 * magnitude;
+    }
+};
+
+// Markout engine - multi-horizon fill markouts on a timer wheel
+//
+// Every fill schedules one timer per horizon (100ms / 500ms / 1s / 5s by
+// default). on_price() first expires the timers that came due before this
+// update, valuing them against the mid that was live at their deadline,
+// then records the new mid. A markout is O(1): a mid lookup plus updates
+// to the symbol, (symbol, venue), venue and flow statistics for that
+// horizon. Flows are caller-defined (strategy, client or counterparty
+// class). With a ToxicityBoard attached, each markout at the board horizon
+// republishes just its symbol's scores.
+// Not thread-safe: owned by the market data thread.
+class MarkoutEngine {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+    using FlowId = uint8_t;
+
+    static constexpr size_t NUM_HORIZONS = 4;
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t MAX_FLOWS = 16;
+
+    using HorizonStats = std::array<MarkoutStats, NUM_HORIZONS>;
+    using VenueStats = std::array<HorizonStats, NUM_VENUES>;
+
+    struct Config {
+        std::array<std::chrono::milliseconds, NUM_HORIZONS> horizons;
+        std::chrono::milliseconds tick;         // Wheel resolution
+        double ewma_alpha;
+        double significant_move_bps;            // Adverse above this markout
+        double toxicity_scale_bps;              // Markout that scores 1.0
+
+        Config()
+            : horizons{std::chrono::milliseconds(100), std::chrono::milliseconds(500),
+                       std::chrono::milliseconds(1000), std::chrono::milliseconds(5000)}
+            , tick(1)
+            , ewma_alpha(0.05)
+            , significant_move_bps(5.0)
+            , toxicity_scale_bps(20.0)
+        {}
+    };
+
+    explicit MarkoutEngine(const Config& config = Config(), TimePoint start = Clock::now())
+        : config_(config)
+        , wheel_(config.tick, start)
+    {
+        if (config_.ewma_alpha <= 0.0 || config_.ewma_alpha > 1.0 || config_.toxicity_scale_bps <= 0.0) {
+            throw std::invalid_argument("MarkoutEngine needs 0 < ewma_alpha <= 1 and toxicity_scale_bps > 0");
+        }
+    }
+
+    // Schedule markouts for a fill (flow < MAX_FLOWS)
+    void on_fill(SymbolId symbol, Venue venue, FlowId flow, Side side,
+                 double price, double quantity, TimePoint fill_time = Clock::now()) {
+        if (price <= 0.0 || quantity <= 0.0 || flow >= MAX_FLOWS) return;
+
+        uint32_t slot;
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(pending_.size());
+            pending_.emplace_back();
+        }
+        pending_[slot] = PendingFill{symbol, venue, flow, side, price, quantity,
+                                     static_cast<uint8_t>(NUM_HORIZONS)};
+
+        for (size_t h = 0; h < NUM_HORIZONS; ++h) {
+            wheel_.schedule(fill_time + config_.horizons[h], Timer{slot, static_cast<uint8_t>(h)});
+        }
+    }
+
+    // Mid update: expire markouts due before it, then record the new mid
+    void on_price(SymbolId symbol, double mid, TimePoint now = Clock::now()) {
+        advance(now);
+        if (mid > 0.0) {
+            mids_[symbol] = mid;
+        }
+    }
+
+    // Expire due markouts against the current mids (e.g. from a timer)
+    void advance(TimePoint now = Clock::now()) {
+        wheel_.advance(now, [this](const Timer& timer) { evaluate(timer); });
+    }
+
+    // Publish (symbol, venue) and symbol toxicity at `horizon` to a board
+    void attach_board(ToxicityBoard* board, size_t horizon) {
+        if (horizon >= NUM_HORIZONS) {
+            throw std::invalid_argument("MarkoutEngine board horizon out of range");
+        }
+        board_ = board;
+        board_horizon_ = horizon;
+    }
+
+    // ===== Toxicity (nullptr / empty stats until a markout lands) =====
+
+    const HorizonStats* symbol_stats(SymbolId symbol) const { return symbols_.find(symbol); }
+
+    const HorizonStats* symbol_venue_stats(SymbolId symbol, Venue venue) const {
+        const VenueStats* stats = symbol_venues_.find(symbol);
+        return stats ? &(*stats)[static_cast<size_t>(venue)] : nullptr;
+    }
+    const HorizonStats& venue_stats(Venue venue) const { return venues_[static_cast<size_t>(venue)]; }
+    const HorizonStats& flow_stats(FlowId flow) const { return flows_[flow]; }
+
+    double symbol_toxicity(SymbolId symbol, size_t horizon) const {
+        const HorizonStats* stats = symbols_.find(symbol);
+        return stats ? (*stats)[horizon].toxicity(config_.toxicity_scale_bps) : 0.0;
+    }
+
+    double venue_toxicity(Venue venue, size_t horizon) const {
+        return venues_[static_cast<size_t>(venue)][horizon].toxicity(config_.toxicity_scale_bps);
+    }
+
+    double flow_toxicity(FlowId flow, size_t horizon) const {
+        return flows_[flow][horizon].toxicity(config_.toxicity_scale_bps);
+    }
+
+    size_t pending_markouts() const { return wheel_.size(); }
+    const Config& config() const { return config_; }
+
+private:
+    struct PendingFill {
+        SymbolId symbol;
+        Venue venue;
+        FlowId flow;
+        Side side;
+        double price;
+        double quantity;
+        uint8_t remaining;              // Horizons still scheduled
+    };
+
+    struct Timer {
+        uint32_t slot;
+        uint8_t horizon;
+    };
+
+    Config config_;
+    TimerWheel<Timer> wheel_;
+
+    std::vector<PendingFill> pending_;  // Slab; slots recycled via free_
+    std::vector<uint32_t> free_;
+    SymbolMap<double> mids_;
+
+    SymbolMap<HorizonStats> symbols_;
+    SymbolMap<VenueStats> symbol_venues_;
+    std::array<HorizonStats, NUM_VENUES> venues_{};
+    std::array<HorizonStats, MAX_FLOWS> flows_{};
+
+    ToxicityBoard* board_ = nullptr;
+    size_t board_horizon_ = 0;
+
+    void evaluate(const Timer& timer) {
+        PendingFill& fill = pending_[timer.slot];
+
+        const double* mid = mids_.find(fill.symbol);
+        if (mid) {
+            double move_bps = (*mid - fill.price) / fill.price * 10000.0;
+            double markout_bps = fill.side == Side::BUY ? -move_bps : move_bps;
+            double notional = fill.price * fill.quantity;
+
+            HorizonStats& symbol = symbols_[fill.symbol];
+            HorizonStats& symbol_venue = symbol_venues_[fill.symbol][static_cast<size_t>(fill.venue)];
+            for (HorizonStats* stats : {&symbol, &symbol_venue,
+                                        &venues_[static_cast<size_t>(fill.venue)],
+                                        &flows_[fill.flow]}) {
+                (*stats)[timer.horizon].add(markout_bps, notional, config_.ewma_alpha,
+                                            config_.significant_move_bps);
+            }
+
+            if (board_ && timer.horizon == board_horizon_) {
+                board_->publish(fill.symbol, fill.venue,
+                                symbol_venue[board_horizon_].toxicity(config_.toxicity_scale_bps),
+                                symbol[board_horizon_].toxicity(config_.toxicity_scale_bps));
+            }
+        }
+
+        if (--fill.remaining == 0) {
+            free_.push_back(timer.slot);
+        }
+    }
+};
+
+} // namespace trading
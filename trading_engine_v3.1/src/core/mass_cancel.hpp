@@ -0,0 +1,311 @@
+#pragma once
+
+#include "types.hpp"
+#include "order_gateway.hpp"
+#include "order_tracker.hpp"
+#include "circuit_breaker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace trading {
+
+// Mass cancel - pulls every working order when the kill switch fires
+//
+// Active orders are grouped by venue from OrderTracker and their cancels go
+// out in gateway-sized batches, round-robin across venues, on the thread
+// that fired the kill switch (no thread is created on the kill path).
+// Confirmation runs on a dedicated thread started with the canceller and
+// signalled per mass cancel, so the handler returns as soon as the cancels
+// are out: it waits for the tracker to report no active orders, re-sends
+// cancels for stragglers and escalates if the book never goes flat.
+// Activation -> all cancels sent and activation -> flat are both measured.
+class MassCanceller {
+public:
+    struct Config {
+        std::chrono::milliseconds flat_timeout;     // Give up confirming flat after this
+        std::chrono::milliseconds poll_interval;    // Active-order re-check period
+        int max_rounds;                             // Re-send cancels for stragglers
+
+        Config()
+            : flat_timeout(std::chrono::milliseconds(5000))
+            , poll_interval(std::chrono::milliseconds(10))
+            , max_rounds(3)
+        {}
+    };
+
+    struct Report {
+        size_t orders_targeted;
+        size_t cancels_sent;
+        size_t venues;
+        std::chrono::microseconds time_to_sent;     // Activation -> last cancel sent
+        std::chrono::microseconds time_to_flat;     // Activation -> no active orders
+        bool flat;
+        size_t remaining_active;
+
+        Report()
+            : orders_targeted(0)
+            , cancels_sent(0)
+            , venues(0)
+            , time_to_sent(0)
+            , time_to_flat(0)
+            , flat(false)
+            , remaining_active(0)
+        {}
+    };
+
+    // Called when orders are still active after every round (page an
+    // operator, drop venue sessions to trigger cancel-on-disconnect, ...)
+    using EscalationHandler = std::function<void(const Report&)>;
+
+    MassCanceller(OrderTracker& order_tracker, OrderGateway& gateway, const Config& config = Config())
+        : order_tracker_(order_tracker)
+        , gateway_(gateway)
+        , config_(config)
+    {
+        confirm_thread_ = std::thread([this] { confirm_loop(); });
+    }
+
+    // Unhooks from the kill switch first: once this returns no activation
+    // can still be calling into the canceller
+    ~MassCanceller() {
+        if (kill_switch_) {
+            kill_switch_->unregister_shutdown_handler(kill_switch_handler_);
+        }
+        {
+            std::lock_guard<std::mutex> lock(confirm_mutex_);
+            stop_.store(true, std::memory_order_release);
+        }
+        confirm_cv_.notify_all();
+        confirm_thread_.join();
+    }
+
+    MassCanceller(const MassCanceller&) = delete;
+    MassCanceller& operator=(const MassCanceller&) = delete;
+
+    void set_escalation_handler(EscalationHandler handler) {
+        escalation_handler_ = std::move(handler);
+    }
+
+    // Hook into the kill switch (one at a time): activation sends every
+    // cancel, then hands confirmation to the confirm thread and returns.
+    // The handler is removed again by the destructor.
+    void arm(KillSwitch& kill_switch) {
+        if (kill_switch_) {
+            kill_switch_->unregister_shutdown_handler(kill_switch_handler_);
+        }
+        kill_switch_ = &kill_switch;
+        kill_switch_handler_ = kill_switch.register_shutdown_handler([this, &kill_switch] {
+            start(kill_switch.get_activation_time());
+        });
+    }
+
+    // Send cancels for every active order on this thread and signal the
+    // confirm thread; false if a mass cancel is already running.
+    // Times are from `since`.
+    bool start(TimePoint since = Clock::now()) {
+        bool expected = false;
+        if (!in_progress_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            LOG_WARN("Mass cancel already in progress");
+            return false;
+        }
+
+        Report report;
+        auto by_venue = order_tracker_.get_active_orders_by_venue();
+        report.orders_targeted = send_cancels(by_venue, report);
+        report.time_to_sent = elapsed_us(since);
+
+        LOG_WARN("Mass cancel: " << report.cancels_sent << "/" << report.orders_targeted
+                 << " cancels sent to " << report.venues << " venues in "
+                 << report.time_to_sent.count() << "us");
+
+        {
+            std::lock_guard<std::mutex> lock(confirm_mutex_);
+            pending_since_ = since;
+            pending_report_ = report;
+            pending_ = true;
+        }
+        confirm_cv_.notify_all();
+        return true;
+    }
+
+    // Block until the running mass cancel (if any) is confirmed or gives up
+    std::optional<Report> wait() {
+        std::unique_lock<std::mutex> lock(confirm_mutex_);
+        confirm_cv_.wait(lock, [this] { return !in_progress_.load(std::memory_order_acquire); });
+        lock.unlock();
+        return last_report();
+    }
+
+    // Blocking form: start() and wait(); an empty Report if already running
+    Report cancel_all(TimePoint since = Clock::now()) {
+        if (!start(since)) {
+            return Report();
+        }
+        return wait().value_or(Report());
+    }
+
+    bool in_progress() const {
+        return in_progress_.load(std::memory_order_acquire);
+    }
+
+    std::optional<Report> last_report() const {
+        std::lock_guard<std::mutex> lock(report_mutex_);
+        return last_report_;
+    }
+
+private:
+    OrderTracker& order_tracker_;
+    OrderGateway& gateway_;
+    Config config_;
+    EscalationHandler escalation_handler_;
+
+    KillSwitch* kill_switch_ = nullptr;
+    KillSwitch::HandlerId kill_switch_handler_ = 0;
+
+    std::atomic<bool> in_progress_{false};
+    std::atomic<bool> stop_{false};
+
+    // Hand-off to the confirm thread (also signals wait() on completion)
+    std::mutex confirm_mutex_;
+    std::condition_variable confirm_cv_;
+    bool pending_ = false;
+    TimePoint pending_since_;
+    Report pending_report_;
+    std::thread confirm_thread_;
+
+    mutable std::mutex report_mutex_;
+    std::optional<Report> last_report_;
+
+    void confirm_loop() {
+        while (true) {
+            TimePoint since;
+            Report report;
+            {
+                std::unique_lock<std::mutex> lock(confirm_mutex_);
+                confirm_cv_.wait(lock, [this] {
+                    return pending_ || stop_.load(std::memory_order_acquire);
+                });
+                if (!pending_) return;  // Stopping with nothing to confirm
+                pending_ = false;
+                since = pending_since_;
+                report = pending_report_;
+            }
+            confirm(since, report);
+        }
+    }
+
+    // Confirm thread: wait for flat, re-send to stragglers, escalate
+    void confirm(TimePoint since, Report report) {
+        auto deadline = since + config_.flat_timeout;
+        int rounds = std::max(1, config_.max_rounds);
+
+        for (int round = 0; round < rounds; ++round) {
+            if (round > 0) {
+                send_cancels(order_tracker_.get_active_orders_by_venue(), report);
+            }
+            if (wait_for_flat(deadline, round + 1 < rounds)) {
+                report.flat = true;
+                report.time_to_flat = elapsed_us(since);
+                break;
+            }
+            if (stop_.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        report.remaining_active = order_tracker_.active_count();
+        if (report.flat) {
+            LOG_WARN("Mass cancel: flat after " << report.time_to_flat.count() << "us");
+        } else {
+            LOG_ERROR("Mass cancel: " << report.remaining_active
+                      << " orders still active after " << config_.flat_timeout.count() << "ms");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(report_mutex_);
+            last_report_ = report;
+        }
+        if (!report.flat && escalation_handler_ && !stop_.load(std::memory_order_acquire)) {
+            try {
+                escalation_handler_(report);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Mass cancel escalation failed: " << e.what());
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(confirm_mutex_);
+            in_progress_.store(false, std::memory_order_release);
+        }
+        confirm_cv_.notify_all();
+    }
+
+    // Batches go out round-robin across venues so no venue waits for
+    // another's whole book; returns number of orders targeted
+    size_t send_cancels(const std::array<std::vector<Order>, OrderTracker::NUM_VENUES>& by_venue,
+                        Report& report) {
+        std::array<size_t, OrderTracker::NUM_VENUES> next{};
+        size_t targeted = 0;
+        size_t venues = 0;
+
+        for (const auto& orders : by_venue) {
+            targeted += orders.size();
+            venues += orders.empty() ? 0 : 1;
+        }
+
+        bool remaining = targeted > 0;
+        while (remaining) {
+            remaining = false;
+            for (size_t v = 0; v < by_venue.size(); ++v) {
+                const auto& orders = by_venue[v];
+                if (next[v] >= orders.size()) continue;
+
+                Venue venue = static_cast<Venue>(v);
+                size_t batch = std::max<size_t>(1, gateway_.max_cancel_batch(venue));
+                size_t count = std::min(batch, orders.size() - next[v]);
+                try {
+                    report.cancels_sent += gateway_.cancel_orders(
+                        venue, std::span<const Order>(orders.data() + next[v], count));
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Mass cancel failed on " << to_string(venue) << ": " << e.what());
+                }
+                next[v] += count;
+                remaining = remaining || next[v] < orders.size();
+            }
+        }
+
+        report.venues = std::max(report.venues, venues);
+        return targeted;
+    }
+
+    // Poll until no active orders; a non-final round stops early at its
+    // share of the remaining time so stragglers get re-cancelled
+    bool wait_for_flat(TimePoint deadline, bool allow_retry) {
+        auto round_deadline = deadline;
+        if (allow_retry) {
+            round_deadline = Clock::now() + (deadline - Clock::now()) / 2;
+        }
+
+        while (true) {
+            if (order_tracker_.active_count() == 0) {
+                return true;
+            }
+            if (Clock::now() >= round_deadline || stop_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            std::this_thread::sleep_for(config_.poll_interval);
+        }
+    }
+
+    static std::chrono::microseconds elapsed_us(TimePoint since) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since);
+    }
+};
+
+} // namespace trading
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "types.hpp"
+#include "order_intent.hpp"
+#include "circuit_breaker.hpp"
+#include "rate_limiter.hpp"
+#include <span>
+
+namespace trading {
+
+// Order gate - single pre-send check for the order path
+// Kill switch + (venue, order type) breakers in one or two relaxed loads
+// when nothing is tripped; breaker state machines only run on the slow path.
+// With rate limits attached, orders that would exceed the venue's weighted
+// limits are held back here (RATE_LIMITED + retry_after) instead of being
+// sent and rejected - or worse, earning an IP/account ban.
+class OrderGate {
+public:
+    enum class Decision : uint8_t {
+        ALLOW,
+        KILL_SWITCH,        // Global stop
+        BREAKER_OPEN,       // Venue or venue/order-type breaker tripped
+        RATE_LIMITED        // Would exceed venue/account rate limits; retry later
+    };
+
+    OrderGate(KillSwitch& kill_switch, CircuitBreakerRegistry& breakers)
+        : kill_switch_(kill_switch)
+        , breakers_(breakers)
+    {}
+
+    // Optional per-venue/account exchange rate limits
+    void attach_rate_limits(RateLimiterRegistry* rate_limits) {
+        rate_limits_ = rate_limits;
+    }
+
+    // Charges rate limits only when the order is otherwise allowed
+    Decision check(Venue venue, OrderType type, uint8_t account = 0, uint32_t weight = 1) {
+        if (kill_switch_.is_activated()) [[unlikely]] {
+            return Decision::KILL_SWITCH;
+        }
+        if (!breakers_.allow(venue, type)) {
+            return Decision::BREAKER_OPEN;
+        }
+        if (rate_limits_ && !rate_limits_->try_acquire(venue, account, weight, 1)) {
+            return Decision::RATE_LIMITED;
+        }
+        return Decision::ALLOW;
+    }
+
+    bool allow(const Order& order) {
+        return check(order.venue, order.type) == Decision::ALLOW;
+    }
+    
+    Decision check(const OrderIntent& intent) {
+        return check(intent.venue, intent.type);
+    }
+    
+    bool allow(const OrderIntent& intent) {
+        return check(intent) == Decision::ALLOW;
+    }
+    
+    // All-or-nothing check for a group of legs (arb / pairs): rate limits
+    // are charged only when every leg is allowed - legs charged before a
+    // refusal are refunded, so a gated group costs no venue budget
+    Decision check_all(std::span<const OrderIntent> legs, uint8_t account = 0, uint32_t weight = 1) {
+        if (kill_switch_.is_activated()) [[unlikely]] {
+            return Decision::KILL_SWITCH;
+        }
+        for (const auto& leg : legs) {
+            if (!breakers_.allow(leg.venue, leg.type)) {
+                return Decision::BREAKER_OPEN;
+            }
+        }
+        if (rate_limits_) {
+            for (size_t i = 0; i < legs.size(); ++i) {
+                if (!rate_limits_->try_acquire(legs[i].venue, account, weight, 1)) {
+                    for (size_t j = 0; j < i; ++j) {
+                        rate_limits_->release(legs[j].venue, account, weight, 1);
+                    }
+                    return Decision::RATE_LIMITED;
+                }
+            }
+        }
+        return Decision::ALLOW;
+    }
+    
+    // Give back the rate-limit charge of an allowed order that was not sent
+    void refund(Venue venue, uint8_t account = 0, uint32_t weight = 1) {
+        if (rate_limits_) {
+            rate_limits_->release(venue, account, weight, 1);
+        }
+    }
+
+    // How long a RATE_LIMITED order should be deferred
+    std::chrono::nanoseconds retry_after(Venue venue, uint8_t account = 0, uint32_t weight = 1) const {
+        return rate_limits_ ? rate_limits_->time_until_available(venue, account, weight, 1)
+                            : std::chrono::nanoseconds(0);
+    }
+
+    // Cheap pre-signal check: skip strategies whose venue can't take orders
+    bool venue_available(Venue venue) const {
+        return !kill_switch_.is_activated() && !breakers_.venue_tripped(venue);
+    }
+
+    bool is_killed() const {
+        return kill_switch_.is_activated();
+    }
+
+    KillSwitch& kill_switch() { return kill_switch_; }
+    CircuitBreakerRegistry& breakers() { return breakers_; }
+
+private:
+    KillSwitch& kill_switch_;
+    CircuitBreakerRegistry& breakers_;
+    RateLimiterRegistry* rate_limits_ = nullptr;
+};
+
+inline const char* to_string(OrderGate::Decision decision) {
+    switch (decision) {
+        case OrderGate::Decision::ALLOW: return "ALLOW";
+        case OrderGate::Decision::KILL_SWITCH: return "KILL_SWITCH";
+        case OrderGate::Decision::BREAKER_OPEN: return "BREAKER_OPEN";
+        case OrderGate::Decision::RATE_LIMITED: return "RATE_LIMITED";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace trading
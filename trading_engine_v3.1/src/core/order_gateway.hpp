@@ -0,0 +1,26 @@
+#pragma once
+
+#include "types.hpp"
+#include <span>
+
+namespace trading {
+
+// Order gateway - venue connectivity seen by the engine
+// Implemented by each exchange adapter (REST/WebSocket/FIX session).
+// Calls may block on the network; callers that need parallelism across
+// venues run them on their own threads.
+class OrderGateway {
+public:
+    virtual ~OrderGateway() = default;
+
+    // Send cancels for a batch of working orders on one venue.
+    // Adapters map this onto the venue's bulk endpoint where one exists
+    // (e.g. cancel-all per symbol) and fall back to individual cancels.
+    // Returns the number of orders a cancel was sent for.
+    virtual size_t cancel_orders(Venue venue, std::span<const Order> orders) = 0;
+
+    // Largest batch the venue accepts in one cancel request
+    virtual size_t max_cancel_batch(Venue /*venue*/) const { return 10; }
+};
+
+} // namespace trading
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+// Compact order intent - what a strategy wants to send, before it becomes
+// a full Order. Trivially copyable (no strings): symbol is a SymbolId and
+// the strategy a StrategyKind.
+struct OrderIntent {
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    SymbolId symbol;
+    Venue venue;
+    Side side;
+    OrderType type;
+    StrategyKind strategy;
+    uint8_t reservation_leg;        // Leg index within the reservation
+    double price;
+    double quantity;
+    uint64_t reservation_id;        // Multi-leg risk reservation (0 = none)
+    TimePoint created_time;
+
+    OrderIntent(SymbolId sym, Venue v, Side s, OrderType t, double px, double qty,
+                StrategyKind kind, TimePoint created = Clock::now())
+        : symbol(sym)
+        , venue(v)
+        , side(s)
+        , type(t)
+        , strategy(kind)
+        , reservation_leg(0)
+        , price(px)
+        , quantity(qty)
+        , reservation_id(0)
+        , created_time(created)
+    {}
+
+    // Full order for the gateway / order tracker
+    Order to_order() const {
+        Order order;
+        to_order(order);
+        return order;
+    }
+
+    // Fill a reused Order in place: every field is reset, and the string
+    // members keep their capacity, so a warmed-up Order doesn't allocate
+    void to_order(Order& order) const {
+        order.order_id.clear();
+        order.client_order_id.clear();
+        order.symbol.assign(get_symbol_name(symbol));
+        order.venue = venue;
+        order.side = side;
+        order.type = type;
+        order.price = price;
+        order.quantity = quantity;
+        order.filled_quantity = 0.0;
+        order.remaining_quantity = 0.0;
+        order.status = OrderStatus::PENDING;
+        order.reject_reason.clear();
+        order.created_time = created_time;
+        order.sent_time = TimePoint();
+        order.ack_time = TimePoint();
+        order.completed_time = TimePoint();
+        order.strategy_name.assign(strategy_name(strategy));
+        order.strategy = strategy;
+        order.signal_id = 0;
+        order.risk_notional = 0.0;
+        order.reservation_id = reservation_id;
+        order.reservation_leg = reservation_leg;
+    }
+
+    // Order::strategy_name each strategy's create_* path uses
+    static const char* strategy_name(StrategyKind kind) {
+        return kind == StrategyKind::PAIRS ? "PAIRS_TRADING" : to_string(kind);
+    }
+};
+
+// Order intent buffer - reused every tick, so emitting intents doesn't
+// allocate once the buffer has reached its working size
+//
+// Strategies append with emplace(); risk, routing and logging read intents
+// by index. Growing past the reserved capacity reallocates rather than
+// dropping an intent. Owned by one thread (the coordinator's).
+class OrderIntentBuffer {
+public:
+    explicit OrderIntentBuffer(size_t capacity = 64) {
+        intents_.reserve(capacity);
+    }
+
+    template<typename... Args>
+    OrderIntent& emplace(Args&&... args) {
+        return intents_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Drop intents from `size` on (e.g. legs that failed risk)
+    void truncate(size_t size) {
+        intents_.erase(intents_.begin() + static_cast<std::ptrdiff_t>(std::min(size, intents_.size())),
+                       intents_.end());
+    }
+
+    template<typename Pred>
+    void erase_if(Pred pred) {
+        intents_.erase(std::remove_if(intents_.begin(), intents_.end(), pred), intents_.end());
+    }
+
+    void clear() { intents_.clear(); }
+
+    OrderIntent& operator[](size_t i) { return intents_[i]; }
+    const OrderIntent& operator[](size_t i) const { return intents_[i]; }
+
+    // Intents [first, first + count)
+    std::span<OrderIntent> range(size_t first, size_t count) {
+        return std::span<OrderIntent>(intents_.data() + first, count);
+    }
+
+    std::span<const OrderIntent> view() const { return intents_; }
+
+    size_t size() const { return intents_.size(); }
+    bool empty() const { return intents_.empty(); }
+    size_t capacity() const { return intents_.capacity(); }
+
+    auto begin() const { return intents_.begin(); }
+    auto end() const { return intents_.end(); }
+
+private:
+    std::vector<OrderIntent> intents_;
+};
+
+} // namespace trading
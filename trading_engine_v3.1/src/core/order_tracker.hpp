@@ -1,6 +1,8 @@
 #pragma once
 
 #include "types.hpp"
+#include "symbol_map.hpp"
+#include <array>
 #include <unordered_map>
 #include <shared_mutex>
 #include <optional>
@@ -11,6 +13,8 @@ namespace trading {
 // Order tracking with proper symbol mapping
 class OrderTracker {
 public:
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    
     OrderTracker() = default;
     
     // Track new order with automatic cleanup
@@ -85,6 +89,17 @@ public:
         return std::nullopt;
     }
     
+    // Strategy that generated an order (fill attribution)
+    std::optional<std::string> get_strategy(const std::string& client_order_id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        
+        auto it = orders_.find(client_order_id);
+        if (it != orders_.end()) {
+            return it->second.strategy_name;
+        }
+        return std::nullopt;
+    }
+    
     // Get order by exchange ID
     std::optional<Order> get_order_by_exchange_id(const std::string& order_id) const {
         std::shared_lock<std::shared_mutex> lock(mutex_);
@@ -113,17 +128,31 @@ public:
         return result;
     }
     
+    // Active orders grouped by venue (kill-switch mass cancel)
+    std::array<std::vector<Order>, NUM_VENUES> get_active_orders_by_venue() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        
+        std::array<std::vector<Order>, NUM_VENUES> result;
+        for (const auto& client_id : active_orders_) {
+            auto it = orders_.find(client_id);
+            if (it != orders_.end()) {
+                result[static_cast<size_t>(it->second.venue)].push_back(it->second);
+            }
+        }
+        
+        return result;
+    }
+    
     // Get all orders for symbol
     std::vector<Order> get_orders_for_symbol(const std::string& symbol) const {
         std::shared_lock<std::shared_mutex> lock(mutex_);
         
         std::vector<Order> result;
         
-        auto it = symbol_orders_.find(symbol);
-        if (it != symbol_orders_.end()) {
-            result.reserve(it->second.size());
+        if (const auto* client_ids = symbol_orders_.find(symbol)) {
+            result.reserve(client_ids->size());
             
-            for (const auto& client_id : it->second) {
+            for (const auto& client_id : *client_ids) {
                 auto order_it = orders_.find(client_id);
                 if (order_it != orders_.end()) {
                     result.push_back(order_it->second);
@@ -156,10 +185,8 @@ public:
                     active_orders_.erase(order.client_order_id);
                     
                     // Remove from symbol index
-                    auto sym_it = symbol_orders_.find(order.symbol);
-                    if (sym_it != symbol_orders_.end()) {
-                        auto& vec = sym_it->second;
-                        vec.erase(std::remove(vec.begin(), vec.end(), order.client_order_id), vec.end());
+                    if (auto* vec = symbol_orders_.find(order.symbol)) {
+                        vec->erase(std::remove(vec->begin(), vec->end(), order.client_order_id), vec->end());
                     }
                     
                     it = orders_.erase(it);
@@ -194,7 +221,7 @@ private:
     
     // Indices for fast lookup
     std::unordered_map<std::string, std::string> order_id_to_client_id_;  // exchange ID -> client ID
-    std::unordered_map<std::string, std::vector<std::string>> symbol_orders_;  // symbol -> client IDs
+    SymbolMap<std::vector<std::string>> symbol_orders_;  // SymbolId -> client IDs
     std::unordered_set<std::string> active_orders_;  // Active order IDs
     
     // Internal cleanup (assumes lock held)
@@ -221,10 +248,8 @@ private:
                 order_id_to_client_id_.erase(it->second.order_id);
                 active_orders_.erase(client_id);
                 
-                auto sym_it = symbol_orders_.find(it->second.symbol);
-                if (sym_it != symbol_orders_.end()) {
-                    auto& vec = sym_it->second;
-                    vec.erase(std::remove(vec.begin(), vec.end(), client_id), vec.end());
+                if (auto* vec = symbol_orders_.find(it->second.symbol)) {
+                    vec->erase(std::remove(vec->begin(), vec->end(), client_id), vec->end());
                 }
                 
                 orders_.erase(it);
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace trading {
+
+// Position book - structure-of-arrays storage indexed by SymbolId
+// Each field is a contiguous column, so mark-to-market over every position
+// is a single vectorized pass against a price vector indexed the same way.
+// Not thread-safe: owned by RiskManager, which serializes access.
+class PositionBook {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    // Totals produced by a mark-to-market pass
+    struct MarkResult {
+        double total_unrealized;
+        double gross_exposure;
+
+        MarkResult() : total_unrealized(0.0), gross_exposure(0.0) {}
+    };
+
+    PositionBook() = default;
+
+    // Grow columns so id is addressable (amortized, off the hot path)
+    void ensure(SymbolId id) {
+        size_t needed = static_cast<size_t>(id) + 1;
+        if (needed <= quantity_.size()) return;
+
+        // Round up so vector loops see a multiple of 4 lanes
+        size_t capacity = (needed + 3) & ~size_t(3);
+        quantity_.resize(capacity, 0.0);
+        avg_price_.resize(capacity, 0.0);
+        realized_pnl_.resize(capacity, 0.0);
+        unrealized_pnl_.resize(capacity, 0.0);
+        fees_.resize(capacity, 0.0);
+        notional_.resize(capacity, 0.0);
+        mark_price_.resize(capacity, 0.0);
+        opened_time_.resize(capacity);
+        last_update_time_.resize(capacity);
+        present_.resize(capacity, 0);
+    }
+
+    size_t size() const { return quantity_.size(); }
+
+    bool contains(SymbolId id) const {
+        return id < present_.size() && present_[id];
+    }
+
+    // ===== Column access =====
+
+    double quantity(SymbolId id) const { return id < quantity_.size() ? quantity_[id] : 0.0; }
+    double avg_price(SymbolId id) const { return id < avg_price_.size() ? avg_price_[id] : 0.0; }
+    double realized_pnl(SymbolId id) const { return id < realized_pnl_.size() ? realized_pnl_[id] : 0.0; }
+    double unrealized_pnl(SymbolId id) const { return id < unrealized_pnl_.size() ? unrealized_pnl_[id] : 0.0; }
+    double notional(SymbolId id) const { return id < notional_.size() ? notional_[id] : 0.0; }
+    double mark_price(SymbolId id) const { return id < mark_price_.size() ? mark_price_[id] : 0.0; }
+
+    std::span<const double> quantities() const { return quantity_; }
+    std::span<const double> avg_prices() const { return avg_price_; }
+    std::span<const double> notionals() const { return notional_; }
+
+    // ===== Fill processing =====
+
+    // Apply fill; returns realized P&L delta (net of fee) for daily tracking
+    double apply_fill(SymbolId id, Side side, double price, double quantity, double fee,
+                      TimePoint fill_time) {
+        ensure(id);
+        present_[id] = 1;
+
+        double& qty = quantity_[id];
+        double& avg = avg_price_[id];
+        double signed_quantity = (side == Side::BUY) ? quantity : -quantity;
+        double realized_delta = 0.0;
+
+        bool is_flat = std::abs(qty) < 0.0000001;
+        bool is_long = qty > 0.0000001;
+        bool is_short = qty < -0.0000001;
+
+        if (is_flat) {
+            // Opening new position
+            qty = signed_quantity;
+            avg = price;
+            opened_time_[id] = fill_time;
+            fees_[id] = fee;
+
+        } else if ((is_long && side == Side::BUY) || (is_short && side == Side::SELL)) {
+            // Adding to position
+            double total_cost = (qty * avg) + (signed_quantity * price);
+            qty += signed_quantity;
+            avg = total_cost / qty;
+            fees_[id] += fee;
+
+        } else {
+            // Closing or reducing position
+            double closed_quantity = std::min(std::abs(signed_quantity), std::abs(qty));
+            double pnl = closed_quantity * (price - avg) * (is_long ? 1.0 : -1.0);
+
+            realized_delta = pnl - fee;
+            realized_pnl_[id] += realized_delta;
+            qty += signed_quantity;
+            fees_[id] += fee;
+        }
+
+        last_update_time_[id] = Clock::now();
+
+        // Keep this row's mark consistent with the new quantity; a symbol
+        // never marked yet is marked at its fill price
+        if (mark_price_[id] <= 0.0) {
+            mark_price_[id] = price;
+        }
+        mark_one(id);
+
+        return realized_delta;
+    }
+
+    // ===== Mark-to-market =====
+
+    // Update one symbol's mark (incremental tick path)
+    void set_mark(SymbolId id, double price) {
+        if (id >= mark_price_.size() || price <= 0.0) return;
+        mark_price_[id] = price;
+        mark_one(id);
+    }
+
+    // Mark every position against prices indexed by SymbolId (<= 0 = no price)
+    // One vectorized pass over the columns; also stores the marks.
+    MarkResult mark_to_market(std::span<const double> prices) {
+        size_t n = std::min(prices.size(), quantity_.size());
+
+        const double* __restrict p = prices.data();
+        const double* __restrict q = quantity_.data();
+        const double* __restrict a = avg_price_.data();
+        double* __restrict u = unrealized_pnl_.data();
+        double* __restrict nt = notional_.data();
+        double* __restrict m = mark_price_.data();
+
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        for (; i + 4 <= n; i += 4) {
+            __m256d vp = _mm256_loadu_pd(p + i);
+            __m256d has_price = _mm256_cmp_pd(vp, zero, _CMP_GT_OQ);
+
+            __m256d vq = _mm256_loadu_pd(q + i);
+            __m256d va = _mm256_loadu_pd(a + i);
+
+            __m256d new_u = _mm256_mul_pd(vq, _mm256_sub_pd(vp, va));
+            __m256d new_n = _mm256_and_pd(_mm256_mul_pd(vq, vp), abs_mask);
+
+            _mm256_storeu_pd(u + i, _mm256_blendv_pd(_mm256_loadu_pd(u + i), new_u, has_price));
+            _mm256_storeu_pd(nt + i, _mm256_blendv_pd(_mm256_loadu_pd(nt + i), new_n, has_price));
+            _mm256_storeu_pd(m + i, _mm256_blendv_pd(_mm256_loadu_pd(m + i), vp, has_price));
+        }
+#endif
+        for (; i < n; ++i) {
+            if (p[i] > 0.0) {
+                u[i] = q[i] * (p[i] - a[i]);
+                nt[i] = std::abs(q[i] * p[i]);
+                m[i] = p[i];
+            }
+        }
+
+        return totals();
+    }
+
+    // Sum of unrealized P&L and gross notional across all rows
+    MarkResult totals() const {
+        MarkResult result;
+        const size_t n = quantity_.size();
+        const double* __restrict u = unrealized_pnl_.data();
+        const double* __restrict nt = notional_.data();
+
+        double unrealized = 0.0;
+        double gross = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            unrealized += u[i];
+            gross += nt[i];
+        }
+
+        result.total_unrealized = unrealized;
+        result.gross_exposure = gross;
+        return result;
+    }
+
+    // Unrealized P&L at arbitrary prices without touching stored marks
+    double unrealized_at(std::span<const double> prices) const {
+        size_t n = std::min(prices.size(), quantity_.size());
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            total += prices[i] > 0.0 ? quantity_[i] * (prices[i] - avg_price_[i]) : 0.0;
+        }
+        return total;
+    }
+
+    // Signed cost-basis exposure (long - short)
+    double net_exposure() const {
+        double total = 0.0;
+        for (size_t i = 0; i < quantity_.size(); ++i) {
+            total += quantity_[i] * avg_price_[i];
+        }
+        return total;
+    }
+
+    // Signed notional per row at last mark (avg price until first mark)
+    void signed_notionals(std::vector<double>& out) const {
+        out.resize(quantity_.size());
+        for (size_t i = 0; i < quantity_.size(); ++i) {
+            double mark = mark_price_[i] > 0.0 ? mark_price_[i] : avg_price_[i];
+            out[i] = quantity_[i] * mark;
+        }
+    }
+
+    size_t open_positions() const {
+        size_t count = 0;
+        for (size_t i = 0; i < quantity_.size(); ++i) {
+            count += present_[i] && std::abs(quantity_[i]) >= 0.0000001;
+        }
+        return count;
+    }
+
+    size_t tracked_symbols() const {
+        return static_cast<size_t>(std::count(present_.begin(), present_.end(), uint8_t(1)));
+    }
+
+    // Materialize an AoS Position for callers outside the hot path
+    template<typename PositionT>
+    PositionT to_position(SymbolId id) const {
+        PositionT pos;
+        pos.symbol = std::string(get_symbol_name(id));
+        pos.quantity = quantity_[id];
+        pos.avg_price = avg_price_[id];
+        pos.realized_pnl = realized_pnl_[id];
+        pos.unrealized_pnl = unrealized_pnl_[id];
+        pos.total_fees_paid = fees_[id];
+        pos.notional_value = notional_[id];
+        pos.opened_time = opened_time_[id];
+        pos.last_update_time = last_update_time_[id];
+        return pos;
+    }
+
+    // Start of day: keep positions, drop P&L
+    void reset_pnl() {
+        std::fill(realized_pnl_.begin(), realized_pnl_.end(), 0.0);
+        std::fill(unrealized_pnl_.begin(), unrealized_pnl_.end(), 0.0);
+    }
+
+private:
+    // Hot columns
+    std::vector<double> quantity_;          // Signed: positive = long
+    std::vector<double> avg_price_;
+    std::vector<double> realized_pnl_;
+    std::vector<double> unrealized_pnl_;
+    std::vector<double> fees_;
+    std::vector<double> notional_;          // abs(quantity * mark)
+    std::vector<double> mark_price_;        // Last price used for marking
+
+    // Cold columns
+    std::vector<TimePoint> opened_time_;
+    std::vector<TimePoint> last_update_time_;
+    std::vector<uint8_t> present_;          // Symbol ever traded
+
+    void mark_one(SymbolId id) {
+        double mark = mark_price_[id];
+        if (mark <= 0.0) return;
+        unrealized_pnl_[id] = quantity_[id] * (mark - avg_price_[id]);
+        notional_[id] = std::abs(quantity_[id] * mark);
+    }
+};
+
+} // namespace trading
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Exchange-style rate limiter - several weighted token buckets, lock-free
+//
+// Each bucket is a GCRA (generic cell rate algorithm) cell: one atomic
+// "theoretical arrival time" per bucket, advanced by weight * emission
+// interval with a CAS. Equivalent to a token bucket of `limit` tokens
+// refilled over `interval`, but with no refill thread and no timer.
+// A request must fit every bucket; buckets already charged are refunded
+// when a later bucket refuses.
+class WeightedRateLimiter {
+public:
+    static constexpr size_t MAX_BUCKETS = 4;
+
+    // What a bucket counts
+    enum class BucketKind : uint8_t {
+        REQUEST_WEIGHT,     // Sum of request weights (e.g. Binance REQUEST_WEIGHT)
+        ORDERS              // Number of orders placed (e.g. Binance ORDERS)
+    };
+
+    struct BucketConfig {
+        BucketKind kind;
+        uint32_t limit;                     // Units allowed per interval (burst size)
+        std::chrono::nanoseconds interval;
+
+        BucketConfig(BucketKind k = BucketKind::REQUEST_WEIGHT, uint32_t l = 1200,
+                     std::chrono::nanoseconds i = std::chrono::minutes(1))
+            : kind(k), limit(l), interval(i) {}
+    };
+
+    struct Config {
+        std::vector<BucketConfig> buckets;
+        double safety_factor;               // Use this fraction of the exchange limit
+
+        Config()
+            : safety_factor(0.9)
+        {}
+    };
+
+    // Binance spot: 6000 weight/min, 100 orders/10s, 200k orders/day
+    static Config binance_spot() {
+        Config config;
+        config.buckets = {
+            BucketConfig(BucketKind::REQUEST_WEIGHT, 6000, std::chrono::minutes(1)),
+            BucketConfig(BucketKind::ORDERS, 100, std::chrono::seconds(10)),
+            BucketConfig(BucketKind::ORDERS, 200000, std::chrono::hours(24))
+        };
+        return config;
+    }
+
+    // Binance USD-M futures: 2400 weight/min, 300 orders/10s, 1200 orders/min
+    static Config binance_futures() {
+        Config config;
+        config.buckets = {
+            BucketConfig(BucketKind::REQUEST_WEIGHT, 2400, std::chrono::minutes(1)),
+            BucketConfig(BucketKind::ORDERS, 300, std::chrono::seconds(10)),
+            BucketConfig(BucketKind::ORDERS, 1200, std::chrono::minutes(1))
+        };
+        return config;
+    }
+
+    explicit WeightedRateLimiter(const Config& config = binance_spot())
+        : num_buckets_(std::min(config.buckets.size(), MAX_BUCKETS))
+        , base_(Clock::now())
+    {
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            const auto& bucket = config.buckets[i];
+            double limit = std::max(1.0, bucket.limit * config.safety_factor);
+
+            if (bucket.interval.count() <= 0) {
+                throw std::invalid_argument("Rate limit bucket interval must be > 0");
+            }
+
+            auto& cell = cells_[i];
+            cell.kind = bucket.kind;
+            cell.emission_ns = static_cast<int64_t>(bucket.interval.count() / limit);
+            cell.tolerance_ns = bucket.interval.count();
+            cell.tat.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    WeightedRateLimiter(const WeightedRateLimiter&) = delete;
+    WeightedRateLimiter& operator=(const WeightedRateLimiter&) = delete;
+
+    // Hot path: charge the request if every bucket has room
+    bool try_acquire(uint32_t weight, uint32_t orders = 0, TimePoint now = Clock::now()) {
+        int64_t t = elapsed_ns(now);
+
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            if (!try_charge(cells_[i], cost(cells_[i], weight, orders), t)) {
+                for (size_t j = 0; j < i; ++j) {
+                    refund(cells_[j], cost(cells_[j], weight, orders));
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Give back a charge whose request was never sent (e.g. another leg of
+    // the same group was refused)
+    void release(uint32_t weight, uint32_t orders = 0) {
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            refund(cells_[i], cost(cells_[i], weight, orders));
+        }
+    }
+
+    // Wait before try_acquire(weight, orders) would succeed (0 = now)
+    std::chrono::nanoseconds time_until_available(uint32_t weight, uint32_t orders = 0,
+                                                  TimePoint now = Clock::now()) const {
+        int64_t t = elapsed_ns(now);
+        int64_t wait = 0;
+
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            const auto& cell = cells_[i];
+            int64_t increment = cost(cell, weight, orders) * cell.emission_ns;
+            int64_t tat = std::max(cell.tat.load(std::memory_order_relaxed), t);
+            wait = std::max(wait, tat + increment - cell.tolerance_ns - t);
+        }
+        return std::chrono::nanoseconds(std::max<int64_t>(wait, 0));
+    }
+
+    // Fraction of bucket capacity in use (0..1), for monitoring
+    double utilization(size_t bucket, TimePoint now = Clock::now()) const {
+        if (bucket >= num_buckets_) return 0.0;
+        const auto& cell = cells_[bucket];
+        int64_t backlog = cell.tat.load(std::memory_order_relaxed) - elapsed_ns(now);
+        return std::clamp(static_cast<double>(backlog) / cell.tolerance_ns, 0.0, 1.0);
+    }
+
+    // Exchange told us we're over (429 / Retry-After): drain every bucket
+    void penalize(std::chrono::nanoseconds retry_after, TimePoint now = Clock::now()) {
+        int64_t t = elapsed_ns(now) + retry_after.count();
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            auto& cell = cells_[i];
+            int64_t blocked = t + cell.tolerance_ns;
+            int64_t current = cell.tat.load(std::memory_order_relaxed);
+            while (current < blocked &&
+                   !cell.tat.compare_exchange_weak(current, blocked, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    size_t num_buckets() const { return num_buckets_; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<int64_t> tat{0};        // Theoretical arrival time (ns since base_)
+        int64_t emission_ns = 0;            // Time one unit occupies
+        int64_t tolerance_ns = 0;           // Burst tolerance (= bucket interval)
+        BucketKind kind = BucketKind::REQUEST_WEIGHT;
+    };
+
+    std::array<Cell, MAX_BUCKETS> cells_;
+    size_t num_buckets_;
+    TimePoint base_;
+
+    int64_t elapsed_ns(TimePoint now) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now - base_).count();
+    }
+
+    static int64_t cost(const Cell& cell, uint32_t weight, uint32_t orders) {
+        return cell.kind == BucketKind::ORDERS ? orders : weight;
+    }
+
+    // GCRA: allow if max(tat, now) + cost*T - now <= tolerance
+    static bool try_charge(Cell& cell, int64_t units, int64_t now) {
+        if (units == 0) return true;
+
+        int64_t increment = units * cell.emission_ns;
+        int64_t current = cell.tat.load(std::memory_order_relaxed);
+
+        while (true) {
+            int64_t new_tat = std::max(current, now) + increment;
+            if (new_tat - now > cell.tolerance_ns) {
+                return false;
+            }
+            if (cell.tat.compare_exchange_weak(current, new_tat, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    static void refund(Cell& cell, int64_t units) {
+        if (units != 0) {
+            cell.tat.fetch_sub(units * cell.emission_ns, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Rate limiters per (venue, account)
+// Limiters are registered at startup; lookup on the order path is an array index.
+class RateLimiterRegistry {
+public:
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t MAX_ACCOUNTS = 8;
+
+    RateLimiterRegistry() = default;
+
+    RateLimiterRegistry(const RateLimiterRegistry&) = delete;
+    RateLimiterRegistry& operator=(const RateLimiterRegistry&) = delete;
+
+    // Register (or replace) limits for an account - call before trading starts
+    WeightedRateLimiter& add(Venue venue, uint8_t account,
+                             const WeightedRateLimiter::Config& config) {
+        if (account >= MAX_ACCOUNTS) {
+            throw std::out_of_range("Rate limiter account id out of range");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = limiters_[static_cast<size_t>(venue)][account];
+        slot = std::make_unique<WeightedRateLimiter>(config);
+        return *slot;
+    }
+
+    // nullptr = venue/account not rate limited
+    WeightedRateLimiter* find(Venue venue, uint8_t account = 0) const {
+        if (account >= MAX_ACCOUNTS) return nullptr;
+        return limiters_[static_cast<size_t>(venue)][account].get();
+    }
+
+    bool try_acquire(Venue venue, uint8_t account, uint32_t weight, uint32_t orders) {
+        auto* limiter = find(venue, account);
+        return !limiter || limiter->try_acquire(weight, orders);
+    }
+
+    void release(Venue venue, uint8_t account, uint32_t weight, uint32_t orders) {
+        if (auto* limiter = find(venue, account)) {
+            limiter->release(weight, orders);
+        }
+    }
+
+    std::chrono::nanoseconds time_until_available(Venue venue, uint8_t account,
+                                                  uint32_t weight, uint32_t orders) const {
+        auto* limiter = find(venue, account);
+        return limiter ? limiter->time_until_available(weight, orders) : std::chrono::nanoseconds(0);
+    }
+
+private:
+    std::mutex mutex_;
+    std::array<std::array<std::unique_ptr<WeightedRateLimiter>, MAX_ACCOUNTS>, NUM_VENUES> limiters_;
+};
+
+} // namespace trading
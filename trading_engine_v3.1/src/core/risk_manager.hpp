@@ -2,10 +2,20 @@
 
 #include "types.hpp"
 #include "order_tracker.hpp"
+#include "exposure_reservation.hpp"
+#include "var_engine.hpp"
+#include "scenario_engine.hpp"
+#include "sliding_window_counter.hpp"
+#include "position_book.hpp"
+#include "fill_analytics.hpp"
+#include "string_interning.hpp"
+#include "order_intent.hpp"
 #include <unordered_map>
 #include <shared_mutex>
 #include <atomic>
 #include <vector>
+#include <span>
+#include <array>
 
 namespace trading {
 
@@ -77,7 +87,8 @@ struct RiskLimits {
     
     // Order limits
     double max_order_size;              // Max single order notional
-    int max_orders_per_second;          // Rate limit
+    int max_orders_per_second;          // Rate limit (0 = disabled)
+    size_t max_reservation_groups;      // Reservation groups in flight (preallocated)
     
     // Concentration limits
     double max_single_symbol_pct;       // Max % of portfolio in one symbol
@@ -85,6 +96,10 @@ struct RiskLimits {
     // Time-based limits
     int max_position_hold_seconds;      // Max time to hold position
     
+    // Portfolio risk limits
+    double max_portfolio_var;           // Max parametric VaR (0 = disabled)
+    double max_stress_loss;             // Max worst-case scenario loss (0 = disabled)
+    
     RiskLimits()
         : max_position_per_symbol(50000.0)
         , max_total_gross_exposure(150000.0)
@@ -94,176 +109,327 @@ struct RiskLimits {
         , trailing_stop_pct(0.5)  // 50% drawdown from peak
         , max_order_size(10000.0)
         , max_orders_per_second(50)
+        , max_reservation_groups(ExposureReservationLedger::DEFAULT_MAX_GROUPS)
         , max_single_symbol_pct(0.4)  // 40%
         , max_position_hold_seconds(300)
+        , max_portfolio_var(0.0)
+        , max_stress_loss(0.0)
     {}
 };
 
 // Risk manager - institutional grade
 class RiskManager {
 public:
+    using SymbolId = SymbolRegistry::SymbolId;
+    
     explicit RiskManager(const RiskLimits& limits, OrderTracker& order_tracker)
         : limits_(limits)
         , order_tracker_(order_tracker)
         , peak_daily_pnl_(0.0)
+        , reservations_(limits.max_reservation_groups)
     {}
     
+    // Streaming VaR engine (optional) - enables VaR check and var_contribution
+    void attach_var_engine(PortfolioVarEngine* engine) {
+        var_engine_ = engine;
+    }
+    
+    // Scenario engine (optional) - enables worst-case stress loss check
+    void attach_scenario_engine(ScenarioEngine* engine) {
+        scenario_engine_ = engine;
+    }
+    
     // Pre-trade checks (MUST PASS before sending order)
     struct RiskCheckResult {
         bool passed;
-        std::string reason;  // If failed
+        const char* reason;  // If failed (static string: rejects don't allocate)
+        uint64_t reservation_id;  // Set by reserve_orders() on success
         
-        RiskCheckResult(bool p = true, const std::string& r = "")
-            : passed(p), reason(r) {}
+        RiskCheckResult(bool p = true, const char* r = "")
+            : passed(p), reason(r), reservation_id(0) {}
     };
     
     RiskCheckResult check_order(const Order& order, double current_price) {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return check_single(get_symbol_id(order.symbol), order, current_price);
+    }
+    
+    RiskCheckResult check_order(const OrderIntent& intent, double current_price) {
+        return check_single(intent.symbol, intent, current_price);
+    }
+    
+    // Atomically reserve exposure for a group of orders (arb / pairs legs)
+    // Either every leg fits within limits - counting positions AND exposure
+    // already reserved by other in-flight groups - or nothing is reserved.
+    // Each leg is marked at its own order price.
+    RiskCheckResult reserve_orders(std::span<const Order> orders) {
+        if (orders.empty() || orders.size() > ExposureReservationLedger::MAX_LEGS) {
+            return RiskCheckResult(false, "Invalid reservation group size");
+        }
         
-        // Check 1: Daily loss limit
-        double current_pnl = get_total_pnl_internal(current_price);
-        if (current_pnl < -limits_.max_daily_loss) {
-            return RiskCheckResult(false, "Daily loss limit exceeded");
+        std::array<ReservationLeg, ExposureReservationLedger::MAX_LEGS> legs;
+        for (size_t i = 0; i < orders.size(); ++i) {
+            legs[i] = ReservationLeg{register_symbol(orders[i].symbol), orders[i].side,
+                                     orders[i].price, orders[i].quantity};
+        }
+        return reserve_legs(std::span<const ReservationLeg>(legs.data(), orders.size()));
+    }
+    
+    // Hot path: intent legs already carry their SymbolId (no strings, no heap)
+    RiskCheckResult reserve_orders(std::span<const OrderIntent> intents) {
+        if (intents.empty() || intents.size() > ExposureReservationLedger::MAX_LEGS) {
+            return RiskCheckResult(false, "Invalid reservation group size");
         }
         
-        // Check 2: Trailing stop from peak
-        double drawdown_from_peak = peak_daily_pnl_.load() - current_pnl;
-        double max_drawdown = limits_.max_daily_loss * limits_.trailing_stop_pct;
-        if (drawdown_from_peak > max_drawdown) {
-            return RiskCheckResult(false, "Trailing stop hit");
+        std::array<ReservationLeg, ExposureReservationLedger::MAX_LEGS> legs;
+        for (size_t i = 0; i < intents.size(); ++i) {
+            legs[i] = ReservationLeg{intents[i].symbol, intents[i].side,
+                                     intents[i].price, intents[i].quantity};
+        }
+        return reserve_legs(std::span<const ReservationLeg>(legs.data(), intents.size()));
+    }
+    
+    RiskCheckResult reserve_legs(std::span<const ReservationLeg> legs) {
+        if (legs.empty() || legs.size() > ExposureReservationLedger::MAX_LEGS) {
+            return RiskCheckResult(false, "Invalid reservation group size");
         }
         
-        // Check 3: Order size limit
-        double order_notional = order.quantity * order.price;
-        if (order_notional > limits_.max_order_size) {
-            return RiskCheckResult(false, "Order size exceeds limit");
+        for (const auto& leg : legs) {
+            if (leg.symbol == SymbolRegistry::INVALID_SYMBOL || leg.symbol >= SymbolRegistry::MAX_SYMBOLS) {
+                return RiskCheckResult(false, "Unknown symbol");
+            }
         }
         
-        // Check 4: Position limit for this symbol
-        auto pos_it = positions_.find(order.symbol);
-        double current_notional = 0.0;
-        if (pos_it != positions_.end()) {
-            current_notional = std::abs(pos_it->second.quantity * current_price);
+        TimePoint now = Clock::now();
+        if (!acquire_order_rate(legs.size(), now)) {
+            return RiskCheckResult(false, "Order rate limit exceeded");
         }
         
-        // Calculate new position after order
-        double new_quantity = (pos_it != positions_.end() ? pos_it->second.quantity : 0.0);
-        if (order.side == Side::BUY) {
-            new_quantity += order.quantity;
-        } else {
-            new_quantity -= order.quantity;
+        RiskCheckResult result = reserve_legs_rated(legs);
+        if (!result.passed) {
+            release_order_rate(legs.size(), now);
         }
-        double new_notional = std::abs(new_quantity * current_price);
+        return result;
+    }
+    
+private:
+    // reserve_legs() once the group's orders are counted against the rate limit
+    RiskCheckResult reserve_legs_rated(std::span<const ReservationLeg> legs) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
         
-        if (new_notional > limits_.max_position_per_symbol) {
-            return RiskCheckResult(false, "Symbol position limit exceeded");
+        // Stateless checks first (no shard locks needed)
+        double current_pnl = get_total_pnl_internal(0.0);
+        if (current_pnl < -limits_.max_daily_loss) {
+            return RiskCheckResult(false, "Daily loss limit exceeded");
         }
         
-        // Check 5: Total gross exposure
-        double total_gross = calculate_total_gross_exposure(current_price);
-        double order_impact = order_notional;
+        double drawdown_from_peak = peak_daily_pnl_.load() - current_pnl;
+        if (drawdown_from_peak > limits_.max_daily_loss * limits_.trailing_stop_pct) {
+            return RiskCheckResult(false, "Trailing stop hit");
+        }
         
-        if (pos_it != positions_.end()) {
-            // If reducing position, don't add to gross
-            if ((pos_it->second.is_long() && order.side == Side::SELL) ||
-                (pos_it->second.is_short() && order.side == Side::BUY)) {
-                order_impact = std::max(0.0, new_notional - current_notional);
+        for (const auto& leg : legs) {
+            if (leg.quantity * leg.price > limits_.max_order_size) {
+                return RiskCheckResult(false, "Order size exceeds limit");
             }
         }
         
-        if (total_gross + order_impact > limits_.max_total_gross_exposure) {
-            return RiskCheckResult(false, "Total gross exposure limit exceeded");
+        ExposureReservationLedger::ShardGuard guard(reservations_, legs);
+        
+        // Legs of the same group can share a symbol - accumulate as we go
+        std::array<SymbolReservation, ExposureReservationLedger::MAX_LEGS> group_pending;
+        std::array<double, ExposureReservationLedger::MAX_LEGS> gross_impacts{};
+        double total_impact = 0.0;
+        
+        for (size_t i = 0; i < legs.size(); ++i) {
+            const auto& leg = legs[i];
+            
+            SymbolReservation pending = reservations_.pending_locked(leg.symbol);
+            for (size_t j = 0; j < i; ++j) {
+                if (legs[j].symbol == leg.symbol) {
+                    pending.pending_buy_qty += group_pending[j].pending_buy_qty;
+                    pending.pending_sell_qty += group_pending[j].pending_sell_qty;
+                }
+            }
+            
+            double position_qty = positions_.quantity(leg.symbol);
+            
+            // Worst case: every pending order on one side fills
+            double current_worst = std::max(std::abs(position_qty + pending.pending_buy_qty),
+                                            std::abs(position_qty - pending.pending_sell_qty));
+            
+            if (leg.side == Side::BUY) {
+                pending.pending_buy_qty += leg.quantity;
+                group_pending[i].pending_buy_qty = leg.quantity;
+            } else {
+                pending.pending_sell_qty += leg.quantity;
+                group_pending[i].pending_sell_qty = leg.quantity;
+            }
+            
+            double new_worst = std::max(std::abs(position_qty + pending.pending_buy_qty),
+                                        std::abs(position_qty - pending.pending_sell_qty));
+            
+            double new_notional = new_worst * leg.price;
+            if (new_notional > limits_.max_position_per_symbol) {
+                return RiskCheckResult(false, "Symbol position limit exceeded (incl. reserved)");
+            }
+            
+            gross_impacts[i] = std::max(0.0, (new_worst - current_worst) * leg.price);
+            total_impact += gross_impacts[i];
         }
         
-        // Check 6: Concentration limit
-        double portfolio_value = total_gross + order_impact;
-        if (portfolio_value > 0 && new_notional / portfolio_value > limits_.max_single_symbol_pct) {
-            return RiskCheckResult(false, "Concentration limit exceeded");
+        // Portfolio checks on the group's net effect: offsetting legs (arb
+        // buy/sell of one symbol, a hedged pair) are judged together
+        RiskCheckResult net = check_group_net(legs, total_impact);
+        if (!net.passed) {
+            return net;
         }
         
-        return RiskCheckResult(true);
+        double headroom = limits_.max_total_gross_exposure - calculate_total_gross_exposure();
+        if (!reservations_.try_reserve_gross(total_impact, headroom)) {
+            return RiskCheckResult(false, "Total gross exposure limit exceeded (incl. reserved)");
+        }
+        
+        RiskCheckResult result(true);
+        result.reservation_id = reservations_.commit_locked(
+            legs, std::span<const double>(gross_impacts.data(), legs.size()));
+        if (result.reservation_id == ExposureReservationLedger::INVALID_RESERVATION) {
+            reservations_.release_gross(total_impact);
+            return RiskCheckResult(false, "Reservation ledger full");
+        }
+        return result;
+    }
+    
+public:
+    
+    // Release a whole reservation group (all legs rejected / canceled)
+    void release_reservation(uint64_t reservation_id) {
+        reservations_.release_group(reservation_id);
+    }
+    
+    // Release part of one leg (partial cancel, IOC remainder expired)
+    void release_reserved_quantity(uint64_t reservation_id, int leg, double quantity) {
+        reservations_.release_quantity(reservation_id, static_cast<size_t>(leg), quantity);
+    }
+    
+    // Turn reserved exposure into position
+    // Position is booked before the reservation is released, so limits are
+    // briefly double counted (conservative) rather than briefly missing.
+    void commit_fill(uint64_t reservation_id, int leg, const Fill& fill) {
+        on_fill(fill);
+        reservations_.release_quantity(reservation_id, static_cast<size_t>(leg), fill.quantity);
+    }
+    
+    double get_reserved_gross_exposure() const {
+        return reservations_.reserved_gross();
+    }
+    
+    size_t active_reservations() const {
+        return reservations_.active_groups();
     }
     
     // Process fill and update positions
     void on_fill(const Fill& fill) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
+        SymbolId id = register_symbol(fill.symbol);
         
-        auto& pos = positions_[fill.symbol];
+        // Attribution lookup takes the tracker's lock - do it before ours
+        auto strategy = order_tracker_.get_strategy(fill.client_order_id);
         
-        double signed_quantity = (fill.side == Side::BUY) ? fill.quantity : -fill.quantity;
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         
-        if (pos.is_flat()) {
-            // Opening new position
-            pos.symbol = fill.symbol;
-            pos.quantity = signed_quantity;
-            pos.avg_price = fill.price;
-            pos.opened_time = fill.received_time;
-            pos.total_fees_paid = fill.fee;
-            
-        } else if ((pos.is_long() && fill.side == Side::BUY) ||
-                   (pos.is_short() && fill.side == Side::SELL)) {
-            // Adding to position
-            double total_cost = (pos.quantity * pos.avg_price) + (signed_quantity * fill.price);
-            pos.quantity += signed_quantity;
-            pos.avg_price = total_cost / pos.quantity;
-            pos.total_fees_paid += fill.fee;
-            
-        } else {
-            // Closing or reducing position
-            double closed_quantity = std::min(std::abs(signed_quantity), std::abs(pos.quantity));
-            double pnl = closed_quantity * (fill.price - pos.avg_price) * 
-                        (pos.is_long() ? 1.0 : -1.0);
-            
-            pos.realized_pnl += (pnl - fill.fee);
-            pos.quantity += signed_quantity;
-            pos.total_fees_paid += fill.fee;
-            
+        double old_unrealized = positions_.unrealized_pnl(id);
+        double old_notional = positions_.notional(id);
+        
+        double realized = positions_.apply_fill(id, fill.side, fill.price, fill.quantity,
+                                                fill.fee, fill.received_time);
+        if (realized != 0.0) {
             // Update daily P&L atomically
-            daily_realized_pnl_.fetch_add(pnl - fill.fee, std::memory_order_relaxed);
+            daily_realized_pnl_.fetch_add(realized, std::memory_order_relaxed);
         }
         
-        pos.last_update_time = Clock::now();
+        // Keep cached totals exact without rescanning
+        total_unrealized_ += positions_.unrealized_pnl(id) - old_unrealized;
+        gross_exposure_ += positions_.notional(id) - old_notional;
         
-        // Track fills for analysis
-        recent_fills_.push_back(fill);
-        if (recent_fills_.size() > 1000) {
-            recent_fills_.erase(recent_fills_.begin());
+        if (var_engine_) {
+            var_engine_->on_position(id, positions_.quantity(id));
         }
+        
+        // Track fills for analysis (ring + O(1) aggregates)
+        uint8_t strategy_id = strategy ? fill_analytics_.strategy_id(*strategy)
+                                       : FillAnalytics::UNKNOWN_STRATEGY;
+        fill_analytics_.record(fill, id, strategy_id);
     }
     
-    // Update unrealized P&L with current market prices
-    void update_market_prices(const std::unordered_map<std::string, double>& prices) {
+    // Mark all positions against a price vector indexed by SymbolId
+    // (<= 0 means no price). One vectorized pass over the position columns.
+    void update_market_prices(std::span<const double> prices_by_id) {
         std::unique_lock<std::shared_mutex> lock(mutex_);
         
-        double total_unrealized = 0.0;
+        auto totals = positions_.mark_to_market(prices_by_id);
+        total_unrealized_ = totals.total_unrealized;
+        gross_exposure_ = totals.gross_exposure;
         
-        for (auto& [symbol, pos] : positions_) {
-            auto it = prices.find(symbol);
-            if (it != prices.end()) {
-                pos.update_unrealized(it->second);
-                total_unrealized += pos.unrealized_pnl;
+        if (var_engine_) {
+            for (size_t id = 0; id < prices_by_id.size(); ++id) {
+                if (prices_by_id[id] > 0.0) {
+                    var_engine_->on_price(static_cast<SymbolId>(id), prices_by_id[id]);
+                }
             }
         }
         
-        // Update peak for trailing stop
-        double total_pnl = daily_realized_pnl_.load(std::memory_order_relaxed) + total_unrealized;
+        update_peak_locked();
+    }
+    
+    // String-keyed convenience overload - translates into the price vector
+    void update_market_prices(const std::unordered_map<std::string, double>& prices) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         
-        double current_peak = peak_daily_pnl_.load(std::memory_order_relaxed);
-        while (total_pnl > current_peak) {
-            if (peak_daily_pnl_.compare_exchange_weak(current_peak, total_pnl,
-                                                       std::memory_order_relaxed)) {
-                break;
+        price_scratch_.assign(positions_.size(), 0.0);
+        for (const auto& [symbol, price] : prices) {
+            SymbolId id = get_symbol_id(symbol);
+            if (id < price_scratch_.size()) {
+                price_scratch_[id] = price;
+            }
+            if (var_engine_ && id != SymbolRegistry::INVALID_SYMBOL) {
+                var_engine_->on_price(id, price);
             }
         }
+        
+        auto totals = positions_.mark_to_market(price_scratch_);
+        total_unrealized_ = totals.total_unrealized;
+        gross_exposure_ = totals.gross_exposure;
+        
+        update_peak_locked();
+    }
+    
+    // Single-symbol tick (O(1), keeps cached totals exact)
+    void update_market_price(SymbolId id, double price) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        
+        double old_unrealized = positions_.unrealized_pnl(id);
+        double old_notional = positions_.notional(id);
+        
+        positions_.set_mark(id, price);
+        
+        total_unrealized_ += positions_.unrealized_pnl(id) - old_unrealized;
+        gross_exposure_ += positions_.notional(id) - old_notional;
+        
+        if (var_engine_) {
+            var_engine_->on_price(id, price);
+        }
+        
+        update_peak_locked();
     }
     
     // Get position
     std::optional<Position> get_position(const std::string& symbol) const {
         std::shared_lock<std::shared_mutex> lock(mutex_);
         
-        auto it = positions_.find(symbol);
-        if (it != positions_.end()) {
-            return it->second;
+        SymbolId id = get_symbol_id(symbol);
+        if (positions_.contains(id)) {
+            Position pos = positions_.to_position<Position>(id);
+            pos.var_contribution = var_contribution(id);
+            return pos;
         }
         return std::nullopt;
     }
@@ -273,38 +439,49 @@ public:
         std::shared_lock<std::shared_mutex> lock(mutex_);
         
         std::vector<Position> result;
-        result.reserve(positions_.size());
+        result.reserve(positions_.open_positions());
         
-        for (const auto& [symbol, pos] : positions_) {
-            if (!pos.is_flat()) {
-                result.push_back(pos);
+        for (size_t i = 0; i < positions_.size(); ++i) {
+            SymbolId id = static_cast<SymbolId>(i);
+            if (positions_.contains(id) && std::abs(positions_.quantity(id)) >= 0.0000001) {
+                result.push_back(positions_.to_position<Position>(id));
+                result.back().var_contribution = var_contribution(id);
             }
         }
         
         return result;
     }
     
+    // Signed notional per SymbolId at last mark (scenario engine exposure source)
+    void snapshot_exposures(std::vector<double>& out) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        positions_.signed_notionals(out);
+    }
+    
     // Get total P&L (realized + unrealized)
     double get_total_pnl(const std::unordered_map<std::string, double>& current_prices) {
         std::shared_lock<std::shared_mutex> lock(mutex_);
         return get_total_pnl_internal(current_prices);
     }
     
-    // Risk metrics
-    double calculate_total_gross_exposure(double generic_price = 0.0) const {
-        double total = 0.0;
-        for (const auto& [symbol, pos] : positions_) {
-            total += pos.notional_value;
-        }
-        return total;
+    double get_total_pnl(std::span<const double> prices_by_id) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return daily_realized_pnl_.load(std::memory_order_relaxed) +
+               positions_.unrealized_at(prices_by_id);
+    }
+    
+    // Orders passed in the last second
+    double get_order_rate() const {
+        return order_rate_.rate();
+    }
+    
+    // Risk metrics (cached totals, O(1))
+    double calculate_total_gross_exposure(double /*generic_price*/ = 0.0) const {
+        return gross_exposure_;
     }
     
     double calculate_total_net_exposure() const {
-        double total = 0.0;
-        for (const auto& [symbol, pos] : positions_) {
-            total += pos.quantity * pos.avg_price;  // Signed
-        }
-        return total;
+        return positions_.net_exposure();  // Signed
     }
     
     // Reset daily P&L (call at start of trading day)
@@ -314,12 +491,10 @@ public:
         daily_realized_pnl_.store(0.0, std::memory_order_relaxed);
         peak_daily_pnl_.store(0.0, std::memory_order_relaxed);
         
-        for (auto& [symbol, pos] : positions_) {
-            pos.realized_pnl = 0.0;
-            pos.unrealized_pnl = 0.0;
-        }
+        positions_.reset_pnl();
+        total_unrealized_ = 0.0;
         
-        recent_fills_.clear();
+        fill_analytics_.clear();
     }
     
     // Statistics
@@ -335,66 +510,284 @@ public:
         size_t num_fills;
     };
     
-    RiskStats get_stats(const std::unordered_map<std::string, double>& current_prices) {
+    RiskStats get_stats(const std::unordered_map<std::string, double>& /*current_prices*/) {
+        return get_stats();
+    }
+    
+    RiskStats get_stats() const {
         std::shared_lock<std::shared_mutex> lock(mutex_);
         
         RiskStats stats;
         stats.total_realized_pnl = daily_realized_pnl_.load(std::memory_order_relaxed);
-        
-        double unrealized = 0.0;
-        for (const auto& [symbol, pos] : positions_) {
-            unrealized += pos.unrealized_pnl;
-        }
-        stats.total_unrealized_pnl = unrealized;
+        stats.total_unrealized_pnl = total_unrealized_;
         stats.total_pnl = stats.total_realized_pnl + stats.total_unrealized_pnl;
         
         stats.gross_exposure = calculate_total_gross_exposure();
         stats.net_exposure = calculate_total_net_exposure();
         stats.peak_pnl_today = peak_daily_pnl_.load(std::memory_order_relaxed);
         stats.drawdown_from_peak = stats.peak_pnl_today - stats.total_pnl;
-        stats.num_positions = positions_.size();
-        stats.num_fills = recent_fills_.size();
+        stats.num_positions = positions_.tracked_symbols();
+        stats.num_fills = fill_analytics_.history_size();
         
         return stats;
     }
     
+    // Fill analytics (streaming aggregates, no rescans)
+    FillAggregate get_symbol_fill_stats(const std::string& symbol) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return fill_analytics_.symbol_stats(get_symbol_id(symbol));
+    }
+    
+    FillAggregate get_strategy_fill_stats(const std::string& strategy_name) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return fill_analytics_.strategy_stats(fill_analytics_.find_strategy(strategy_name));
+    }
+    
+    FillAggregate get_total_fill_stats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return fill_analytics_.total_stats();
+    }
+    
+    std::vector<FillRecord> get_recent_fills(size_t max_count = 100) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return fill_analytics_.recent(max_count);
+    }
+    
 private:
     RiskLimits limits_;
     OrderTracker& order_tracker_;
     
     mutable std::shared_mutex mutex_;
-    std::unordered_map<std::string, Position> positions_;
+    PositionBook positions_;            // SoA, indexed by SymbolId
+    double total_unrealized_ = 0.0;     // Cached sum of unrealized P&L
+    double gross_exposure_ = 0.0;       // Cached sum of abs notional
+    std::vector<double> price_scratch_; // String-keyed price translation
     
     std::atomic<double> daily_realized_pnl_{0.0};
     std::atomic<double> peak_daily_pnl_{0.0};
     
-    std::vector<Fill> recent_fills_;  // For analysis
+    FillAnalytics fill_analytics_;  // Ring history + per-symbol/strategy aggregates
     
-    // Internal helper (assumes lock held)
-    double get_total_pnl_internal(double generic_price) const {
-        double realized = daily_realized_pnl_.load(std::memory_order_relaxed);
-        double unrealized = 0.0;
+    // In-flight exposure of multi-leg groups (own sharded locks)
+    ExposureReservationLedger reservations_;
+    
+    PortfolioVarEngine* var_engine_ = nullptr;
+    ScenarioEngine* scenario_engine_ = nullptr;
+    
+    // Orders passed by check_order/reserve_orders (1s window, 100ms buckets)
+    SlidingWindowCounter order_rate_{std::chrono::seconds(1), 10};
+    
+    // Count orders against max_orders_per_second in one step (no check-then-add
+    // window for concurrent callers); release_order_rate() backs out a reject
+    bool acquire_order_rate(size_t orders, TimePoint now) {
+        if (limits_.max_orders_per_second <= 0) {
+            order_rate_.add(orders, now);
+            return true;
+        }
+        return order_rate_.try_add(orders, static_cast<uint64_t>(limits_.max_orders_per_second), now);
+    }
+    
+    void release_order_rate(size_t orders, TimePoint now) {
+        order_rate_.remove(orders, now);
+    }
+    
+    // Single-order checks (Order or OrderIntent: side / price / quantity)
+    template<typename O>
+    RiskCheckResult check_single(SymbolId symbol_id, const O& order, double current_price) {
+        // Check 0: Order rate (lock-free sliding window, counted up front)
+        TimePoint now = Clock::now();
+        if (!acquire_order_rate(1, now)) {
+            return RiskCheckResult(false, "Order rate limit exceeded");
+        }
         
-        for (const auto& [symbol, pos] : positions_) {
-            unrealized += pos.unrealized_pnl;
+        RiskCheckResult result = check_single_rated(symbol_id, order, current_price);
+        if (!result.passed) {
+            release_order_rate(1, now);
         }
+        return result;
+    }
+    
+    template<typename O>
+    RiskCheckResult check_single_rated(SymbolId symbol_id, const O& order, double current_price) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
         
-        return realized + unrealized;
+        // Check 1: Daily loss limit
+        double current_pnl = get_total_pnl_internal(current_price);
+        if (current_pnl < -limits_.max_daily_loss) {
+            return RiskCheckResult(false, "Daily loss limit exceeded");
+        }
+        
+        // Check 2: Trailing stop from peak
+        double drawdown_from_peak = peak_daily_pnl_.load() - current_pnl;
+        double max_drawdown = limits_.max_daily_loss * limits_.trailing_stop_pct;
+        if (drawdown_from_peak > max_drawdown) {
+            return RiskCheckResult(false, "Trailing stop hit");
+        }
+        
+        // Check 3: Order size limit
+        double order_notional = order.quantity * order.price;
+        if (order_notional > limits_.max_order_size) {
+            return RiskCheckResult(false, "Order size exceeds limit");
+        }
+        
+        // Check 4: Position limit for this symbol
+        double position_qty = positions_.quantity(symbol_id);
+        double current_notional = std::abs(position_qty * current_price);
+        
+        // Calculate new position after order
+        double new_quantity = position_qty;
+        if (order.side == Side::BUY) {
+            new_quantity += order.quantity;
+        } else {
+            new_quantity -= order.quantity;
+        }
+        double new_notional = std::abs(new_quantity * current_price);
+        
+        // Worst case counts quantity reserved by in-flight groups, as reserve_orders() does
+        SymbolReservation pending = reservations_.pending(symbol_id);
+        if (order.side == Side::BUY) {
+            pending.pending_buy_qty += order.quantity;
+        } else {
+            pending.pending_sell_qty += order.quantity;
+        }
+        double worst_qty = std::max(std::abs(position_qty + pending.pending_buy_qty),
+                                    std::abs(position_qty - pending.pending_sell_qty));
+        
+        if (worst_qty * current_price > limits_.max_position_per_symbol) {
+            return RiskCheckResult(false, "Symbol position limit exceeded (incl. reserved)");
+        }
+        
+        // Check 5: Total gross exposure (including in-flight reservations)
+        double total_gross = calculate_total_gross_exposure(current_price) +
+                             reservations_.reserved_gross();
+        double order_impact = order_notional;
+        
+        // If reducing position, don't add to gross
+        if ((position_qty > 0.0000001 && order.side == Side::SELL) ||
+            (position_qty < -0.0000001 && order.side == Side::BUY)) {
+            order_impact = std::max(0.0, new_notional - current_notional);
+        }
+        
+        if (total_gross + order_impact > limits_.max_total_gross_exposure) {
+            return RiskCheckResult(false, "Total gross exposure limit exceeded");
+        }
+        
+        // Check 6: Concentration limit
+        double portfolio_value = total_gross + order_impact;
+        if (portfolio_value > 0 && new_notional / portfolio_value > limits_.max_single_symbol_pct) {
+            return RiskCheckResult(false, "Concentration limit exceeded");
+        }
+        
+        // Check 7: Portfolio VaR (lock-free read of risk-core snapshot)
+        if (var_engine_ && limits_.max_portfolio_var > 0.0) {
+            double signed_notional = (order.side == Side::BUY ? order_notional : -order_notional);
+            double var_after = var_engine_->var_after_trade(symbol_id, signed_notional);
+            if (var_after > limits_.max_portfolio_var) {
+                return RiskCheckResult(false, "Portfolio VaR limit exceeded");
+            }
+        }
+        
+        // Check 8: Worst-case stress loss (lock-free read of scenario snapshot)
+        if (scenario_engine_ && limits_.max_stress_loss > 0.0) {
+            double signed_notional = (order.side == Side::BUY ? order_notional : -order_notional);
+            double loss_after = scenario_engine_->loss_after_trade(symbol_id, signed_notional);
+            if (loss_after > limits_.max_stress_loss) {
+                return RiskCheckResult(false, "Stress loss limit exceeded");
+            }
+        }
+        
+        return RiskCheckResult(true);
+    }
+    
+    // Concentration, VaR and stress checks (6-8) on the net of a reservation group
+    // Caller holds mutex_. Legs on the same symbol offset each other.
+    RiskCheckResult check_group_net(std::span<const ReservationLeg> legs, double gross_impact) const {
+        constexpr size_t MAX_LEGS = ExposureReservationLedger::MAX_LEGS;
+        std::array<NotionalDelta, MAX_LEGS> net{};
+        std::array<double, MAX_LEGS> net_qty{};
+        std::array<double, MAX_LEGS> price{};
+        size_t count = 0;
+        
+        for (const auto& leg : legs) {
+            SymbolId id = leg.symbol;
+            size_t k = 0;
+            while (k < count && net[k].symbol != id) ++k;
+            if (k == count) {
+                net[count++] = NotionalDelta{id, 0.0};
+            }
+            
+            double signed_qty = leg.side == Side::BUY ? leg.quantity : -leg.quantity;
+            net[k].signed_notional += signed_qty * leg.price;
+            net_qty[k] += signed_qty;
+            price[k] = leg.price;
+        }
+        
+        // Check 6: Concentration (gross includes in-flight reservations)
+        double portfolio_value = calculate_total_gross_exposure() + reservations_.reserved_gross() +
+                                 gross_impact;
+        for (size_t k = 0; k < count; ++k) {
+            double new_notional = std::abs(positions_.quantity(net[k].symbol) + net_qty[k]) * price[k];
+            if (portfolio_value > 0 && new_notional / portfolio_value > limits_.max_single_symbol_pct) {
+                return RiskCheckResult(false, "Concentration limit exceeded");
+            }
+        }
+        
+        // Check 7: Portfolio VaR
+        if (var_engine_ && limits_.max_portfolio_var > 0.0) {
+            double var_after = var_engine_->var_after_trades(
+                std::span<const NotionalDelta>(net.data(), count));
+            if (var_after > limits_.max_portfolio_var) {
+                return RiskCheckResult(false, "Portfolio VaR limit exceeded");
+            }
+        }
+        
+        // Check 8: Worst-case stress loss
+        if (scenario_engine_ && limits_.max_stress_loss > 0.0) {
+            double loss_after = scenario_engine_->loss_after_trades(
+                std::span<const NotionalDelta>(net.data(), count));
+            if (loss_after > limits_.max_stress_loss) {
+                return RiskCheckResult(false, "Stress loss limit exceeded");
+            }
+        }
+        
+        return RiskCheckResult(true);
+    }
+    
+    double var_contribution(SymbolId id) const {
+        return var_engine_ ? var_engine_->component_var(id) : 0.0;
+    }
+    
+    // Internal helper (assumes lock held)
+    double get_total_pnl_internal(double /*generic_price*/) const {
+        return daily_realized_pnl_.load(std::memory_order_relaxed) + total_unrealized_;
     }
     
     double get_total_pnl_internal(const std::unordered_map<std::string, double>& prices) const {
         double realized = daily_realized_pnl_.load(std::memory_order_relaxed);
         double unrealized = 0.0;
         
-        for (const auto& [symbol, pos] : positions_) {
-            auto it = prices.find(symbol);
-            if (it != prices.end()) {
-                unrealized += pos.calculate_unrealized(it->second);
+        for (const auto& [symbol, price] : prices) {
+            SymbolId id = get_symbol_id(symbol);
+            if (positions_.contains(id)) {
+                unrealized += positions_.quantity(id) * (price - positions_.avg_price(id));
             }
         }
         
         return realized + unrealized;
     }
+    
+    // Update peak for trailing stop (assumes lock held)
+    void update_peak_locked() {
+        double total_pnl = daily_realized_pnl_.load(std::memory_order_relaxed) + total_unrealized_;
+        
+        double current_peak = peak_daily_pnl_.load(std::memory_order_relaxed);
+        while (total_pnl > current_peak) {
+            if (peak_daily_pnl_.compare_exchange_weak(current_peak, total_pnl,
+                                                       std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
 };
 
 } // namespace trading
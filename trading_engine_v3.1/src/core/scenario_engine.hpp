@@ -0,0 +1,625 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include "var_engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace trading {
+
+// Intraday stress / scenario engine
+//
+// Every interval a background thread snapshots signed notional per symbol,
+// builds a scenarios x symbols matrix of price returns and evaluates all
+// scenarios as vectorized dot products (rows split across a persistent
+// worker pool). Per-scenario P&L and returns are published via a seqlock so
+// check_order() can re-price every scenario with a trade, without locking.
+// For single-symbol trades each symbol also gets the upper envelope of its
+// scenario loss lines (loss_s(x) = -pnl_s - return_s * x), so a single-leg
+// check is a binary search over the few scenarios that can bind instead of
+// a scan of all of them.
+//
+// Scenario rows come from three sources:
+//   - Custom scenarios (driver move + correlation, explicit per-symbol moves)
+//   - Factor grids: driver shocked over a +/- grid at several correlations
+//   - Seeded one-factor Monte Carlo draws scaled by per-symbol volatility
+class ScenarioEngine {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+    using ExposureSource = std::function<void(std::vector<double>&)>;  // Signed notional by SymbolId
+
+    struct Config {
+        size_t max_symbols;                     // Capacity (indexed by SymbolId)
+        size_t monte_carlo_scenarios;           // 0 = custom/grid scenarios only
+        double monte_carlo_correlation;         // Loading on the common market factor
+        double stress_multiplier;               // Volatility scale for Monte Carlo tails
+        double default_volatility;              // Horizon vol when no VaR estimate exists
+        double horizon_samples;                 // VaR-engine intervals per stress horizon
+        uint64_t seed;                          // Deterministic Monte Carlo draws
+        std::chrono::milliseconds interval;
+        int worker_threads;                     // Threads evaluating rows (>= 1)
+        int risk_core;                          // CPU to pin scenario thread (-1 = none)
+
+        Config()
+            : max_symbols(256)
+            , monte_carlo_scenarios(2048)
+            , monte_carlo_correlation(0.6)
+            , stress_multiplier(3.0)
+            , default_volatility(0.02)
+            , horizon_samples(300.0)            // 5 minutes of 1s samples
+            , seed(42)
+            , interval(std::chrono::milliseconds(5000))
+            , worker_threads(2)
+            , risk_core(-1)
+        {}
+    };
+
+    // Driver symbol moves by driver_return; every other symbol moves by
+    // correlation * (vol_i / vol_driver) * driver_return. Overrides win.
+    struct StressScenario {
+        std::string name;
+        SymbolId driver;                        // INVALID_SYMBOL = overrides only
+        double driver_return;                   // e.g. -0.05 = 5% drop
+        double correlation;
+        std::vector<std::pair<SymbolId, double>> overrides;
+
+        StressScenario()
+            : driver(SymbolRegistry::INVALID_SYMBOL)
+            , driver_return(0.0)
+            , correlation(0.0)
+        {}
+    };
+
+    explicit ScenarioEngine(ExposureSource exposure_source,
+                            const PortfolioVarEngine* var_engine = nullptr,
+                            const Config& config = Config())
+        : config_(config)
+        , stride_((config.max_symbols + 3) & ~size_t(3))
+        , exposure_source_(std::move(exposure_source))
+        , var_engine_(var_engine)
+        , exposure_(stride_, 0.0)
+        , sigma_(stride_, 0.0)
+        , worst_shock_(config.max_symbols)
+    {
+        if (config.max_symbols == 0) {
+            throw std::invalid_argument("ScenarioEngine max_symbols must be > 0");
+        }
+
+        for (auto& shock : worst_shock_) {
+            shock.store(0.0, std::memory_order_relaxed);
+        }
+
+        generate_monte_carlo_draws();
+
+        for (int w = 1; w < config_.worker_threads; ++w) {
+            helpers_.emplace_back([this, w] { helper_loop(static_cast<size_t>(w)); });
+        }
+    }
+
+    ~ScenarioEngine() {
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            pool_stop_ = true;
+        }
+        pool_cv_.notify_all();
+        for (auto& helper : helpers_) {
+            helper.join();
+        }
+    }
+
+    ScenarioEngine(const ScenarioEngine&) = delete;
+    ScenarioEngine& operator=(const ScenarioEngine&) = delete;
+
+    // ===== Scenario setup (call before the first step() / start()) =====
+
+    void add_scenario(StressScenario scenario) {
+        check_setup_open();
+        scenarios_.push_back(std::move(scenario));
+    }
+
+    // Driver shocked over +/- max_shock in `steps` increments per side,
+    // at correlations {0, 0.5, 0.8, 1.0} to the rest of the book
+    void add_factor_grid(SymbolId driver, double max_shock = 0.10, int steps = 5) {
+        static constexpr double correlations[] = {0.0, 0.5, 0.8, 1.0};
+        check_setup_open();
+        std::string driver_name(get_symbol_name(driver));
+
+        for (int k = -steps; k <= steps; ++k) {
+            if (k == 0) continue;
+            double shock = max_shock * static_cast<double>(k) / static_cast<double>(steps);
+
+            for (double rho : correlations) {
+                StressScenario scenario;
+                scenario.name = driver_name + " " + std::to_string(shock * 100.0) +
+                                "% rho=" + std::to_string(rho);
+                scenario.driver = driver;
+                scenario.driver_return = shock;
+                scenario.correlation = rho;
+                scenarios_.push_back(std::move(scenario));
+            }
+        }
+    }
+
+    size_t scenario_count() const {
+        return scenarios_.size() + config_.monte_carlo_scenarios;
+    }
+
+    std::string scenario_name(size_t index) const {
+        if (index < scenarios_.size()) return scenarios_[index].name;
+        return "MonteCarlo#" + std::to_string(index - scenarios_.size());
+    }
+
+    // ===== Lock-free snapshot readers =====
+
+    // Largest loss across all scenarios (positive number, 0 = no loss)
+    double worst_loss() const {
+        return worst_loss_.load(std::memory_order_acquire);
+    }
+
+    size_t worst_scenario() const {
+        return worst_index_.load(std::memory_order_acquire);
+    }
+
+    // Return applied to symbol in the worst scenario
+    double worst_shock(SymbolId id) const {
+        if (id >= config_.max_symbols) return 0.0;
+        return worst_shock_[id].load(std::memory_order_relaxed);
+    }
+
+    // Worst-case loss after adding signed notional to symbol
+    // O(log H) in the H scenarios on the symbol's loss envelope
+    double loss_after_trade(SymbolId id, double signed_notional) const {
+        if (id >= config_.max_symbols) {
+            return worst_loss();
+        }
+
+        while (true) {
+            uint64_t seq1 = sequence_.load(std::memory_order_acquire);
+            if (seq1 & 1) continue;  // Writer in progress
+
+            double worst = 0.0;
+            size_t hull_size = published_count_.load(std::memory_order_relaxed) > 0
+                ? published_hull_size_[id].load(std::memory_order_relaxed) : 0;
+            if (hull_size > 0) {
+                const std::atomic<double>* slopes = published_hull_slope_.get() + id * published_rows_;
+                const std::atomic<double>* intercepts = published_hull_intercept_.get() + id * published_rows_;
+                auto loss = [&](size_t k) {
+                    return intercepts[k].load(std::memory_order_relaxed) +
+                           slopes[k].load(std::memory_order_relaxed) * signed_notional;
+                };
+
+                // Lines by ascending slope: the binding one is the first that
+                // is no lower than its successor at x
+                size_t lo = 0, hi = hull_size - 1;
+                while (lo < hi) {
+                    size_t mid = (lo + hi) / 2;
+                    if (loss(mid) >= loss(mid + 1)) {
+                        hi = mid;
+                    } else {
+                        lo = mid + 1;
+                    }
+                }
+                worst = std::max(0.0, loss(lo));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == seq1) {
+                return worst;
+            }
+        }
+    }
+
+    // Worst-case loss after a group of trades: every scenario is re-priced
+    // (its P&L plus the trades at its returns) and the largest loss wins -
+    // a trade can make a different scenario the worst one. A single trade
+    // takes the envelope path (loss_after_trade).
+    double loss_after_trades(std::span<const NotionalDelta> trades) const {
+        if (trades.size() == 1) {
+            return loss_after_trade(trades[0].symbol, trades[0].signed_notional);
+        }
+
+        while (true) {
+            uint64_t seq1 = sequence_.load(std::memory_order_acquire);
+            if (seq1 & 1) continue;  // Writer in progress
+
+            size_t count = published_count_.load(std::memory_order_relaxed);
+            double worst = 0.0;
+            for (size_t s = 0; s < count; ++s) {
+                double pnl = published_pnl_[s].load(std::memory_order_relaxed);
+                const std::atomic<double>* row = published_returns_.get() + s * stride_;
+                for (const auto& trade : trades) {
+                    if (trade.symbol < config_.max_symbols) {
+                        pnl += row[trade.symbol].load(std::memory_order_relaxed) * trade.signed_notional;
+                    }
+                }
+                worst = std::max(worst, -pnl);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == seq1) {
+                return worst;
+            }
+        }
+    }
+
+    uint64_t evaluations() const {
+        return evaluations_.load(std::memory_order_relaxed);
+    }
+
+    // ===== Scenario thread =====
+
+    void start() {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        worker_ = std::thread([this] { run(); });
+
+#if defined(__linux__)
+        if (config_.risk_core >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.risk_core, &cpuset);
+            pthread_setaffinity_np(worker_.native_handle(), sizeof(cpu_set_t), &cpuset);
+        }
+#endif
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // One evaluation pass - used by the scenario thread, callable directly
+    // when the caller drives its own scheduling (backtests, replay)
+    void step() {
+        // 1. Snapshot exposures (zero-padded to the full row width). Rows cover
+        //    every symbol, held or not, so a first trade in a symbol is shocked.
+        exposure_.clear();
+        exposure_source_(exposure_);
+        size_t held = std::min(exposure_.size(), config_.max_symbols);
+        exposure_.resize(stride_, 0.0);
+        std::fill(exposure_.begin() + held, exposure_.end(), 0.0);
+        size_t n = config_.max_symbols;
+        size_t width = stride_;
+
+        // 2. Per-symbol horizon volatility
+        double horizon_scale = std::sqrt(config_.horizon_samples);
+        for (size_t i = 0; i < n; ++i) {
+            double vol = var_engine_ ? var_engine_->volatility(static_cast<SymbolId>(i)) : 0.0;
+            sigma_[i] = vol > 0.0 ? vol * horizon_scale : config_.default_volatility;
+        }
+
+        // 3. Build + evaluate rows in parallel chunks (this thread takes chunk 0)
+        size_t total = scenario_count();
+        matrix_.resize(total * stride_);
+        pnl_.resize(total);
+        allocate_published(total);
+
+        size_t workers = helpers_.size() + 1;
+        size_t chunk = (std::max<size_t>(1, total) + workers - 1) / workers;
+
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            job_ = RowJob{total, chunk, n, width};
+            pool_pending_ = helpers_.size();
+            ++pool_generation_;
+        }
+        pool_cv_.notify_all();
+
+        evaluate_rows(0, std::min(total, chunk), n, width);
+
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            pool_done_cv_.wait(lock, [this] { return pool_pending_ == 0; });
+        }
+
+        // 4. Worst case
+        size_t worst = 0;
+        for (size_t s = 1; s < total; ++s) {
+            if (pnl_[s] < pnl_[worst]) worst = s;
+        }
+
+        build_hulls(n, total);
+        publish(total > 0 ? worst : 0, total > 0 ? std::max(0.0, -pnl_[worst]) : 0.0, n, total);
+        evaluations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    Config config_;
+    size_t stride_;
+
+    ExposureSource exposure_source_;
+    const PortfolioVarEngine* var_engine_;
+    std::vector<StressScenario> scenarios_;
+
+    // Scenario thread state (single writer)
+    std::vector<double> monte_carlo_draws_;     // Unit one-factor draws, rows of stride_
+    std::vector<double> exposure_;
+    std::vector<double> sigma_;
+    std::vector<double> matrix_;                // Scenario returns, rows of stride_
+    std::vector<double> pnl_;
+    std::vector<uint32_t> hull_order_;          // Scenario indices sorted per symbol
+    std::vector<double> hull_slope_;            // Per symbol: total entries, first hull_size_ used
+    std::vector<double> hull_intercept_;
+    std::vector<uint32_t> hull_size_;
+
+    // Published snapshot (seqlock)
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<double> worst_loss_{0.0};
+    std::atomic<size_t> worst_index_{0};
+    std::vector<std::atomic<double>> worst_shock_;
+    std::atomic<size_t> published_count_{0};
+    std::unique_ptr<std::atomic<double>[]> published_pnl_;      // Per scenario
+    std::unique_ptr<std::atomic<double>[]> published_returns_;  // Scenario rows of stride_
+    size_t published_rows_ = 0;                                 // Scenario capacity per symbol
+    std::unique_ptr<std::atomic<double>[]> published_hull_slope_;       // Symbol i at i * rows
+    std::unique_ptr<std::atomic<double>[]> published_hull_intercept_;
+    std::unique_ptr<std::atomic<uint32_t>[]> published_hull_size_;      // Per symbol
+    std::atomic<uint64_t> evaluations_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+
+    // Persistent row workers: helper w evaluates chunk w of each step
+    struct RowJob {
+        size_t total;
+        size_t chunk;
+        size_t n;
+        size_t width;
+    };
+
+    std::vector<std::thread> helpers_;
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    std::condition_variable pool_done_cv_;
+    RowJob job_{};
+    uint64_t pool_generation_ = 0;
+    size_t pool_pending_ = 0;
+    bool pool_stop_ = false;
+
+    void helper_loop(size_t index) {
+        uint64_t seen = 0;
+        while (true) {
+            RowJob job;
+            {
+                std::unique_lock<std::mutex> lock(pool_mutex_);
+                pool_cv_.wait(lock, [&] { return pool_stop_ || pool_generation_ != seen; });
+                if (pool_stop_) return;
+                seen = pool_generation_;
+                job = job_;
+            }
+
+            size_t begin = index * job.chunk;
+            size_t end = std::min(job.total, begin + job.chunk);
+            if (begin < end) {
+                evaluate_rows(begin, end, job.n, job.width);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex_);
+                if (--pool_pending_ == 0) {
+                    pool_done_cv_.notify_one();
+                }
+            }
+        }
+    }
+
+    void check_setup_open() const {
+        if (published_pnl_) {
+            throw std::logic_error("ScenarioEngine scenarios must be added before the first step");
+        }
+    }
+
+    // Snapshot buffers are sized once (readers never see them move)
+    void allocate_published(size_t total) {
+        if (published_pnl_) return;
+
+        size_t rows = std::max<size_t>(1, total);
+        published_rows_ = rows;
+        published_pnl_ = std::make_unique<std::atomic<double>[]>(rows);
+        published_returns_ = std::make_unique<std::atomic<double>[]>(rows * stride_);
+        published_hull_slope_ = std::make_unique<std::atomic<double>[]>(rows * config_.max_symbols);
+        published_hull_intercept_ = std::make_unique<std::atomic<double>[]>(rows * config_.max_symbols);
+        published_hull_size_ = std::make_unique<std::atomic<uint32_t>[]>(config_.max_symbols);
+        for (size_t i = 0; i < rows; ++i) {
+            published_pnl_[i].store(0.0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < rows * stride_; ++i) {
+            published_returns_[i].store(0.0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < config_.max_symbols; ++i) {
+            published_hull_size_[i].store(0, std::memory_order_relaxed);
+        }
+
+        hull_order_.resize(rows);
+        hull_slope_.resize(rows * config_.max_symbols);
+        hull_intercept_.resize(rows * config_.max_symbols);
+        hull_size_.assign(config_.max_symbols, 0);
+    }
+
+    // Upper envelope of each symbol's loss lines -pnl_s - r_s * x (monotone
+    // hull: ascending slope, a line is dropped once its neighbours cover it)
+    void build_hulls(size_t n, size_t total) {
+        for (size_t i = 0; i < n; ++i) {
+            auto slope = [&](uint32_t s) { return -matrix_[s * stride_ + i]; };
+            auto intercept = [&](uint32_t s) { return -pnl_[s]; };
+
+            for (size_t s = 0; s < total; ++s) hull_order_[s] = static_cast<uint32_t>(s);
+            std::sort(hull_order_.begin(), hull_order_.begin() + total, [&](uint32_t a, uint32_t b) {
+                double ma = slope(a), mb = slope(b);
+                return ma < mb || (ma == mb && intercept(a) < intercept(b));
+            });
+
+            double* m = hull_slope_.data() + i * published_rows_;
+            double* c = hull_intercept_.data() + i * published_rows_;
+            size_t h = 0;
+            for (size_t k = 0; k < total; ++k) {
+                double m3 = slope(hull_order_[k]);
+                double c3 = intercept(hull_order_[k]);
+                // Same slope: sorted by intercept, so the later line dominates
+                if (h > 0 && m[h - 1] == m3) --h;
+                while (h >= 2) {
+                    double m1 = m[h - 2], c1 = c[h - 2], m2 = m[h - 1], c2 = c[h - 1];
+                    // Line 2 never binds once line 3 overtakes line 1 no later than line 2 does
+                    if ((c1 - c3) * (m2 - m1) <= (c1 - c2) * (m3 - m1)) {
+                        --h;
+                    } else {
+                        break;
+                    }
+                }
+                m[h] = m3;
+                c[h] = c3;
+                ++h;
+            }
+            hull_size_[i] = static_cast<uint32_t>(h);
+        }
+    }
+
+    void run() {
+        auto next = Clock::now();
+        while (running_.load(std::memory_order_acquire)) {
+            next += config_.interval;
+            std::this_thread::sleep_until(next);
+            step();
+        }
+    }
+
+    // z_i = rho * market + sqrt(1 - rho^2) * idiosyncratic_i
+    void generate_monte_carlo_draws() {
+        monte_carlo_draws_.assign(config_.monte_carlo_scenarios * stride_, 0.0);
+
+        std::mt19937_64 rng(config_.seed);
+        std::normal_distribution<double> normal(0.0, 1.0);
+
+        double rho = std::clamp(config_.monte_carlo_correlation, 0.0, 1.0);
+        double idio = std::sqrt(1.0 - rho * rho);
+
+        for (size_t s = 0; s < config_.monte_carlo_scenarios; ++s) {
+            double market = normal(rng);
+            double* row = monte_carlo_draws_.data() + s * stride_;
+            for (size_t i = 0; i < config_.max_symbols; ++i) {
+                row[i] = rho * market + idio * normal(rng);
+            }
+        }
+    }
+
+    void evaluate_rows(size_t begin, size_t end, size_t n, size_t width) {
+        for (size_t s = begin; s < end; ++s) {
+            double* row = matrix_.data() + s * stride_;
+            build_row(s, row, n, width);
+            pnl_[s] = dot(row, exposure_.data(), width);
+        }
+    }
+
+    void build_row(size_t s, double* row, size_t n, size_t width) const {
+        std::fill(row, row + width, 0.0);
+
+        if (s >= scenarios_.size()) {
+            const double* draws = monte_carlo_draws_.data() + (s - scenarios_.size()) * stride_;
+            const double scale = config_.stress_multiplier;
+            for (size_t i = 0; i < n; ++i) {
+                row[i] = scale * sigma_[i] * draws[i];
+            }
+            return;
+        }
+
+        const auto& scenario = scenarios_[s];
+        if (scenario.driver != SymbolRegistry::INVALID_SYMBOL && scenario.driver < n) {
+            double driver_sigma = sigma_[scenario.driver];
+            double beta_unit = scenario.correlation * scenario.driver_return /
+                               (driver_sigma > 0.0 ? driver_sigma : 1.0);
+            for (size_t i = 0; i < n; ++i) {
+                row[i] = driver_sigma > 0.0 ? beta_unit * sigma_[i]
+                                            : scenario.correlation * scenario.driver_return;
+            }
+            row[scenario.driver] = scenario.driver_return;
+        }
+
+        for (const auto& [id, move] : scenario.overrides) {
+            if (id < n) row[id] = move;
+        }
+    }
+
+    static double dot(const double* __restrict a, const double* __restrict b, size_t n) {
+        size_t i = 0;
+        double total = 0.0;
+#if defined(__AVX2__)
+        __m256d acc = _mm256_setzero_pd();
+        for (; i + 4 <= n; i += 4) {
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, acc);
+        total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+        for (; i < n; ++i) {
+            total += a[i] * b[i];
+        }
+        return total;
+    }
+
+    void publish(size_t worst, double loss, size_t n, size_t total) {
+        const double* row = matrix_.empty() ? nullptr : matrix_.data() + worst * stride_;
+
+        sequence_.fetch_add(1, std::memory_order_acq_rel);  // Odd: write in progress
+
+        worst_loss_.store(loss, std::memory_order_relaxed);
+        worst_index_.store(worst, std::memory_order_relaxed);
+        for (size_t i = 0; i < config_.max_symbols; ++i) {
+            worst_shock_[i].store(row && i < n ? row[i] : 0.0, std::memory_order_relaxed);
+        }
+
+        for (size_t s = 0; s < total; ++s) {
+            published_pnl_[s].store(pnl_[s], std::memory_order_relaxed);
+            const double* returns = matrix_.data() + s * stride_;
+            std::atomic<double>* out = published_returns_.get() + s * stride_;
+            for (size_t i = 0; i < n; ++i) {
+                out[i].store(returns[i], std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t h = hull_size_[i];
+            const double* m = hull_slope_.data() + i * published_rows_;
+            const double* c = hull_intercept_.data() + i * published_rows_;
+            std::atomic<double>* m_out = published_hull_slope_.get() + i * published_rows_;
+            std::atomic<double>* c_out = published_hull_intercept_.get() + i * published_rows_;
+            for (size_t k = 0; k < h; ++k) {
+                m_out[k].store(m[k], std::memory_order_relaxed);
+                c_out[k].store(c[k], std::memory_order_relaxed);
+            }
+            published_hull_size_[i].store(static_cast<uint32_t>(h), std::memory_order_relaxed);
+        }
+        published_count_.store(total, std::memory_order_relaxed);
+
+        sequence_.fetch_add(1, std::memory_order_release);  // Even: consistent
+    }
+};
+
+} // namespace trading
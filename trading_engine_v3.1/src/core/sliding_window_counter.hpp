@@ -0,0 +1,190 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace trading {
+
+// Sliding-window event counter - fixed time buckets, lock-free, allocation-free
+// after construction.
+//
+// The window is split into num_buckets buckets of window/num_buckets each.
+// Every bucket is one atomic word packing (epoch << COUNT_BITS) | count, so a
+// stale bucket is recycled by the first writer that lands in its new epoch.
+// A running total tracks the window: add() increments it, and whoever moves
+// the window forward (add or count) zeroes the buckets that fell out and
+// decrements it, each bucket once per rotation. add() is a CAS or two and
+// count() is O(1) amortized. Resolution is one bucket: events age out in
+// bucket-sized steps. A writer racing a rotation with a timestamp that has
+// just aged out can be counted until its bucket is next recycled (at most
+// one window) - the count errs high, never low.
+class SlidingWindowCounter {
+public:
+    static constexpr unsigned COUNT_BITS = 24;
+    static constexpr uint64_t COUNT_MASK = (uint64_t(1) << COUNT_BITS) - 1;
+
+    explicit SlidingWindowCounter(std::chrono::nanoseconds window = std::chrono::seconds(1),
+                                  size_t num_buckets = 10)
+        : num_buckets_(num_buckets)
+        , bucket_ns_(window.count() / static_cast<int64_t>(num_buckets ? num_buckets : 1))
+        , window_seconds_(std::chrono::duration<double>(window).count())
+        , base_(Clock::now())
+        , buckets_(std::make_unique<Bucket[]>(num_buckets))
+    {
+        if (num_buckets == 0 || bucket_ns_ <= 0) {
+            throw std::invalid_argument("SlidingWindowCounter needs a positive window and buckets");
+        }
+        clear();
+    }
+
+    SlidingWindowCounter(const SlidingWindowCounter&) = delete;
+    SlidingWindowCounter& operator=(const SlidingWindowCounter&) = delete;
+
+    // Record n events at now
+    void add(uint64_t n = 1, TimePoint now = Clock::now()) {
+        record(n, epoch_of(now));
+    }
+
+    // Record n events only if the window then holds at most limit. The events
+    // are added first and backed out on overshoot, so concurrent callers can
+    // never take the count past limit together (at the limit, both may refuse).
+    bool try_add(uint64_t n, uint64_t limit, TimePoint now = Clock::now()) {
+        uint64_t epoch = epoch_of(now);
+        if (!record(n, epoch)) {
+            return false;
+        }
+        if (count(now) > limit) {
+            unrecord(n, epoch);
+            return false;
+        }
+        return true;
+    }
+
+    // Take back n events recorded by add()/try_add() at the same now
+    // (e.g. a later check refused the order they were counted for)
+    void remove(uint64_t n, TimePoint now = Clock::now()) {
+        unrecord(n, epoch_of(now));
+    }
+
+    // Events within the window ending at now
+    uint64_t count(TimePoint now = Clock::now()) const {
+        advance(epoch_of(now));
+        return static_cast<uint64_t>(std::max<int64_t>(total_.load(std::memory_order_seq_cst), 0));
+    }
+
+    // Events per second over the window
+    double rate(TimePoint now = Clock::now()) const {
+        return static_cast<double>(count(now)) / window_seconds_;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            buckets_[i].word.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        head_epoch_.store(0, std::memory_order_relaxed);
+    }
+
+    double window_seconds() const { return window_seconds_; }
+
+private:
+    // Separate cache lines: concurrent writers hit the same bucket anyway,
+    // but readers sweeping the window shouldn't false-share with them
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> word{0};
+    };
+
+    size_t num_buckets_;
+    int64_t bucket_ns_;
+    double window_seconds_;
+    TimePoint base_;                    // Epochs count from construction (fits 40 bits)
+    std::unique_ptr<Bucket[]> buckets_;
+    mutable std::atomic<int64_t> total_{0};         // Events in buckets not yet aged out
+    mutable std::atomic<uint64_t> head_epoch_{0};   // Newest epoch the window has moved to
+
+    // Add n to epoch's bucket, recycling it if it holds an older epoch.
+    // false = the bucket has already moved past epoch (nothing recorded).
+    bool record(uint64_t n, uint64_t epoch) {
+        advance(epoch);
+        if (epoch + num_buckets_ <= head_epoch_.load(std::memory_order_seq_cst)) {
+            return false;  // Already outside the window
+        }
+
+        auto& word = buckets_[epoch % num_buckets_].word;
+
+        uint64_t current = word.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t current_epoch = current >> COUNT_BITS;
+            if (current_epoch > epoch) {
+                return false;  // Caller's timestamp already aged out of this bucket
+            }
+
+            uint64_t previous = current & COUNT_MASK;
+            uint64_t count = current_epoch == epoch ? previous : 0;
+            count = std::min(count + n, COUNT_MASK);  // Saturate, never bleed into epoch
+
+            uint64_t desired = (epoch << COUNT_BITS) | count;
+            if (word.compare_exchange_weak(current, desired, std::memory_order_seq_cst)) {
+                // Recycling drops the old epoch's events from the total
+                total_.fetch_add(static_cast<int64_t>(count) - static_cast<int64_t>(previous),
+                                 std::memory_order_seq_cst);
+                return true;
+            }
+        }
+    }
+
+    // Subtract up to n from epoch's bucket (no-op once it has been recycled)
+    void unrecord(uint64_t n, uint64_t epoch) {
+        auto& word = buckets_[epoch % num_buckets_].word;
+
+        uint64_t current = word.load(std::memory_order_relaxed);
+        while ((current >> COUNT_BITS) == epoch) {
+            uint64_t count = current & COUNT_MASK;
+            uint64_t removed = std::min(count, n);
+            uint64_t desired = (epoch << COUNT_BITS) | (count - removed);
+            if (word.compare_exchange_weak(current, desired, std::memory_order_seq_cst)) {
+                total_.fetch_sub(static_cast<int64_t>(removed), std::memory_order_seq_cst);
+                return;
+            }
+        }
+    }
+
+    // Move the window to end at epoch: the thread that moves head_epoch_
+    // zeroes the buckets whose epochs fell out (at most num_buckets words,
+    // one per elapsed bucket) and takes their events off the total
+    void advance(uint64_t epoch) const {
+        uint64_t head = head_epoch_.load(std::memory_order_seq_cst);
+        while (epoch > head) {
+            if (!head_epoch_.compare_exchange_weak(head, epoch, std::memory_order_seq_cst)) {
+                continue;
+            }
+
+            uint64_t oldest = epoch >= num_buckets_ ? epoch - num_buckets_ + 1 : 0;
+            uint64_t steps = std::min<uint64_t>(epoch - head, num_buckets_);
+            for (uint64_t k = 0; k < steps; ++k) {
+                auto& word = buckets_[(head + 1 + k) % num_buckets_].word;
+                uint64_t current = word.load(std::memory_order_relaxed);
+                while ((current >> COUNT_BITS) < oldest && (current & COUNT_MASK) != 0) {
+                    uint64_t stale = current & COUNT_MASK;
+                    if (word.compare_exchange_weak(current, current & ~COUNT_MASK,
+                                                   std::memory_order_seq_cst)) {
+                        total_.fetch_sub(static_cast<int64_t>(stale), std::memory_order_seq_cst);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    // Epoch 0 is reserved for "never written"
+    uint64_t epoch_of(TimePoint now) const {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - base_).count();
+        return static_cast<uint64_t>(std::max<int64_t>(ns, 0) / bucket_ns_) + 1;
+    }
+};
+
+} // namespace trading
@@ -1,20 +1,56 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
-#include <mutex>
-#include <cstdint>
+#include <vector>
 
 namespace trading {
 
+// Symbols known at compile time - registered first, so their IDs are fixed
+// (index + 1) and usable as constants without touching the registry
+inline constexpr std::array<std::string_view, 18> COMMON_SYMBOLS = {
+    // Major pairs
+    "BTCUSDT", "ETHUSDT", "BNBUSDT", "SOLUSDT", "XRPUSDT",
+    "ADAUSDT", "AVAXUSDT", "DOGEUSDT", "DOTUSDT", "MATICUSDT",
+    "LINKUSDT", "UNIUSDT", "ATOMUSDT", "LTCUSDT", "ETCUSDT",
+    
+    // Cross pairs
+    "ETHBTC", "BNBBTC", "SOLBTC"
+};
+
+// FNV-1a over the raw bytes (constexpr so common-symbol lookups fold)
+constexpr uint64_t symbol_hash(std::string_view symbol) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : symbol) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 // String interning - convert strings to integer IDs for fast comparison
 // All symbol operations use IDs, not strings
+//
+// Reads are lock-free: ID -> name is a dense array of published entries and
+// name -> ID is an open-addressing table probed with string_view (no
+// temporary std::string). Writers serialize on a mutex, fill an entry, then
+// publish it with a release store; a full table is rebuilt at twice the
+// size and swapped in RCU-style. Entries and old tables are never freed
+// (the registry lives for the process), so readers need no grace period.
 class SymbolRegistry {
 public:
     using SymbolId = uint16_t;
     static constexpr SymbolId INVALID_SYMBOL = 0;
+    static constexpr size_t MAX_SYMBOLS = 8192;
     
     static SymbolRegistry& instance() {
         static SymbolRegistry registry;
@@ -23,74 +59,187 @@ public:
     
     // Register symbol and get ID (idempotent)
     SymbolId register_symbol(std::string_view symbol) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        SymbolId existing = get_id(symbol);
+        if (existing != INVALID_SYMBOL || symbol.empty()) {
+            return existing;
+        }
         
-        // Check if already registered
-        auto it = symbol_to_id_.find(std::string(symbol));
-        if (it != symbol_to_id_.end()) {
-            return it->second;
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        
+        // Re-check under the writer lock (another writer may have won)
+        existing = get_id(symbol);
+        if (existing != INVALID_SYMBOL) {
+            return existing;
+        }
+        
+        size_t id = count_.load(std::memory_order_relaxed) + 1;
+        if (id >= MAX_SYMBOLS) {
+            throw std::length_error("SymbolRegistry full");
         }
         
-        // Assign new ID
-        SymbolId id = next_id_++;
-        std::string symbol_str(symbol);
+        // Grow first: the rebuilt table holds only entries already published
+        const HashTable* table = table_.load(std::memory_order_relaxed);
+        if ((id + 1) * 2 > table->capacity()) {
+            table = grow(*table);
+        }
         
-        symbol_to_id_[symbol_str] = id;
-        id_to_symbol_[id] = std::move(symbol_str);
+        const Entry& entry = entries_.emplace_back(std::string(symbol), symbol_hash(symbol),
+                                                   static_cast<SymbolId>(id));
         
-        return id;
+        // ID -> name before name -> ID: a reader that finds the ID can
+        // always resolve it back
+        names_[id].store(&entry, std::memory_order_release);
+        count_.store(id, std::memory_order_release);
+        insert(*table, &entry);
+        
+        return entry.id;
     }
     
-    // Get ID for symbol (returns INVALID_SYMBOL if not registered)
+    // Get ID for symbol (returns INVALID_SYMBOL if not registered) - lock-free
     SymbolId get_id(std::string_view symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        const HashTable* table = table_.load(std::memory_order_acquire);
+        uint64_t hash = symbol_hash(symbol);
         
-        auto it = symbol_to_id_.find(std::string(symbol));
-        return it != symbol_to_id_.end() ? it->second : INVALID_SYMBOL;
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            const Entry* entry = table->slots[i].load(std::memory_order_acquire);
+            if (!entry) {
+                return INVALID_SYMBOL;
+            }
+            if (entry->hash == hash && entry->name == symbol) {
+                return entry->id;
+            }
+        }
     }
     
-    // Get symbol for ID (returns empty string_view if invalid)
+    // Get symbol for ID (returns empty string_view if invalid) - lock-free
     std::string_view get_symbol(SymbolId id) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        auto it = id_to_symbol_.find(id);
-        return it != id_to_symbol_.end() ? std::string_view(it->second) : std::string_view();
+        if (id >= MAX_SYMBOLS) return std::string_view();
+        const Entry* entry = names_[id].load(std::memory_order_acquire);
+        return entry ? std::string_view(entry->name) : std::string_view();
     }
     
     // Check if symbol is registered
     bool is_registered(std::string_view symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return symbol_to_id_.count(std::string(symbol)) > 0;
+        return get_id(symbol) != INVALID_SYMBOL;
     }
     
-    // Get all registered symbols
+    // Get all registered symbols (in ID order)
     std::vector<std::string> get_all_symbols() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        size_t n = count();
         
         std::vector<std::string> symbols;
-        symbols.reserve(symbol_to_id_.size());
+        symbols.reserve(n);
         
-        for (const auto& [symbol, id] : symbol_to_id_) {
-            symbols.push_back(symbol);
+        for (size_t id = 1; id <= n; ++id) {
+            symbols.emplace_back(get_symbol(static_cast<SymbolId>(id)));
         }
         
         return symbols;
     }
     
     size_t count() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return symbol_to_id_.size();
+        return count_.load(std::memory_order_acquire);
+    }
+    
+    // Occupied slots in the current name -> ID table (equals count())
+    size_t table_size() const {
+        const HashTable* table = table_.load(std::memory_order_acquire);
+        size_t occupied = 0;
+        for (size_t i = 0; i < table->capacity(); ++i) {
+            occupied += table->slots[i].load(std::memory_order_relaxed) != nullptr;
+        }
+        return occupied;
     }
     
 private:
-    SymbolRegistry() : next_id_(1) {}  // Start from 1, reserve 0 for invalid
+    struct Entry {
+        std::string name;
+        uint64_t hash;
+        SymbolId id;
+        
+        Entry(std::string n, uint64_t h, SymbolId i) : name(std::move(n)), hash(h), id(i) {}
+    };
+    
+    struct HashTable {
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+        
+        explicit HashTable(size_t capacity)  // Power of two
+            : mask(capacity - 1)
+            , slots(std::make_unique<std::atomic<const Entry*>[]>(capacity))
+        {
+            for (size_t i = 0; i < capacity; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        
+        size_t capacity() const { return mask + 1; }
+    };
+    
+    SymbolRegistry() {  // ID 0 reserved for invalid
+        for (auto& name : names_) {
+            name.store(nullptr, std::memory_order_relaxed);
+        }
+        tables_.push_back(std::make_unique<HashTable>(64));
+        table_.store(tables_.back().get(), std::memory_order_release);
+        
+        for (std::string_view symbol : COMMON_SYMBOLS) {
+            register_symbol(symbol);
+        }
+    }
+    
+    // Writer side (write_mutex_ held)
+    static void insert(const HashTable& table, const Entry* entry) {
+        size_t i = entry->hash & table.mask;
+        while (table.slots[i].load(std::memory_order_relaxed)) {
+            i = (i + 1) & table.mask;
+        }
+        table.slots[i].store(entry, std::memory_order_release);
+    }
+    
+    const HashTable* grow(const HashTable& old) {
+        auto bigger = std::make_unique<HashTable>(old.capacity() * 2);
+        for (const auto& entry : entries_) {
+            insert(*bigger, &entry);
+        }
+        
+        // Publish; readers still probing the old table see a complete
+        // (just fuller) snapshot, which stays allocated
+        const HashTable* published = bigger.get();
+        tables_.push_back(std::move(bigger));
+        table_.store(published, std::memory_order_release);
+        return published;
+    }
+    
+    // Read side
+    std::array<std::atomic<const Entry*>, MAX_SYMBOLS> names_;
+    std::atomic<const HashTable*> table_{nullptr};
+    std::atomic<size_t> count_{0};
     
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, SymbolId> symbol_to_id_;
-    std::unordered_map<SymbolId, std::string> id_to_symbol_;
-    SymbolId next_id_;
+    // Write side
+    std::mutex write_mutex_;
+    std::deque<Entry> entries_;                         // Stable addresses
+    std::vector<std::unique_ptr<HashTable>> tables_;    // Current + retired generations
 };
 
+// ID of a compile-time common symbol (INVALID_SYMBOL if not in the list)
+constexpr SymbolRegistry::SymbolId common_symbol_id(std::string_view symbol) {
+    for (size_t i = 0; i < COMMON_SYMBOLS.size(); ++i) {
+        if (COMMON_SYMBOLS[i] == symbol) {
+            return static_cast<SymbolRegistry::SymbolId>(i + 1);
+        }
+    }
+    return SymbolRegistry::INVALID_SYMBOL;
+}
+
+namespace symbols {
+    inline constexpr SymbolRegistry::SymbolId BTCUSDT = common_symbol_id("BTCUSDT");
+    inline constexpr SymbolRegistry::SymbolId ETHUSDT = common_symbol_id("ETHUSDT");
+    inline constexpr SymbolRegistry::SymbolId SOLUSDT = common_symbol_id("SOLUSDT");
+    inline constexpr SymbolRegistry::SymbolId ETHBTC = common_symbol_id("ETHBTC");
+    inline constexpr SymbolRegistry::SymbolId SOLBTC = common_symbol_id("SOLBTC");
+}
+
 // Convenience functions
 inline SymbolRegistry::SymbolId register_symbol(std::string_view symbol) {
     return SymbolRegistry::instance().register_symbol(symbol);
@@ -104,29 +253,10 @@ inline std::string_view get_symbol_name(SymbolRegistry::SymbolId id) {
     return SymbolRegistry::instance().get_symbol(id);
 }
 
-// Pre-register common symbols at startup
+// Common symbols are registered when the registry is first used (fixed IDs);
+// kept so existing startup code still forces that initialization early
 inline void register_common_symbols() {
-    // Major pairs
-    register_symbol("BTCUSDT");
-    register_symbol("ETHUSDT");
-    register_symbol("BNBUSDT");
-    register_symbol("SOLUSDT");
-    register_symbol("XRPUSDT");
-    register_symbol("ADAUSDT");
-    register_symbol("AVAXUSDT");
-    register_symbol("DOGEUSDT");
-    register_symbol("DOTUSDT");
-    register_symbol("MATICUSDT");
-    register_symbol("LINKUSDT");
-    register_symbol("UNIUSDT");
-    register_symbol("ATOMUSDT");
-    register_symbol("LTCUSDT");
-    register_symbol("ETCUSDT");
-    
-    // Cross pairs
-    register_symbol("ETHBTC");
-    register_symbol("BNBBTC");
-    register_symbol("SOLBTC");
+    SymbolRegistry::instance();
 }
 
 // String view helper for hot paths
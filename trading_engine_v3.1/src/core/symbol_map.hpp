@@ -0,0 +1,162 @@
+#pragma once
+
+#include "string_interning.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+// SymbolMap - dense per-symbol container indexed by SymbolId
+// A flat vector of values plus a presence bitmap: lookup is an array index
+// and a bit test, iteration walks set bits in ID order. Grows on insert
+// (off the hot path once every symbol has been seen). Not thread-safe.
+template<typename T>
+class SymbolMap {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    template<bool Const>
+    class Iterator {
+    public:
+        using Map = std::conditional_t<Const, const SymbolMap, SymbolMap>;
+        using Ref = std::conditional_t<Const, const T&, T&>;
+        using value_type = std::pair<SymbolId, Ref>;
+
+        Iterator(Map* map, size_t index) : map_(map), index_(index) { skip(); }
+
+        value_type operator*() const {
+            return value_type(static_cast<SymbolId>(index_), map_->values_[index_]);
+        }
+
+        Iterator& operator++() {
+            ++index_;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+    private:
+        Map* map_;
+        size_t index_;
+
+        // Advance to the next set bit (word at a time)
+        void skip() {
+            size_t n = map_->values_.size();
+            while (index_ < n) {
+                uint64_t word = map_->present_[index_ >> 6] >> (index_ & 63);
+                if (word) {
+                    index_ += static_cast<size_t>(std::countr_zero(word));
+                    return;
+                }
+                index_ = (index_ | 63) + 1;
+            }
+            index_ = n;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SymbolMap() = default;
+
+    bool contains(SymbolId id) const {
+        return id < values_.size() && (present_[id >> 6] >> (id & 63)) & 1;
+    }
+
+    T* find(SymbolId id) {
+        return contains(id) ? &values_[id] : nullptr;
+    }
+
+    const T* find(SymbolId id) const {
+        return contains(id) ? &values_[id] : nullptr;
+    }
+
+    // String convenience (registry lookup, then index)
+    T* find(std::string_view symbol) { return find(get_symbol_id(symbol)); }
+    const T* find(std::string_view symbol) const { return find(get_symbol_id(symbol)); }
+
+    // Insert default if absent
+    T& operator[](SymbolId id) {
+        ensure(id);
+        mark(id);
+        return values_[id];
+    }
+
+    T& operator[](std::string_view symbol) {
+        return (*this)[register_symbol(symbol)];
+    }
+
+    template<typename... Args>
+    T& insert_or_assign(SymbolId id, Args&&... args) {
+        T& slot = (*this)[id];
+        slot = T(std::forward<Args>(args)...);
+        return slot;
+    }
+
+    // Value or fallback when absent
+    T get_or(SymbolId id, const T& fallback) const {
+        return contains(id) ? values_[id] : fallback;
+    }
+
+    bool erase(SymbolId id) {
+        if (!contains(id)) return false;
+        present_[id >> 6] &= ~(uint64_t(1) << (id & 63));
+        values_[id] = T();
+        --size_;
+        return true;
+    }
+
+    void clear() {
+        for (auto [id, value] : *this) {
+            value = T();
+        }
+        std::fill(present_.begin(), present_.end(), 0);
+        size_ = 0;
+    }
+
+    // Pre-size for ids < capacity (avoids growth on the hot path)
+    void reserve(size_t capacity) {
+        if (capacity > values_.size()) {
+            values_.resize(capacity);
+            present_.resize((capacity + 63) / 64, 0);
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return values_.size(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, values_.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, values_.size()); }
+
+private:
+    std::vector<T> values_;             // Indexed by SymbolId
+    std::vector<uint64_t> present_;     // Presence bitmap
+    size_t size_ = 0;
+
+    void ensure(SymbolId id) {
+        if (id >= values_.size()) {
+            reserve(std::max<size_t>(static_cast<size_t>(id) + 1, values_.size() * 2));
+        }
+    }
+
+    void mark(SymbolId id) {
+        uint64_t& word = present_[id >> 6];
+        uint64_t bit = uint64_t(1) << (id & 63);
+        if (!(word & bit)) {
+            word |= bit;
+            ++size_;
+        }
+    }
+};
+
+} // namespace trading
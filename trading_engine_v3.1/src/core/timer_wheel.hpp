@@ -0,0 +1,138 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+// Hierarchical timer wheel - O(1) schedule, O(1) amortized expiry
+//
+// LEVELS wheels of 64 slots; level l slots span 64^l ticks. A timer goes
+// into the lowest level whose range covers its delay and cascades down one
+// level each time the wheel below wraps, so every timer is touched at most
+// LEVELS times. Advancing skips stretches where the lower levels are empty.
+// Timers beyond the top level's range wait in its farthest slot and are
+// re-placed when it cascades. Not thread-safe.
+template<typename T>
+class TimerWheel {
+public:
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+    static constexpr size_t LEVELS = 4;
+
+    explicit TimerWheel(Nanoseconds tick = std::chrono::milliseconds(1), TimePoint start = Clock::now())
+        : tick_ns_(tick.count())
+        , current_(ticks(start))
+    {
+        if (tick_ns_ <= 0) {
+            throw std::invalid_argument("TimerWheel tick must be > 0");
+        }
+    }
+
+    // Fires at the first advance() past `deadline` (rounded up to a tick)
+    void schedule(TimePoint deadline, T value) {
+        uint64_t when = ticks(deadline);
+        if (deadline.time_since_epoch().count() % tick_ns_ != 0) ++when;
+        place(Entry{std::max(when, current_ + 1), std::move(value)});
+        ++size_;
+    }
+
+    // Expire every timer due at or before `now`: fire(T&) in deadline-tick order
+    template<typename Fire>
+    void advance(TimePoint now, Fire&& fire) {
+        uint64_t target = ticks(now);
+
+        while (current_ < target) {
+            if (size_ == 0) {
+                current_ = target;
+                return;
+            }
+
+            // Jump to just before the next tick that can hold work: the
+            // next cascade point of the lowest non-empty level
+            size_t level = 0;
+            while (level < LEVELS - 1 && level_size_[level] == 0) ++level;
+            if (level > 0) {
+                uint64_t mask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+                uint64_t next = (current_ | mask) + 1;
+                current_ = std::min(next, target) - 1;
+            }
+
+            ++current_;
+            cascade();
+
+            auto& slot = slots_[0][current_ & (SLOTS - 1)];
+            if (slot.empty()) continue;
+
+            // Swap out so fire() may schedule into this slot
+            due_.swap(slot);
+            level_size_[0] -= due_.size();
+            size_ -= due_.size();
+            for (auto& entry : due_) {
+                fire(entry.value);
+            }
+            due_.clear();
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Entry {
+        uint64_t deadline;              // Absolute tick
+        T value;
+    };
+
+    int64_t tick_ns_;
+    uint64_t current_;                  // Last processed tick
+    size_t size_ = 0;
+    std::array<size_t, LEVELS> level_size_{};
+    std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> slots_;
+    std::vector<Entry> due_;
+    std::vector<Entry> cascading_;
+
+    uint64_t ticks(TimePoint t) const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<Nanoseconds>(t.time_since_epoch()).count() / tick_ns_);
+    }
+
+    void place(Entry&& entry) {
+        uint64_t delta = entry.deadline - current_;
+        size_t level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) ++level;
+
+        // Beyond the top level: park in its farthest slot
+        uint64_t top_range = uint64_t(1) << (SLOT_BITS * LEVELS);
+        uint64_t at = delta < top_range ? entry.deadline : current_ + top_range - 1;
+
+        size_t slot = static_cast<size_t>((at >> (SLOT_BITS * level)) & (SLOTS - 1));
+        slots_[level][slot].push_back(std::move(entry));
+        ++level_size_[level];
+    }
+
+    // On entering a level-l boundary, redistribute that level's slot below
+    void cascade() {
+        for (size_t level = 1; level < LEVELS; ++level) {
+            uint64_t mask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+            if ((current_ & mask) != 0) return;
+
+            auto& slot = slots_[level][(current_ >> (SLOT_BITS * level)) & (SLOTS - 1)];
+            if (slot.empty()) continue;
+
+            cascading_.swap(slot);
+            level_size_[level] -= cascading_.size();
+            for (auto& entry : cascading_) {
+                place(std::move(entry));
+            }
+            cascading_.clear();
+        }
+    }
+};
+
+} // namespace trading
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Toxicity board - latest adverse selection score per symbol and per
+// (symbol, venue), indexed by SymbolId
+//
+// One cache line per symbol, so a markout on one symbol never invalidates
+// another's line. The markout engine publishes (single writer); quoting
+// threads read with relaxed loads, no locks. Capacity is fixed at
+// construction so readers never race a resize.
+class ToxicityBoard {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+
+    explicit ToxicityBoard(size_t max_symbols = 1024)
+        : cells_(max_symbols)
+    {
+        if (max_symbols == 0) {
+            throw std::invalid_argument("ToxicityBoard max_symbols must be > 0");
+        }
+    }
+
+    // Writer: one symbol/venue's score changed
+    void publish(SymbolId symbol, Venue venue, double venue_score, double symbol_score) {
+        if (symbol >= cells_.size()) return;
+
+        Cell& cell = cells_[symbol];
+        cell.venue[static_cast<size_t>(venue)].store(venue_score, std::memory_order_relaxed);
+        cell.symbol.store(symbol_score, std::memory_order_relaxed);
+    }
+
+    // 0-1, 0 for symbols never published
+    double toxicity(SymbolId symbol) const {
+        return symbol < cells_.size() ? cells_[symbol].symbol.load(std::memory_order_relaxed) : 0.0;
+    }
+
+    double toxicity(SymbolId symbol, Venue venue) const {
+        return symbol < cells_.size()
+            ? cells_[symbol].venue[static_cast<size_t>(venue)].load(std::memory_order_relaxed)
+            : 0.0;
+    }
+
+    size_t capacity() const { return cells_.size(); }
+
+private:
+    struct alignas(64) Cell {
+        std::array<std::atomic<double>, NUM_VENUES> venue;
+        std::atomic<double> symbol{0.0};
+
+        Cell() {
+            for (auto& score : venue) {
+                score.store(0.0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<Cell> cells_;
+};
+
+} // namespace trading
@@ -36,6 +36,16 @@ enum class OrderType : uint8_t {
     STOP_LIMIT
 };
 
+// Strategy family (indexes per-strategy parameter tables)
+enum class StrategyKind : uint8_t {
+    OBI,
+    LATENCY_ARB,
+    PAIRS,
+    VOL_ARB,
+    MARKET_MAKING,
+    COUNT
+};
+
 // Order status
 enum class OrderStatus : uint8_t {
     PENDING,
@@ -81,6 +91,10 @@ struct Fill {
     double ask_at_fill;             // Best ask when filled
     double mid_at_fill;             // Mid price when filled
     
+    // Risk tracking (copied from the Order when the fill is matched to it)
+    uint64_t reservation_id;        // Multi-leg risk reservation (0 = none)
+    int reservation_leg;            // Leg index within the reservation
+    
     Fill() 
         : side(Side::BUY)
         , price(0.0)
@@ -92,6 +106,8 @@ struct Fill {
         , bid_at_fill(0.0)
         , ask_at_fill(0.0)
         , mid_at_fill(0.0)
+        , reservation_id(0)
+        , reservation_leg(0)
     {}
     
     // Helper to calculate slippage
@@ -144,10 +160,13 @@ struct Order {
     
     // Strategy context
     std::string strategy_name;      // Which strategy generated this
+    StrategyKind strategy;          // Same, typed (COUNT = untagged)
     int signal_id;                  // Signal ID (for tracking)
     
     // Risk tracking
     double risk_notional;           // Notional value for risk
+    uint64_t reservation_id;        // Multi-leg risk reservation (0 = none)
+    int reservation_leg;            // Leg index within the reservation
     
     Order()
         : venue(Venue::UNKNOWN)
@@ -158,8 +177,11 @@ struct Order {
         , filled_quantity(0.0)
         , remaining_quantity(0.0)
         , status(OrderStatus::PENDING)
+        , strategy(StrategyKind::COUNT)
         , signal_id(0)
         , risk_notional(0.0)
+        , reservation_id(0)
+        , reservation_leg(0)
     {}
     
     // Calculate latencies
@@ -256,6 +278,29 @@ inline const char* to_string(OrderStatus status) {
     }
 }
 
+inline const char* to_string(OrderType type) {
+    switch (type) {
+        case OrderType::LIMIT: return "LIMIT";
+        case OrderType::MARKET: return "MARKET";
+        case OrderType::LIMIT_MAKER: return "LIMIT_MAKER";
+        case OrderType::LIMIT_IOC: return "LIMIT_IOC";
+        case OrderType::STOP_LOSS: return "STOP_LOSS";
+        case OrderType::STOP_LIMIT: return "STOP_LIMIT";
+        default: return "UNKNOWN";
+    }
+}
+
+inline const char* to_string(StrategyKind kind) {
+    switch (kind) {
+        case StrategyKind::OBI: return "OBI";
+        case StrategyKind::LATENCY_ARB: return "LATENCY_ARB";
+        case StrategyKind::PAIRS: return "PAIRS";
+        case StrategyKind::VOL_ARB: return "VOL_ARB";
+        case StrategyKind::MARKET_MAKING: return "MM";
+        default: return "UNKNOWN";
+    }
+}
+
 inline const char* to_string(Venue venue) {
     switch (venue) {
         case Venue::BINANCE: return "BINANCE";
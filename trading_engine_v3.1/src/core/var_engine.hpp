@@ -0,0 +1,424 @@
+#pragma once
+
+#include "types.hpp"
+#include "string_interning.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace trading {
+
+// Signed notional change to one symbol (a trade, or one leg of a group)
+struct NotionalDelta {
+    SymbolRegistry::SymbolId symbol;
+    double signed_notional;
+};
+
+// Streaming portfolio VaR - EWMA covariance with incremental exposure updates
+//
+// Market/fill threads only publish prices and quantities (relaxed stores).
+// A dedicated risk thread samples them every interval, applies a rank-1
+// EWMA covariance update (RiskMetrics), keeps C*w up to date incrementally
+// and publishes VaR + per-symbol marginal/component VaR (plus w'Cw, C*w and
+// C, for exact what-if VaR) via a seqlock snapshot that check_order() reads
+// without taking any lock.
+class PortfolioVarEngine {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    struct Config {
+        size_t max_symbols;                     // Capacity (indexed by SymbolId)
+        double ewma_lambda;                     // Decay (0.94 = RiskMetrics daily)
+        double confidence_z;                    // 2.326 = 99% one-sided
+        double horizon_samples;                 // VaR horizon in sample intervals
+        std::chrono::milliseconds sample_interval;
+        int risk_core;                          // CPU to pin risk thread (-1 = none)
+        int full_recompute_every;               // Re-derive C*w from scratch (drift control)
+
+        Config()
+            : max_symbols(256)
+            , ewma_lambda(0.94)
+            , confidence_z(2.326)
+            , horizon_samples(1.0)
+            , sample_interval(std::chrono::milliseconds(1000))
+            , risk_core(-1)
+            , full_recompute_every(64)
+        {}
+    };
+
+    explicit PortfolioVarEngine(const Config& config = Config())
+        : config_(config)
+        , stride_((config.max_symbols + 3) & ~size_t(3))
+        , latest_price_(config.max_symbols)
+        , latest_quantity_(config.max_symbols)
+        , prev_price_(stride_, 0.0)
+        , returns_(stride_, 0.0)
+        , exposure_(stride_, 0.0)
+        , cov_times_exposure_(stride_, 0.0)
+        , marginal_(config.max_symbols)
+        , component_(config.max_symbols)
+        , volatility_(config.max_symbols)
+        , published_cw_(config.max_symbols)
+        , published_cov_(config.max_symbols * config.max_symbols)
+    {
+        if (config.max_symbols == 0) {
+            throw std::invalid_argument("PortfolioVarEngine max_symbols must be > 0");
+        }
+
+        // Cache-aligned covariance matrix (row-major, padded rows for SIMD)
+        covariance_ = static_cast<double*>(aligned_alloc(64, stride_ * stride_ * sizeof(double)));
+        if (!covariance_) {
+            throw std::bad_alloc();
+        }
+        std::fill(covariance_, covariance_ + stride_ * stride_, 0.0);
+
+        for (size_t i = 0; i < config_.max_symbols; ++i) {
+            latest_price_[i].store(0.0, std::memory_order_relaxed);
+            latest_quantity_[i].store(0.0, std::memory_order_relaxed);
+            marginal_[i].store(0.0, std::memory_order_relaxed);
+            component_[i].store(0.0, std::memory_order_relaxed);
+            volatility_[i].store(0.0, std::memory_order_relaxed);
+            published_cw_[i].store(0.0, std::memory_order_relaxed);
+        }
+        for (auto& c : published_cov_) {
+            c.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    ~PortfolioVarEngine() {
+        stop();
+        free(covariance_);
+    }
+
+    PortfolioVarEngine(const PortfolioVarEngine&) = delete;
+    PortfolioVarEngine& operator=(const PortfolioVarEngine&) = delete;
+
+    // ===== Producers (hot path, any thread) =====
+
+    void on_price(SymbolId id, double price) {
+        if (id >= config_.max_symbols) return;
+        latest_price_[id].store(price, std::memory_order_relaxed);
+        bump_active(id);
+    }
+
+    void on_position(SymbolId id, double quantity) {
+        if (id >= config_.max_symbols) return;
+        latest_quantity_[id].store(quantity, std::memory_order_relaxed);
+        bump_active(id);
+    }
+
+    // ===== Lock-free snapshot readers =====
+
+    double portfolio_var() const {
+        return portfolio_var_.load(std::memory_order_acquire);
+    }
+
+    // dVaR / d(signed notional of symbol)
+    double marginal_var(SymbolId id) const {
+        if (id >= config_.max_symbols) return 0.0;
+        return marginal_[id].load(std::memory_order_relaxed);
+    }
+
+    // Contribution of symbol to VaR (components sum to portfolio VaR)
+    double component_var(SymbolId id) const {
+        if (id >= config_.max_symbols) return 0.0;
+        return component_[id].load(std::memory_order_relaxed);
+    }
+
+    // EWMA return volatility per sample interval (sqrt of covariance diagonal)
+    double volatility(SymbolId id) const {
+        if (id >= config_.max_symbols) return 0.0;
+        return volatility_[id].load(std::memory_order_relaxed);
+    }
+
+    // Consistent (portfolio VaR, marginal VaR of id) pair
+    std::pair<double, double> read_var(SymbolId id) const {
+        while (true) {
+            uint64_t seq1 = sequence_.load(std::memory_order_acquire);
+            if (seq1 & 1) continue;  // Writer in progress
+
+            double var = portfolio_var_.load(std::memory_order_relaxed);
+            double marginal = marginal_var(id);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == seq1) {
+                return {var, marginal};
+            }
+        }
+    }
+
+    // VaR after adding signed notional to symbol
+    double var_after_trade(SymbolId id, double signed_notional) const {
+        NotionalDelta trade{id, signed_notional};
+        return var_after_trades(std::span<const NotionalDelta>(&trade, 1));
+    }
+
+    // VaR after a group of trades (legs on the same symbol net out). Exact
+    // quadratic on one consistent snapshot, so it holds from a flat book and
+    // for trades that dominate it - unlike the marginal (first-order) estimate:
+    //   z * sqrt(h * (w'Cw + 2 d'(Cw) + d'Cd))
+    double var_after_trades(std::span<const NotionalDelta> trades) const {
+        while (true) {
+            uint64_t seq1 = sequence_.load(std::memory_order_acquire);
+            if (seq1 & 1) continue;  // Writer in progress
+
+            double variance = portfolio_variance_.load(std::memory_order_relaxed);
+            for (size_t a = 0; a < trades.size(); ++a) {
+                SymbolId i = trades[a].symbol;
+                if (i >= config_.max_symbols) continue;
+                double di = trades[a].signed_notional;
+
+                variance += 2.0 * di * published_cw_[i].load(std::memory_order_relaxed);
+                for (size_t b = 0; b < trades.size(); ++b) {
+                    SymbolId j = trades[b].symbol;
+                    if (j >= config_.max_symbols) continue;
+                    variance += di * trades[b].signed_notional *
+                                published_cov_[i * config_.max_symbols + j].load(std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == seq1) {
+                return config_.confidence_z * std::sqrt(std::max(variance, 0.0) * config_.horizon_samples);
+            }
+        }
+    }
+
+    uint64_t samples() const {
+        return samples_.load(std::memory_order_relaxed);
+    }
+
+    // ===== Risk thread =====
+
+    void start() {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        worker_ = std::thread([this] { run(); });
+
+#if defined(__linux__)
+        if (config_.risk_core >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.risk_core, &cpuset);
+            pthread_setaffinity_np(worker_.native_handle(), sizeof(cpu_set_t), &cpuset);
+        }
+#endif
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // One sampling step - used by the risk thread, callable directly when the
+    // caller drives its own scheduling (backtests, replay)
+    void step() {
+        size_t n = active_.load(std::memory_order_acquire);
+
+        // 1. Sample prices -> log returns, exposures -> deltas
+        bool have_returns = false;
+        double r_dot_w = 0.0;
+
+        for (size_t i = 0; i < n; ++i) {
+            double price = latest_price_[i].load(std::memory_order_relaxed);
+            double prev = prev_price_[i];
+
+            returns_[i] = (price > 0.0 && prev > 0.0) ? std::log(price / prev) : 0.0;
+            if (returns_[i] != 0.0) have_returns = true;
+            if (price > 0.0) prev_price_[i] = price;
+        }
+
+        // 2. Rank-1 covariance update; C*w follows in O(n):
+        //    (lambda*C + (1-lambda)*r*r') * w = lambda*Cw + (1-lambda)*r*(r.w)
+        //    Skipped when nothing moved - a stale feed must not decay variance.
+        if (have_returns) {
+            for (size_t i = 0; i < n; ++i) {
+                r_dot_w += returns_[i] * exposure_[i];
+            }
+
+            rank_one_update(n);
+
+            double beta = (1.0 - config_.ewma_lambda) * r_dot_w;
+            for (size_t i = 0; i < n; ++i) {
+                cov_times_exposure_[i] = config_.ewma_lambda * cov_times_exposure_[i] +
+                                         beta * returns_[i];
+            }
+        }
+
+        // 3. Exposure changes: C*w += C[:,j] * dw_j (O(n) per changed symbol)
+        for (size_t j = 0; j < n; ++j) {
+            double qty = latest_quantity_[j].load(std::memory_order_relaxed);
+            double notional = qty * prev_price_[j];
+            double delta = notional - exposure_[j];
+
+            if (delta != 0.0) {
+                exposure_[j] = notional;
+                const double* row = covariance_ + j * stride_;  // Symmetric: row == column
+                axpy(n, delta, row, cov_times_exposure_.data());
+            }
+        }
+
+        if (++steps_since_recompute_ >= config_.full_recompute_every) {
+            recompute_cov_times_exposure(n);
+            steps_since_recompute_ = 0;
+        }
+
+        publish(n);
+        samples_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    Config config_;
+    size_t stride_;
+
+    // Producer side
+    std::vector<std::atomic<double>> latest_price_;
+    std::vector<std::atomic<double>> latest_quantity_;
+    std::atomic<size_t> active_{0};
+
+    // Risk thread state (single writer)
+    double* covariance_;
+    std::vector<double> prev_price_;
+    std::vector<double> returns_;
+    std::vector<double> exposure_;              // Signed notional per symbol
+    std::vector<double> cov_times_exposure_;    // C * w
+    int steps_since_recompute_ = 0;
+
+    // Published snapshot (seqlock)
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<double> portfolio_var_{0.0};
+    std::vector<std::atomic<double>> marginal_;
+    std::vector<std::atomic<double>> component_;
+    std::vector<std::atomic<double>> volatility_;
+    std::atomic<double> portfolio_variance_{0.0};       // w'Cw
+    std::vector<std::atomic<double>> published_cw_;     // C*w
+    std::vector<std::atomic<double>> published_cov_;    // C (max_symbols x max_symbols)
+    std::atomic<uint64_t> samples_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+
+    void bump_active(SymbolId id) {
+        size_t needed = static_cast<size_t>(id) + 1;
+        size_t current = active_.load(std::memory_order_relaxed);
+        while (needed > current &&
+               !active_.compare_exchange_weak(current, needed, std::memory_order_release)) {
+        }
+    }
+
+    void run() {
+        auto next = Clock::now();
+        while (running_.load(std::memory_order_acquire)) {
+            next += config_.sample_interval;
+            std::this_thread::sleep_until(next);
+            step();
+        }
+    }
+
+    // C = lambda*C + (1-lambda) * r r'  (upper n x n block)
+    void rank_one_update(size_t n) {
+        const double lambda = config_.ewma_lambda;
+        const double alpha = 1.0 - lambda;
+        const double* r = returns_.data();
+
+        for (size_t i = 0; i < n; ++i) {
+            double* row = covariance_ + i * stride_;
+            const double ari = alpha * r[i];
+            size_t j = 0;
+
+#if defined(__AVX2__)
+            const __m256d vlambda = _mm256_set1_pd(lambda);
+            const __m256d vari = _mm256_set1_pd(ari);
+            for (; j + 4 <= n; j += 4) {
+                __m256d c = _mm256_load_pd(row + j);
+                __m256d rj = _mm256_loadu_pd(r + j);
+                c = _mm256_add_pd(_mm256_mul_pd(vlambda, c), _mm256_mul_pd(vari, rj));
+                _mm256_store_pd(row + j, c);
+            }
+#endif
+            for (; j < n; ++j) {
+                row[j] = lambda * row[j] + ari * r[j];
+            }
+        }
+    }
+
+    // y += a * x
+    static void axpy(size_t n, double a, const double* __restrict x, double* __restrict y) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d va = _mm256_set1_pd(a);
+        for (; i + 4 <= n; i += 4) {
+            __m256d vy = _mm256_loadu_pd(y + i);
+            vy = _mm256_add_pd(vy, _mm256_mul_pd(va, _mm256_load_pd(x + i)));
+            _mm256_storeu_pd(y + i, vy);
+        }
+#endif
+        for (; i < n; ++i) {
+            y[i] += a * x[i];
+        }
+    }
+
+    void recompute_cov_times_exposure(size_t n) {
+        std::fill(cov_times_exposure_.begin(), cov_times_exposure_.end(), 0.0);
+        for (size_t j = 0; j < n; ++j) {
+            if (exposure_[j] != 0.0) {
+                axpy(n, exposure_[j], covariance_ + j * stride_, cov_times_exposure_.data());
+            }
+        }
+    }
+
+    void publish(size_t n) {
+        double variance = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            variance += exposure_[i] * cov_times_exposure_[i];
+        }
+
+        double sigma = std::sqrt(std::max(variance, 0.0) * config_.horizon_samples);
+        double scale = sigma > 0.0 ? config_.confidence_z * config_.horizon_samples / sigma : 0.0;
+
+        sequence_.fetch_add(1, std::memory_order_acq_rel);  // Odd: write in progress
+
+        portfolio_var_.store(config_.confidence_z * sigma, std::memory_order_relaxed);
+        portfolio_variance_.store(variance, std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            published_cw_[i].store(cov_times_exposure_[i], std::memory_order_relaxed);
+            const double* row = covariance_ + i * stride_;
+            std::atomic<double>* out = published_cov_.data() + i * config_.max_symbols;
+            for (size_t j = 0; j < n; ++j) {
+                out[j].store(row[j], std::memory_order_relaxed);
+            }
+
+            double marginal = scale * cov_times_exposure_[i];
+            marginal_[i].store(marginal, std::memory_order_relaxed);
+            component_[i].store(marginal * exposure_[i], std::memory_order_relaxed);
+            volatility_[i].store(std::sqrt(std::max(covariance_[i * stride_ + i], 0.0)),
+                                 std::memory_order_relaxed);
+        }
+
+        sequence_.fetch_add(1, std::memory_order_release);  // Even: consistent
+    }
+};
+
+} // namespace trading
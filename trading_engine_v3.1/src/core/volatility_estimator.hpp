@@ -0,0 +1,245 @@
+#pragma once
+
+#include "types.hpp"
+#include "symbol_map.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Incremental volatility estimator - O(1) per price update
+//
+// Keeps, per symbol:
+//   - Wilder ATR (close-to-close true range, seeded with the simple mean)
+//   - Rolling mean of ATR over atr_mean_window values
+//   - Realized variance of returns over several sample windows
+//   - EWMA variance of returns at several decay rates
+// Rolling sums add the new value and subtract the one leaving the window;
+// they are re-summed once per ring wrap so rounding error can't accumulate.
+// Not thread-safe: owned by the market data thread.
+class VolatilityEstimator {
+public:
+    static constexpr size_t NUM_HORIZONS = 3;
+
+    struct Config {
+        size_t atr_period;                              // Wilder smoothing period
+        size_t atr_mean_window;                         // ATR values in the rolling mean
+        size_t atr_mean_min_samples;                    // Mean reported once this many ATRs
+        std::array<size_t, NUM_HORIZONS> realized_windows;  // Returns per realized horizon
+        std::array<double, NUM_HORIZONS> ewma_lambdas;      // Decay per EWMA horizon
+
+        Config()
+            : atr_period(14)
+            , atr_mean_window(50)
+            , atr_mean_min_samples(10)
+            , realized_windows{20, 60, 300}
+            , ewma_lambdas{0.94, 0.97, 0.99}
+        {}
+    };
+
+    explicit VolatilityEstimator(const Config& config = Config())
+        : config_(config)
+        , atr_ring_(config.atr_mean_window)
+        , return_ring_(*std::max_element(config.realized_windows.begin(),
+                                         config.realized_windows.end()))
+    {
+        if (config_.atr_period == 0 || config_.atr_mean_window == 0 || return_ring_.empty()) {
+            throw std::invalid_argument("VolatilityEstimator periods and windows must be > 0");
+        }
+    }
+
+    void update(double price) {
+        if (price <= 0.0) return;
+
+        if (samples_++ == 0) {
+            last_price_ = price;
+            return;
+        }
+
+        double true_range = std::abs(price - last_price_);
+        double ret = (price - last_price_) / last_price_;
+        last_price_ = price;
+
+        update_atr(true_range);
+        update_returns(ret);
+    }
+
+    // ATR valid after atr_period + 1 prices
+    bool has_atr() const { return atr_count_ >= config_.atr_period; }
+    double atr() const { return has_atr() ? atr_ : 0.0; }
+
+    // Rolling mean of ATR (0 until atr_mean_min_samples ATR values)
+    double avg_atr() const {
+        return atr_values_ >= config_.atr_mean_min_samples
+            ? atr_sum_ / static_cast<double>(std::min(atr_values_, atr_ring_.size()))
+            : 0.0;
+    }
+
+    double atr_ratio() const {
+        double avg = avg_atr();
+        return avg > 0.0 ? atr() / avg : 1.0;
+    }
+
+    // Population variance of the last realized_windows[h] returns
+    double realized_variance(size_t horizon) const {
+        size_t n = std::min(return_count_, config_.realized_windows[horizon]);
+        if (n < 2) return 0.0;
+
+        const auto& sums = realized_[horizon];
+        double mean = sums.sum / n;
+        return std::max(0.0, sums.sum_sq / n - mean * mean);
+    }
+
+    double realized_stdev(size_t horizon) const {
+        return std::sqrt(realized_variance(horizon));
+    }
+
+    double ewma_variance(size_t horizon) const {
+        return ewma_[horizon];
+    }
+
+    double ewma_stdev(size_t horizon) const {
+        return std::sqrt(ewma_[horizon]);
+    }
+
+    size_t samples() const { return samples_; }
+    size_t return_count() const { return return_count_; }
+    double last_price() const { return last_price_; }
+    const Config& config() const { return config_; }
+
+private:
+    struct RollingSums {
+        double sum = 0.0;
+        double sum_sq = 0.0;
+    };
+
+    Config config_;
+
+    size_t samples_ = 0;
+    double last_price_ = 0.0;
+
+    // ATR
+    double atr_ = 0.0;
+    size_t atr_count_ = 0;              // True ranges seen (saturates at atr_period)
+    std::vector<double> atr_ring_;
+    size_t atr_head_ = 0;
+    size_t atr_values_ = 0;
+    double atr_sum_ = 0.0;
+
+    // Returns
+    std::vector<double> return_ring_;
+    size_t return_head_ = 0;
+    size_t return_count_ = 0;
+    std::array<RollingSums, NUM_HORIZONS> realized_{};
+    std::array<double, NUM_HORIZONS> ewma_{};
+
+    void update_atr(double true_range) {
+        double period = static_cast<double>(config_.atr_period);
+
+        if (atr_count_ < config_.atr_period) {
+            // Seed: simple mean of the first atr_period true ranges
+            atr_ += true_range / period;
+            if (++atr_count_ < config_.atr_period) return;
+        } else {
+            atr_ = (atr_ * (period - 1.0) + true_range) / period;
+        }
+
+        size_t window = atr_ring_.size();
+        if (atr_values_ >= window) {
+            atr_sum_ -= atr_ring_[atr_head_];
+        }
+        atr_ring_[atr_head_] = atr_;
+        atr_sum_ += atr_;
+        ++atr_values_;
+
+        if (++atr_head_ == window) {
+            atr_head_ = 0;
+            atr_sum_ = 0.0;
+            for (size_t i = 0; i < std::min(atr_values_, window); ++i) {
+                atr_sum_ += atr_ring_[i];
+            }
+        }
+    }
+
+    void update_returns(double ret) {
+        size_t capacity = return_ring_.size();
+
+        for (size_t h = 0; h < NUM_HORIZONS; ++h) {
+            size_t window = config_.realized_windows[h];
+            auto& sums = realized_[h];
+
+            if (return_count_ >= window) {
+                double leaving = return_ring_[(return_head_ + capacity - window) % capacity];
+                sums.sum -= leaving;
+                sums.sum_sq -= leaving * leaving;
+            }
+            sums.sum += ret;
+            sums.sum_sq += ret * ret;
+
+            // Seed EWMA with the first squared return
+            double lambda = config_.ewma_lambdas[h];
+            ewma_[h] = return_count_ == 0 ? ret * ret
+                                          : lambda * ewma_[h] + (1.0 - lambda) * ret * ret;
+        }
+
+        return_ring_[return_head_] = ret;
+        ++return_count_;
+
+        if (++return_head_ == capacity) {
+            return_head_ = 0;
+            resum_returns();
+        }
+    }
+
+    void resum_returns() {
+        size_t capacity = return_ring_.size();
+        for (size_t h = 0; h < NUM_HORIZONS; ++h) {
+            size_t n = std::min(return_count_, config_.realized_windows[h]);
+            RollingSums sums;
+            for (size_t i = 1; i <= n; ++i) {
+                double r = return_ring_[(return_head_ + capacity - i) % capacity];
+                sums.sum += r;
+                sums.sum_sq += r * r;
+            }
+            realized_[h] = sums;
+        }
+    }
+};
+
+// Per-symbol volatility service - one estimator per symbol, fed once per tick
+// and shared by every consumer (vol arb, OBI adaptive thresholds, sizing).
+class VolatilityService {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    explicit VolatilityService(const VolatilityEstimator::Config& config = VolatilityEstimator::Config())
+        : config_(config)
+    {}
+
+    // Feed a price; creates the symbol's estimator on first use
+    const VolatilityEstimator& update(SymbolId symbol, double price) {
+        VolatilityEstimator* estimator = estimators_.find(symbol);
+        if (!estimator) {
+            estimator = &estimators_.insert_or_assign(symbol, config_);
+        }
+        estimator->update(price);
+        return *estimator;
+    }
+
+    // nullptr if the symbol has never been updated
+    const VolatilityEstimator* get(SymbolId symbol) const {
+        return estimators_.find(symbol);
+    }
+
+    size_t size() const { return estimators_.size(); }
+    const VolatilityEstimator::Config& config() const { return config_; }
+
+private:
+    VolatilityEstimator::Config config_;
+    SymbolMap<VolatilityEstimator> estimators_;
+};
+
+} // namespace trading
@@ -90,12 +90,13 @@ int main(int argc, char** argv) {
     std::unordered_map<Venue, OrderBook> all_books;
     all_books[Venue::BINANCE] = btc_book;
     
-    std::unordered_map<std::string, double> current_prices;
+    SymbolMap<double> current_prices;
     current_prices["BTCUSDT"] = btc_book.get_mid_price();
     current_prices["ETHUSDT"] = 3000.0;
     
     auto orders = coordinator.process_market_update(
         "BTCUSDT",
+        Venue::BINANCE,
         btc_book,
         all_books,
         current_prices
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/symbol_map.hpp"
+#include "order_book.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace trading {
+
+// Cross-venue best bid/offer for one instrument
+//
+// Per-venue touches plus two tournament trees over the venues (max-bid,
+// min-ask). A venue touch change replays only its leaf-to-root path:
+// O(log V) compares. The global best bid/ask are the tree roots (O(1)),
+// and the runner-up - needed when both bests sit on the same venue - is
+// the best loser along the winner's path, also O(log V).
+class InstrumentBBO {
+public:
+    static constexpr size_t NUM_VENUES = static_cast<size_t>(Venue::UNKNOWN) + 1;
+    static constexpr size_t LEAVES = std::bit_ceil(NUM_VENUES);
+    static constexpr uint8_t NONE = 0xFF;
+
+    struct Touch {
+        double bid = 0.0;
+        double bid_qty = 0.0;
+        double ask = 0.0;
+        double ask_qty = 0.0;
+        TimePoint updated{};
+    };
+
+    InstrumentBBO() {
+        bid_tree_.fill(NONE);
+        ask_tree_.fill(NONE);
+    }
+
+    // Returns true if the venue's touch changed
+    bool update(Venue venue, double bid, double bid_qty, double ask, double ask_qty,
+                TimePoint now = Clock::now()) {
+        size_t v = static_cast<size_t>(venue);
+        Touch& touch = touches_[v];
+        touch.updated = now;
+
+        bool bid_changed = touch.bid != bid || touch.bid_qty != bid_qty;
+        bool ask_changed = touch.ask != ask || touch.ask_qty != ask_qty;
+        touch.bid = bid;
+        touch.bid_qty = bid_qty;
+        touch.ask = ask;
+        touch.ask_qty = ask_qty;
+
+        if (bid_changed) replay(bid_tree_, v, &InstrumentBBO::better_bid);
+        if (ask_changed) replay(ask_tree_, v, &InstrumentBBO::better_ask);
+        return bid_changed || ask_changed;
+    }
+
+    // Touch read from a venue book
+    bool update(Venue venue, const OrderBook& book, TimePoint now = Clock::now()) {
+        const auto& bids = book.get_bids();
+        const auto& asks = book.get_asks();
+        return update(venue,
+                      bids.empty() ? 0.0 : bids.begin()->first, bids.empty() ? 0.0 : bids.begin()->second,
+                      asks.empty() ? 0.0 : asks.begin()->first, asks.empty() ? 0.0 : asks.begin()->second,
+                      now);
+    }
+
+    void remove(Venue venue) {
+        update(venue, 0.0, 0.0, 0.0, 0.0);
+    }
+
+    // ===== O(1) =====
+
+    // Venue::UNKNOWN when no venue quotes the side
+    Venue best_bid_venue() const {
+        return valid(bid_tree_[1], &InstrumentBBO::better_bid) ? to_venue(bid_tree_[1]) : Venue::UNKNOWN;
+    }
+
+    Venue best_ask_venue() const {
+        return valid(ask_tree_[1], &InstrumentBBO::better_ask) ? to_venue(ask_tree_[1]) : Venue::UNKNOWN;
+    }
+
+    // 0 when no venue quotes the side
+    double best_bid() const { return bid_tree_[1] == NONE ? 0.0 : touches_[bid_tree_[1]].bid; }
+    double best_ask() const { return ask_tree_[1] == NONE ? 0.0 : touches_[ask_tree_[1]].ask; }
+
+    // Global best bid above global best ask on different venues. A cross
+    // hidden behind a single venue holding both bests needs the
+    // *_excluding() runner-ups.
+    bool crossed() const {
+        double bid = best_bid();
+        double ask = best_ask();
+        return bid > 0.0 && ask > 0.0 && bid > ask && bid_tree_[1] != ask_tree_[1];
+    }
+
+    const Touch& touch(Venue venue) const {
+        return touches_[static_cast<size_t>(venue)];
+    }
+
+    // ===== O(log V) =====
+
+    // Best bid / ask on any venue other than `exclude`
+    Venue best_bid_venue_excluding(Venue exclude) const {
+        return to_venue(runner_up(bid_tree_, static_cast<size_t>(exclude), &InstrumentBBO::better_bid));
+    }
+
+    Venue best_ask_venue_excluding(Venue exclude) const {
+        return to_venue(runner_up(ask_tree_, static_cast<size_t>(exclude), &InstrumentBBO::better_ask));
+    }
+
+    // Venues with a bid, best first (returns count)
+    size_t sorted_bids(std::array<Venue, NUM_VENUES>& out) const {
+        return sorted(out, &InstrumentBBO::better_bid, [](const Touch& t) { return t.bid > 0.0; });
+    }
+
+    // Venues with an ask, best first (returns count)
+    size_t sorted_asks(std::array<Venue, NUM_VENUES>& out) const {
+        return sorted(out, &InstrumentBBO::better_ask, [](const Touch& t) { return t.ask > 0.0; });
+    }
+
+private:
+    using Better = bool (InstrumentBBO::*)(uint8_t, uint8_t) const;
+
+    std::array<Touch, NUM_VENUES> touches_{};
+    std::array<uint8_t, 2 * LEAVES> bid_tree_;      // Heap layout: node 1 is the root
+    std::array<uint8_t, 2 * LEAVES> ask_tree_;
+
+    static Venue to_venue(uint8_t v) {
+        return v == NONE ? Venue::UNKNOWN : static_cast<Venue>(v);
+    }
+
+    // Winner of two leaves/subtrees; empty sides (no quote) always lose
+    bool better_bid(uint8_t a, uint8_t b) const {
+        if (b == NONE || touches_[b].bid <= 0.0) return a != NONE && touches_[a].bid > 0.0;
+        if (a == NONE || touches_[a].bid <= 0.0) return false;
+        return touches_[a].bid > touches_[b].bid;
+    }
+
+    bool better_ask(uint8_t a, uint8_t b) const {
+        if (b == NONE || touches_[b].ask <= 0.0) return a != NONE && touches_[a].ask > 0.0;
+        if (a == NONE || touches_[a].ask <= 0.0) return false;
+        return touches_[a].ask < touches_[b].ask;
+    }
+
+    // Ties keep the left (lower) venue
+    uint8_t pick(uint8_t a, uint8_t b, Better better) const {
+        return (this->*better)(b, a) ? b : a;
+    }
+
+    void replay(std::array<uint8_t, 2 * LEAVES>& tree, size_t venue, Better better) {
+        size_t node = LEAVES + venue;
+        tree[node] = static_cast<uint8_t>(venue);
+        for (node >>= 1; node >= 1; node >>= 1) {
+            tree[node] = pick(tree[2 * node], tree[2 * node + 1], better);
+        }
+    }
+
+    // Best leaf other than `exclude`: the root if it isn't excluded, else the
+    // best of the subtrees hanging off the excluded leaf's path
+    uint8_t runner_up(const std::array<uint8_t, 2 * LEAVES>& tree, size_t exclude, Better better) const {
+        if (tree[1] != exclude) return valid(tree[1], better) ? tree[1] : NONE;
+
+        uint8_t best = NONE;
+        for (size_t node = LEAVES + exclude; node > 1; node >>= 1) {
+            uint8_t sibling = tree[node ^ 1];
+            if ((this->*better)(sibling, best)) best = sibling;
+        }
+        return best;
+    }
+
+    bool valid(uint8_t v, Better better) const {
+        return (this->*better)(v, NONE);
+    }
+
+    template<typename HasQuote>
+    size_t sorted(std::array<Venue, NUM_VENUES>& out, Better better, HasQuote has_quote) const {
+        std::array<uint8_t, NUM_VENUES> venues;
+        size_t n = 0;
+        for (size_t v = 0; v < NUM_VENUES; ++v) {
+            if (has_quote(touches_[v])) venues[n++] = static_cast<uint8_t>(v);
+        }
+        std::sort(venues.begin(), venues.begin() + n,
+                  [this, better](uint8_t a, uint8_t b) { return (this->*better)(a, b); });
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<Venue>(venues[i]);
+        }
+        return n;
+    }
+};
+
+// Consolidated BBO for every instrument (indexed by SymbolId)
+// Written by the market data thread; not thread-safe.
+class ConsolidatedBBO {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    // Venue touch changed; returns the instrument's consolidated view
+    const InstrumentBBO& update(SymbolId symbol, Venue venue,
+                                double bid, double bid_qty, double ask, double ask_qty,
+                                TimePoint now = Clock::now()) {
+        InstrumentBBO& bbo = instruments_[symbol];
+        bbo.update(venue, bid, bid_qty, ask, ask_qty, now);
+        return bbo;
+    }
+
+    const InstrumentBBO& update(SymbolId symbol, Venue venue, const OrderBook& book,
+                                TimePoint now = Clock::now()) {
+        InstrumentBBO& bbo = instruments_[symbol];
+        bbo.update(venue, book, now);
+        return bbo;
+    }
+
+    // nullptr if no venue has quoted the instrument
+    const InstrumentBBO* get(SymbolId symbol) const {
+        return instruments_.find(symbol);
+    }
+
+    size_t size() const { return instruments_.size(); }
+
+private:
+    SymbolMap<InstrumentBBO> instruments_;
+};
+
+} // namespace trading
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/symbol_map.hpp"
+#include "../core/toxicity_board.hpp"
+#include "../core/volatility_estimator.hpp"
+#include "order_book.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace trading {
+
+// Order-flow features for one symbol, refreshed once per book update
+// Hot touch fields share the first cache line; the struct is 64-byte
+// aligned so symbols never share a line.
+struct alignas(64) BookFeatures {
+    static constexpr size_t MAX_DEPTHS = 4;
+
+    // Touch
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double mid = 0.0;
+    double microprice = 0.0;            // Touch size-weighted fair value
+    double weighted_mid = 0.0;          // Microprice over OrderBook::WEIGHTED_MID_LEVELS
+    double queue_imbalance = 0.0;       // Touch size, -1 .. +1
+    double spread_bps = 0.0;
+    uint64_t sequence = 0;              // Book updates seen
+    TimePoint updated{};
+
+    // Imbalance (-1 all asks .. +1 all bids) over the configured depths
+    std::array<uint32_t, MAX_DEPTHS> depths{};
+    std::array<double, MAX_DEPTHS> bid_volume{};
+    std::array<double, MAX_DEPTHS> ask_volume{};
+    std::array<double, MAX_DEPTHS> imbalance{};
+    size_t num_depths = 0;
+    double weighted_imbalance = 0.0;    // Level-weighted over the top levels
+
+    // Flow, volatility, trends
+    double trade_flow_imbalance = 0.0;  // EWMA aggressor volume, -1 sells .. +1 buys
+    double realized_vol = 0.0;          // Return stdev, shortest realized window
+    double ewma_vol = 0.0;              // Return stdev, fastest EWMA
+    double atr_ratio = 1.0;             // ATR / rolling mean ATR
+    double imbalance_trend = 0.0;       // Top-depth imbalance change over the trend lookback
+    double mid_trend_bps = 0.0;         // Mid change over the trend lookback
+    double toxicity = 0.0;              // Adverse selection score (0 without a board)
+
+    bool valid = false;                 // Both sides quoted
+
+    // Slot of a configured depth, -1 if the pipeline doesn't compute it
+    int depth_slot(size_t levels) const {
+        for (size_t i = 0; i < num_depths; ++i) {
+            if (depths[i] == levels) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+// Feature pipeline - one pass over each book update, shared by every strategy
+//
+// Imbalances read the book's cached depth ladders (rebuilt only from the
+// first changed level), volatility comes from one estimator per symbol, and
+// trends come from a small per-symbol ring, so a tick costs the same however
+// many strategies consume it.
+// Not thread-safe: owned by the market data thread.
+class FeaturePipeline {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    struct Config {
+        std::vector<size_t> imbalance_depths;   // Levels per imbalance (<= MAX_DEPTHS entries)
+        std::vector<double> level_weights;      // Weighted imbalance, touch first
+        size_t trend_lookback;                  // Updates spanned by the trends
+        double trade_flow_alpha;                // EWMA weight per trade
+        VolatilityEstimator::Config volatility;
+
+        Config()
+            : imbalance_depths({1, 5, 10})
+            , level_weights({1.0, 0.8, 0.6, 0.4, 0.2})
+            , trend_lookback(10)
+            , trade_flow_alpha(0.05)
+        {}
+    };
+
+    explicit FeaturePipeline(const Config& config = Config())
+        : config_(config)
+        , volatility_(config.volatility)
+    {
+        if (config_.imbalance_depths.empty() ||
+            config_.imbalance_depths.size() > BookFeatures::MAX_DEPTHS ||
+            config_.level_weights.size() > DepthLadder::LEVELS ||
+            config_.trend_lookback < 2 ||
+            config_.trade_flow_alpha <= 0.0 || config_.trade_flow_alpha > 1.0) {
+            throw std::invalid_argument("FeaturePipeline config out of range");
+        }
+        for (size_t depth : config_.imbalance_depths) {
+            if (depth == 0 || depth > DepthLadder::LEVELS) {
+                throw std::invalid_argument("FeaturePipeline imbalance depth must be 1-20");
+            }
+        }
+    }
+
+    // Adverse selection scores copied into BookFeatures::toxicity (optional)
+    void attach_toxicity(const ToxicityBoard* board) {
+        toxicity_ = board;
+    }
+
+    // Book changed: recompute the symbol's features
+    const BookFeatures& update(SymbolId symbol, const OrderBook& book, TimePoint now = Clock::now()) {
+        State& state = states_[symbol];
+        if (state.trend.empty()) {
+            state.trend.resize(config_.trend_lookback);
+        }
+        BookFeatures& f = state.features;
+
+        const DepthLadder& bids = book.bid_ladder();
+        const DepthLadder& asks = book.ask_ladder();
+
+        // Touch
+        f.updated = now;
+        ++f.sequence;
+        f.best_bid = bids.levels ? bids.price[0] : 0.0;
+        f.best_ask = asks.levels ? asks.price[0] : 0.0;
+        f.valid = f.best_bid > 0.0 && f.best_ask > 0.0;
+        f.mid = book.get_mid_price();
+        f.microprice = book.get_microprice();
+        f.weighted_mid = book.get_weighted_mid();
+        f.queue_imbalance = book.get_queue_imbalance();
+        f.spread_bps = f.valid ? (f.best_ask - f.best_bid) / f.mid * 10000.0 : 0.0;
+
+        // Imbalances straight off the cumulative ladders
+        f.num_depths = config_.imbalance_depths.size();
+        for (size_t i = 0; i < f.num_depths; ++i) {
+            size_t depth = config_.imbalance_depths[i];
+            f.depths[i] = static_cast<uint32_t>(depth);
+            f.bid_volume[i] = cumulative(bids, depth);
+            f.ask_volume[i] = cumulative(asks, depth);
+            f.imbalance[i] = imbalance(f.bid_volume[i], f.ask_volume[i]);
+        }
+
+        double weighted_bid = 0.0;
+        double weighted_ask = 0.0;
+        for (size_t level = 0; level < config_.level_weights.size(); ++level) {
+            double weight = config_.level_weights[level];
+            if (level < bids.levels) weighted_bid += bids.quantity[level] * weight;
+            if (level < asks.levels) weighted_ask += asks.quantity[level] * weight;
+        }
+        f.weighted_imbalance = weighted_bid + weighted_ask < 0.0001 ? 0.0
+                             : (weighted_bid - weighted_ask) / (weighted_bid + weighted_ask);
+
+        // Volatility
+        const VolatilityEstimator& volatility = volatility_.update(symbol, f.mid);
+        f.realized_vol = volatility.realized_stdev(0);
+        f.ewma_vol = volatility.ewma_stdev(0);
+        f.atr_ratio = volatility.atr_ratio();
+
+        // Trends: compare against the sample trend_lookback - 1 updates back
+        size_t lookback = state.trend.size();
+        state.trend[state.trend_head] = TrendSample{f.imbalance[0], f.mid};
+        state.trend_head = (state.trend_head + 1) % lookback;
+        state.trend_count = std::min(state.trend_count + 1, lookback);
+        if (state.trend_count >= 2) {
+            size_t oldest = state.trend_count == lookback ? state.trend_head : 0;
+            const TrendSample& first = state.trend[oldest];
+            f.imbalance_trend = f.imbalance[0] - first.imbalance;
+            f.mid_trend_bps = first.mid > 0.0 && f.mid > 0.0 ? (f.mid - first.mid) / first.mid * 10000.0 : 0.0;
+        }
+
+        f.trade_flow_imbalance = imbalance(state.buy_flow, state.sell_flow);
+        f.toxicity = toxicity_ ? toxicity_->toxicity(symbol) : 0.0;
+        return f;
+    }
+
+    // Public trade (aggressor side); feeds trade_flow_imbalance on the next update
+    void on_trade(SymbolId symbol, Side aggressor, double quantity) {
+        if (quantity <= 0.0) return;
+
+        State& state = states_[symbol];
+        double alpha = config_.trade_flow_alpha;
+        state.buy_flow = (1.0 - alpha) * state.buy_flow + (aggressor == Side::BUY ? alpha * quantity : 0.0);
+        state.sell_flow = (1.0 - alpha) * state.sell_flow + (aggressor == Side::SELL ? alpha * quantity : 0.0);
+    }
+
+    // nullptr until the symbol's first update
+    const BookFeatures* get(SymbolId symbol) const {
+        const State* state = states_.find(symbol);
+        return state && state->features.sequence ? &state->features : nullptr;
+    }
+
+    // Per-symbol estimators fed by update() (shared with vol arb / sizing)
+    const VolatilityService& volatility() const { return volatility_; }
+
+    const Config& config() const { return config_; }
+
+private:
+    struct TrendSample {
+        double imbalance = 0.0;
+        double mid = 0.0;
+    };
+
+    struct State {
+        BookFeatures features;
+        std::vector<TrendSample> trend;     // Ring of trend_lookback samples
+        size_t trend_head = 0;
+        size_t trend_count = 0;
+        double buy_flow = 0.0;              // EWMA aggressor volume
+        double sell_flow = 0.0;
+    };
+
+    Config config_;
+    VolatilityService volatility_;
+    SymbolMap<State> states_;
+    const ToxicityBoard* toxicity_ = nullptr;
+
+    static double cumulative(const DepthLadder& ladder, size_t depth) {
+        size_t levels = std::min(depth, ladder.levels);
+        return levels ? ladder.cum_quantity[levels - 1] : 0.0;
+    }
+
+    static double imbalance(double bid, double ask) {
+        double total = bid + ask;
+        return total > 0.0 ? (bid - ask) / total : 0.0;
+    }
+};
+
+} // namespace trading
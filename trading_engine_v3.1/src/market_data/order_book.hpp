@@ -1,6 +1,10 @@
 #pragma once
 
 #include "../core/types.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
 #include <map>
 #include <vector>
 
@@ -15,9 +19,27 @@ struct Level {
     Level(double p, double q) : price(p), quantity(q) {}
 };
 
+// Cumulative depth over the top LEVELS price levels of one side
+// cum_quantity[i] / cum_notional[i] include levels 0..i, so the VWAP to
+// level i is cum_notional[i] / cum_quantity[i].
+struct DepthLadder {
+    static constexpr size_t LEVELS = 20;
+    
+    size_t levels = 0;
+    std::array<double, LEVELS> price{};
+    std::array<double, LEVELS> quantity{};
+    std::array<double, LEVELS> cum_quantity{};
+    std::array<double, LEVELS> cum_notional{};
+    
+    double total_quantity() const { return levels ? cum_quantity[levels - 1] : 0.0; }
+    double total_notional() const { return levels ? cum_notional[levels - 1] : 0.0; }
+};
+
 // Order book representation
 class OrderBook {
 public:
+    static constexpr size_t WEIGHTED_MID_LEVELS = 5;
+    
     OrderBook() = default;
     
     // Get bid/ask spreads
@@ -49,26 +71,63 @@ public:
         return get_best_ask() - get_best_bid();
     }
     
+    // Touch size-weighted fair value: leans toward the side with less size
+    // (the side more likely to trade through). 0 if a side is empty.
+    double get_microprice() const {
+        if (bids_.empty() || asks_.empty()) return 0.0;
+        const auto& [bid, bid_qty] = *bids_.begin();
+        const auto& [ask, ask_qty] = *asks_.begin();
+        return (bid * ask_qty + ask * bid_qty) / (bid_qty + ask_qty);
+    }
+    
+    // Microprice over the top WEIGHTED_MID_LEVELS: each side's VWAP weighted
+    // by the opposite side's depth. 0 if a side is empty.
+    double get_weighted_mid() const {
+        if (bid_top_.count == 0 || ask_top_.count == 0) return 0.0;
+        double bid_vwap = bid_top_.notional / bid_top_.quantity;
+        double ask_vwap = ask_top_.notional / ask_top_.quantity;
+        return (bid_vwap * ask_top_.quantity + ask_vwap * bid_top_.quantity) /
+               (bid_top_.quantity + ask_top_.quantity);
+    }
+    
+    // Touch queue imbalance: -1 (all ask size) to +1 (all bid size)
+    double get_queue_imbalance() const {
+        if (bids_.empty() || asks_.empty()) return 0.0;
+        double bid_qty = bids_.begin()->second;
+        double ask_qty = asks_.begin()->second;
+        return (bid_qty - ask_qty) / (bid_qty + ask_qty);
+    }
+    
+    // Cumulative depth ladders - rebuilt lazily from the first level an
+    // update touched; updates below a full ladder don't invalidate it
+    const DepthLadder& bid_ladder() const {
+        refresh(bids_, bid_ladder_, bid_dirty_from_);
+        return bid_ladder_;
+    }
+    
+    const DepthLadder& ask_ladder() const {
+        refresh(asks_, ask_ladder_, ask_dirty_from_);
+        return ask_ladder_;
+    }
+    
     // Update order book
     void update_bid(double price, double quantity) {
-        if (quantity > 0.0) {
-            bids_[price] = quantity;
-        } else {
-            bids_.erase(price);
-        }
+        apply(bids_, bid_top_, price, quantity);
+        invalidate(bid_ladder_, bid_dirty_from_, price, bids_.key_comp());
     }
     
     void update_ask(double price, double quantity) {
-        if (quantity > 0.0) {
-            asks_[price] = quantity;
-        } else {
-            asks_.erase(price);
-        }
+        apply(asks_, ask_top_, price, quantity);
+        invalidate(ask_ladder_, ask_dirty_from_, price, asks_.key_comp());
     }
     
     void clear() {
         bids_.clear();
         asks_.clear();
+        bid_top_ = TopLevels();
+        ask_top_ = TopLevels();
+        bid_dirty_from_ = 0;
+        ask_dirty_from_ = 0;
     }
     
     // Get book depth
@@ -78,6 +137,134 @@ public:
 private:
     std::map<double, double, std::greater<double>> bids_;  // Sorted descending
     std::map<double, double> asks_;                         // Sorted ascending
+    
+    // Running size / notional of the top WEIGHTED_MID_LEVELS of one side,
+    // adjusted per update; re-summed every RESUM_INTERVAL updates so
+    // rounding error can't accumulate
+    struct TopLevels {
+        static constexpr uint32_t RESUM_INTERVAL = 1024;
+        
+        size_t count = 0;
+        double last_price = 0.0;        // Deepest level inside the window
+        double quantity = 0.0;
+        double notional = 0.0;
+        uint32_t updates = 0;
+    };
+    
+    TopLevels bid_top_;
+    TopLevels ask_top_;
+    
+    // Depth ladder caches; *_dirty_from_ is the first stale level (LEVELS = clean)
+    mutable DepthLadder bid_ladder_;
+    mutable DepthLadder ask_ladder_;
+    mutable size_t bid_dirty_from_ = 0;
+    mutable size_t ask_dirty_from_ = 0;
+    
+    // Apply a level update, keeping the side's top-level window current:
+    // the map operation plus O(1) window bookkeeping
+    template<typename Side>
+    static void apply(Side& side, TopLevels& top, double price, double quantity) {
+        auto better = side.key_comp();
+        auto it = side.find(price);
+        bool in_window = top.count > 0 && !better(top.last_price, price);
+        
+        if (quantity > 0.0) {
+            if (it != side.end()) {
+                if (in_window) {
+                    top.quantity += quantity - it->second;
+                    top.notional += price * (quantity - it->second);
+                }
+                it->second = quantity;
+            } else {
+                side.emplace(price, quantity);
+                if (top.count < WEIGHTED_MID_LEVELS) {
+                    // Window holds every level: the new one joins it
+                    ++top.count;
+                    top.quantity += quantity;
+                    top.notional += price * quantity;
+                    if (top.count == 1 || better(top.last_price, price)) top.last_price = price;
+                } else if (in_window) {
+                    // Pushes the deepest level out
+                    auto last = side.find(top.last_price);
+                    top.quantity += quantity - last->second;
+                    top.notional += price * quantity - last->first * last->second;
+                    top.last_price = std::prev(last)->first;
+                }
+            }
+        } else if (it != side.end()) {
+            if (in_window) {
+                // Pull the next level in behind the window, if there is one
+                auto last = price == top.last_price ? it : side.find(top.last_price);
+                auto next = std::next(last);
+                top.quantity -= it->second;
+                top.notional -= price * it->second;
+                if (next != side.end()) {
+                    top.quantity += next->second;
+                    top.notional += next->first * next->second;
+                    top.last_price = next->first;
+                } else if (--top.count == 0) {
+                    top = TopLevels();      // Side emptied: drop rounding residue
+                } else if (price == top.last_price) {
+                    top.last_price = std::prev(it)->first;
+                }
+            }
+            side.erase(it);
+        } else {
+            return;
+        }
+        
+        if (++top.updates >= TopLevels::RESUM_INTERVAL) {
+            resum(side, top);
+        }
+    }
+    
+    template<typename Side>
+    static void resum(const Side& side, TopLevels& top) {
+        top.quantity = 0.0;
+        top.notional = 0.0;
+        top.updates = 0;
+        size_t level = 0;
+        for (auto it = side.begin(); it != side.end() && level < top.count; ++it, ++level) {
+            top.quantity += it->second;
+            top.notional += it->first * it->second;
+        }
+    }
+    
+    // Mark the ladder stale from the level `price` occupies (or would
+    // occupy), found by binary search on the cached prices
+    template<typename Compare>
+    static void invalidate(const DepthLadder& ladder, size_t& dirty_from, double price, Compare better) {
+        size_t valid = std::min(dirty_from, ladder.levels);
+        auto it = std::lower_bound(ladder.price.begin(), ladder.price.begin() + valid, price, better);
+        size_t level = static_cast<size_t>(it - ladder.price.begin());
+        
+        // Beyond a full, valid ladder: nothing cached changes
+        if (level == valid && valid == DepthLadder::LEVELS) return;
+        dirty_from = std::min(dirty_from, level);
+    }
+    
+    template<typename Side>
+    static void refresh(const Side& side, DepthLadder& ladder, size_t& dirty_from) {
+        if (dirty_from == DepthLadder::LEVELS) return;
+        
+        // Resume after the last still-valid level
+        size_t from = std::min(dirty_from, ladder.levels);
+        auto it = from == 0 ? side.begin() : side.upper_bound(ladder.price[from - 1]);
+        double cum_quantity = from == 0 ? 0.0 : ladder.cum_quantity[from - 1];
+        double cum_notional = from == 0 ? 0.0 : ladder.cum_notional[from - 1];
+        
+        size_t level = from;
+        for (; level < DepthLadder::LEVELS && it != side.end(); ++level, ++it) {
+            cum_quantity += it->second;
+            cum_notional += it->first * it->second;
+            ladder.price[level] = it->first;
+            ladder.quantity[level] = it->second;
+            ladder.cum_quantity[level] = cum_quantity;
+            ladder.cum_notional[level] = cum_notional;
+        }
+        ladder.levels = level;
+        dirty_from = DepthLadder::LEVELS;
+    }
 };
 
 } // namespace trading
@@ -2,6 +2,7 @@
 
 #include "../core/types.hpp"
 #include "../core/circular_buffer.hpp"
+#include "../core/timer_wheel.hpp"
 #include <cmath>
 #include <mutex>
 #include <atomic>
@@ -66,7 +67,8 @@ public:
         double fill_price;
         double fill_quantity;
         TimePoint fill_time;
-        double price_after_500ms;           // Price 500ms later
+        uint64_t sequence;                  // Position in the fill stream (markout timer key)
+        double price_after_500ms;           // Price price_movement_window_ms later
         bool was_adverse;                   // Did price move against us?
         double adverse_move_bps;            // How much it moved
         
@@ -74,6 +76,7 @@ public:
             : our_side(Side::BUY)
             , fill_price(0.0)
             , fill_quantity(0.0)
+            , sequence(0)
             , price_after_500ms(0.0)
             , was_adverse(false)
             , adverse_move_bps(0.0)
@@ -83,12 +86,14 @@ public:
     explicit AdverseSelectionFilter(const Config& config)
         : config_(config)
         , fill_history_(config.lookback_trades)
+        , markout_timers_(std::chrono::milliseconds(1))
         , cached_toxicity_score_(0.0)
         , cached_spread_mult_(1.0)
         , needs_recalc_(true)
     {}
     
-    // Record a fill (THREAD-SAFE) - circular buffer auto-manages size
+    // Record a fill (THREAD-SAFE) - circular buffer auto-manages size;
+    // its markout is scheduled price_movement_window_ms out
     void record_fill(Side our_side, double price, double quantity) {
         std::lock_guard<std::mutex> lock(fills_mutex_);
         
@@ -97,52 +102,35 @@ public:
         fill.fill_price = price;
         fill.fill_quantity = quantity;
         fill.fill_time = Clock::now();
+        fill.sequence = next_sequence_++;
         
         fill_history_.push_back(fill);  // Auto-overwrites oldest
+        markout_timers_.schedule(fill.fill_time + std::chrono::milliseconds(config_.price_movement_window_ms),
+                                 fill.sequence);
         
         needs_recalc_.store(true, std::memory_order_release);
     }
     
-    // Update price information (call periodically) - THREAD-SAFE
+    // Update price information (call on every price change) - THREAD-SAFE
+    // Markouts that came due since the last update are valued at the price
+    // that was live at their deadline, i.e. the one before this update.
     void update_current_price(double price) {
         std::lock_guard<std::mutex> lock(fills_mutex_);
         
         auto now = Clock::now();
+        double markout_price = last_price_ > 0.0 ? last_price_ : price;
         bool any_updated = false;
         
-        // Check old fills - circular buffer supports range-based for
-        for (auto& fill : fill_history_) {
-            if (fill.price_after_500ms > 0.0) {
-                continue;  // Already analyzed
-            }
-            
-            auto age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - fill.fill_time
-            ).count();
+        markout_timers_.advance(now, [&](uint64_t sequence) {
+            // Overwritten by newer fills before its markout
+            uint64_t oldest = next_sequence_ - fill_history_.size();
+            if (sequence < oldest) return;
             
-            if (age_ms >= config_.price_movement_window_ms) {
-                fill.price_after_500ms = price;
-                
-                // Check if adverse
-                if (fill.our_side == Side::BUY) {
-                    // We bought, adverse if price went down
-                    double move_bps = ((price - fill.fill_price) / fill.fill_price) * 10000.0;
-                    fill.adverse_move_bps = move_bps;
-                    fill.was_adverse = (move_bps < -config_.significant_price_move_bps);
-                } else {
-                    // We sold, adverse if price went up
-                    double move_bps = ((price - fill.fill_price) / fill.fill_price) * 10000.0;
-                    fill.adverse_move_bps = move_bps;
-                    fill.was_adverse = (move_bps > config_.significant_price_move_bps);
-                }
-                
-                if (fill.was_adverse) {
-                    last_toxic_fill_time_ = now;
-                }
-                
-                any_updated = true;
-            }
-        }
+            stamp_markout(fill_history_[static_cast<size_t>(sequence - oldest)], markout_price, now);
+            any_updated = true;
+        });
+        
+        last_price_ = price;
         
         if (any_updated) {
             needs_recalc_.store(true, std::memory_order_release);
@@ -240,8 +228,10 @@ public:
         return calculate_toxicity().recommended_spread_mult;
     }
     
-    // Reset history (e.g., new trading session)
+    // Reset history (e.g., new trading session); pending markouts of
+    // cleared fills are dropped when they fire
     void reset() {
+        std::lock_guard<std::mutex> lock(fills_mutex_);
         fill_history_.clear();
         last_toxic_fill_time_ = TimePoint{};
     }
@@ -302,6 +292,27 @@ private:
     CircularBuffer<FillEvent> fill_history_;
     TimePoint last_toxic_fill_time_;
     
+    // Markout timers keyed by fill sequence
+    TimerWheel<uint64_t> markout_timers_;
+    uint64_t next_sequence_ = 0;
+    double last_price_ = 0.0;
+    
+    void stamp_markout(FillEvent& fill, double price, TimePoint now) {
+        fill.price_after_500ms = price;
+        
+        double move_bps = ((price - fill.fill_price) / fill.fill_price) * 10000.0;
+        fill.adverse_move_bps = move_bps;
+        
+        // Bought: adverse if price went down. Sold: adverse if it went up.
+        fill.was_adverse = fill.our_side == Side::BUY
+            ? (move_bps < -config_.significant_price_move_bps)
+            : (move_bps > config_.significant_price_move_bps);
+        
+        if (fill.was_adverse) {
+            last_toxic_fill_time_ = now;
+        }
+    }
+    
     // Thread safety
     mutable std::mutex fills_mutex_;
     
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../market_data/order_book.hpp"
+#include <algorithm>
+
+namespace trading {
+
+// Result of sizing a two-venue arbitrage against book depth
+struct ArbSizing {
+    double quantity;                // Profit-maximizing quantity (0 = no edge)
+    double buy_notional;            // Before fees
+    double sell_notional;
+    double expected_pnl;            // After per-venue fees
+    double buy_limit;               // Worst ask level used (IOC limit)
+    double sell_limit;              // Worst bid level used
+    size_t buy_levels;              // Levels consumed on each side
+    size_t sell_levels;
+    
+    ArbSizing()
+        : quantity(0.0)
+        , buy_notional(0.0)
+        , sell_notional(0.0)
+        , expected_pnl(0.0)
+        , buy_limit(0.0)
+        , sell_limit(0.0)
+        , buy_levels(0)
+        , sell_levels(0)
+    {}
+    
+    double buy_vwap() const { return quantity > 0.0 ? buy_notional / quantity : 0.0; }
+    double sell_vwap() const { return quantity > 0.0 ? sell_notional / quantity : 0.0; }
+    
+    // VWAP slippage against the touch on both legs, in bps
+    double slippage_bps(double best_ask, double best_bid) const {
+        if (quantity <= 0.0) return 0.0;
+        return ((buy_vwap() - best_ask) / best_ask + (best_bid - sell_vwap()) / best_bid) * 10000.0;
+    }
+};
+
+// Depth-aware arb sizing - merge walk of the buy venue's ask ladder and the
+// sell venue's bid ladder. Marginal profit per unit (bid after fee minus ask
+// after fee) only falls as the walk goes deeper, so taking quantity while
+// it is positive gives the profit-maximizing size in one pass over at most
+// asks.levels + bids.levels segments. Capped at max_buy_notional.
+inline ArbSizing optimize_arb_size(const DepthLadder& asks, double buy_fee_bps,
+                                   const DepthLadder& bids, double sell_fee_bps,
+                                   double max_buy_notional) {
+    ArbSizing sizing;
+    double buy_cost = 1.0 + buy_fee_bps / 10000.0;
+    double sell_keep = 1.0 - sell_fee_bps / 10000.0;
+    
+    size_t i = 0, j = 0;
+    while (i < asks.levels && j < bids.levels) {
+        double ask = asks.price[i];
+        double bid = bids.price[j];
+        if (bid * sell_keep <= ask * buy_cost) break;
+        
+        // Up to the next level boundary on either side, or the notional cap
+        double next = std::min(asks.cum_quantity[i], bids.cum_quantity[j]);
+        double take = next - sizing.quantity;
+        double cap = (max_buy_notional - sizing.buy_notional) / ask;
+        bool capped = cap < take;
+        if (capped) take = cap;
+        if (take <= 0.0) break;
+        
+        sizing.quantity = capped ? sizing.quantity + take : next;
+        sizing.buy_notional += take * ask;
+        sizing.sell_notional += take * bid;
+        sizing.buy_limit = ask;
+        sizing.sell_limit = bid;
+        sizing.buy_levels = i + 1;
+        sizing.sell_levels = j + 1;
+        
+        if (capped) break;
+        if (asks.cum_quantity[i] <= next) ++i;
+        if (bids.cum_quantity[j] <= next) ++j;
+    }
+    
+    sizing.expected_pnl = sizing.sell_notional * sell_keep - sizing.buy_notional * buy_cost;
+    return sizing;
+}
+
+} // namespace trading
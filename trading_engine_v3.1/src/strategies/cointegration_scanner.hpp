@@ -0,0 +1,344 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/string_interning.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace trading {
+
+// Candidate pair found by the scanner (symbol1 regressed on symbol2)
+struct PairCandidate {
+    SymbolRegistry::SymbolId symbol1;
+    SymbolRegistry::SymbolId symbol2;
+    double correlation;             // Log prices
+    double hedge_ratio;             // OLS beta: log p1 = alpha + beta * log p2
+    double adf_statistic;           // Engle-Granger t-stat on the residual (more negative = stronger)
+    double half_life;               // Mean reversion half-life, in samples
+
+    PairCandidate()
+        : symbol1(SymbolRegistry::INVALID_SYMBOL)
+        , symbol2(SymbolRegistry::INVALID_SYMBOL)
+        , correlation(0.0)
+        , hedge_ratio(0.0)
+        , adf_statistic(0.0)
+        , half_life(0.0)
+    {}
+};
+
+// Cointegration scanner - background search for tradeable pairs
+//
+// The market data thread records prices with record() (one relaxed store).
+// The scanner thread samples them every sample_interval into per-symbol
+// rings and, every scan_interval, tests every symbol pair in parallel
+// (Engle-Granger: OLS of log prices, then a Dickey-Fuller regression on the
+// residual). Pairs that pass correlation, ADF and half-life filters are
+// ranked by ADF statistic and the top max_pairs published as the active set;
+// version() changes whenever a new set is published.
+class CointegrationScanner {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    struct Config {
+        size_t max_symbols;                     // Capacity (indexed by SymbolId)
+        size_t history_length;                  // Samples per symbol used in the test
+        size_t min_samples;                     // Symbol ignored until this many samples
+        double min_correlation;
+        double adf_critical_value;              // Engle-Granger 5% (2 variables) ~ -3.34
+        double min_half_life;                   // Samples
+        double max_half_life;
+        size_t max_pairs;                       // Active set size
+        std::chrono::milliseconds sample_interval;
+        std::chrono::milliseconds scan_interval;
+        int worker_threads;                     // Threads testing pairs (>= 1)
+        int scanner_core;                       // CPU to pin scanner thread (-1 = none)
+
+        Config()
+            : max_symbols(256)
+            , history_length(500)
+            , min_samples(200)
+            , min_correlation(0.75)
+            , adf_critical_value(-3.34)
+            , min_half_life(5.0)
+            , max_half_life(250.0)
+            , max_pairs(20)
+            , sample_interval(1000)
+            , scan_interval(60000)
+            , worker_threads(2)
+            , scanner_core(-1)
+        {}
+    };
+
+    explicit CointegrationScanner(const Config& config = Config())
+        : config_(config)
+        , latest_(config.max_symbols)
+        , history_(config.max_symbols * config.history_length, 0.0)
+        , samples_(config.max_symbols, 0)
+    {
+        if (config.max_symbols == 0 || config.history_length < 3 ||
+            config.min_samples < 3 || config.min_samples > config.history_length) {
+            throw std::invalid_argument("CointegrationScanner needs 3 <= min_samples <= history_length");
+        }
+
+        for (auto& price : latest_) {
+            price.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    ~CointegrationScanner() {
+        stop();
+    }
+
+    CointegrationScanner(const CointegrationScanner&) = delete;
+    CointegrationScanner& operator=(const CointegrationScanner&) = delete;
+
+    // Hot path: latest price for a symbol (picked up at the next sample)
+    void record(SymbolId symbol, double price) {
+        if (symbol < config_.max_symbols && price > 0.0) {
+            latest_[symbol].store(price, std::memory_order_relaxed);
+        }
+    }
+
+    // Bumped every time a new active set is published
+    uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    std::vector<PairCandidate> candidates() const {
+        std::lock_guard<std::mutex> lock(published_mutex_);
+        return published_;
+    }
+
+    // ===== Scanner thread =====
+
+    void start() {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        worker_ = std::thread([this] { run(); });
+
+#if defined(__linux__)
+        if (config_.scanner_core >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.scanner_core, &cpuset);
+            pthread_setaffinity_np(worker_.native_handle(), sizeof(cpu_set_t), &cpuset);
+        }
+#endif
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // Copy the latest prices into the history rings - used by the scanner
+    // thread, callable directly when the caller drives scheduling (replay)
+    void sample() {
+        size_t length = config_.history_length;
+        for (size_t s = 0; s < config_.max_symbols; ++s) {
+            double price = latest_[s].load(std::memory_order_relaxed);
+            if (price <= 0.0) continue;
+
+            history_[s * length + samples_[s] % length] = std::log(price);
+            ++samples_[s];
+        }
+    }
+
+    // Test every eligible pair and publish the best - see sample()
+    void scan() {
+        // 1. Time-ordered log-price series for symbols with enough history,
+        //    over the longest window they all share
+        size_t length = config_.history_length;
+        universe_.clear();
+        for (size_t s = 0; s < config_.max_symbols; ++s) {
+            if (samples_[s] >= config_.min_samples) {
+                universe_.push_back(static_cast<SymbolId>(s));
+                length = std::min<size_t>(length, samples_[s]);
+            }
+        }
+
+        series_.resize(universe_.size() * length);
+        for (size_t u = 0; u < universe_.size(); ++u) {
+            linearize(universe_[u], length, series_.data() + u * length);
+        }
+
+        // 2. Every pair (i < j), interleaved across workers
+        size_t n = universe_.size();
+        size_t num_pairs = n < 2 ? 0 : n * (n - 1) / 2;
+        size_t workers = std::max<size_t>(1, static_cast<size_t>(config_.worker_threads));
+        workers = std::min(workers, std::max<size_t>(1, num_pairs));
+
+        std::vector<std::vector<PairCandidate>> found(workers);
+        std::vector<std::thread> helpers;
+        helpers.reserve(workers - 1);
+        for (size_t w = 1; w < workers; ++w) {
+            helpers.emplace_back([this, w, workers, length, &found] {
+                test_pairs(w, workers, length, found[w]);
+            });
+        }
+        test_pairs(0, workers, length, found[0]);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        // 3. Rank and publish
+        std::vector<PairCandidate> ranked;
+        for (auto& bucket : found) {
+            ranked.insert(ranked.end(), bucket.begin(), bucket.end());
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const PairCandidate& a, const PairCandidate& b) {
+            return a.adf_statistic < b.adf_statistic;
+        });
+        if (ranked.size() > config_.max_pairs) {
+            ranked.resize(config_.max_pairs);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(published_mutex_);
+            published_ = std::move(ranked);
+        }
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+private:
+    Config config_;
+
+    std::vector<std::atomic<double>> latest_;   // Written by record(), read by sample()
+
+    // Scanner thread state (single writer)
+    std::vector<double> history_;               // Log-price rings, history_length per symbol
+    std::vector<uint64_t> samples_;
+    std::vector<SymbolId> universe_;
+    std::vector<double> series_;                // Time-ordered rows, one per universe symbol
+
+    mutable std::mutex published_mutex_;
+    std::vector<PairCandidate> published_;
+    std::atomic<uint64_t> version_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+
+    void run() {
+        auto next_sample = Clock::now();
+        auto next_scan = next_sample + config_.scan_interval;
+
+        while (running_.load(std::memory_order_acquire)) {
+            next_sample += config_.sample_interval;
+            std::this_thread::sleep_until(next_sample);
+            sample();
+
+            if (Clock::now() >= next_scan) {
+                scan();
+                next_scan += config_.scan_interval;
+            }
+        }
+    }
+
+    // Last `length` samples of a symbol, oldest first
+    void linearize(SymbolId symbol, size_t length, double* out) const {
+        size_t capacity = config_.history_length;
+        const double* ring = history_.data() + symbol * capacity;
+        uint64_t end = samples_[symbol];
+        for (size_t t = 0; t < length; ++t) {
+            out[t] = ring[(end - length + t) % capacity];
+        }
+    }
+
+    void test_pairs(size_t worker, size_t workers, size_t length, std::vector<PairCandidate>& out) const {
+        size_t n = universe_.size();
+        size_t index = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j, ++index) {
+                if (index % workers != worker) continue;
+
+                PairCandidate candidate;
+                if (test_pair(series_.data() + i * length, series_.data() + j * length, length, candidate)) {
+                    candidate.symbol1 = universe_[i];
+                    candidate.symbol2 = universe_[j];
+                    out.push_back(candidate);
+                }
+            }
+        }
+    }
+
+    // Engle-Granger on y (symbol1) vs x (symbol2)
+    bool test_pair(const double* y, const double* x, size_t n, PairCandidate& result) const {
+        // Correlation + OLS hedge ratio
+        double mean_x = 0.0, mean_y = 0.0;
+        for (size_t t = 0; t < n; ++t) {
+            mean_x += x[t];
+            mean_y += y[t];
+        }
+        mean_x /= n;
+        mean_y /= n;
+
+        double sxx = 0.0, syy = 0.0, sxy = 0.0;
+        for (size_t t = 0; t < n; ++t) {
+            double dx = x[t] - mean_x;
+            double dy = y[t] - mean_y;
+            sxx += dx * dx;
+            syy += dy * dy;
+            sxy += dx * dy;
+        }
+        if (sxx < 1e-12 || syy < 1e-12) return false;
+
+        double correlation = sxy / std::sqrt(sxx * syy);
+        if (correlation < config_.min_correlation) return false;
+
+        double beta = sxy / sxx;
+        double alpha = mean_y - beta * mean_x;
+
+        // Dickey-Fuller on the residual: de_t = gamma * e_{t-1} + u_t
+        double see = 0.0, sde = 0.0;
+        double prev = y[0] - alpha - beta * x[0];
+        for (size_t t = 1; t < n; ++t) {
+            double e = y[t] - alpha - beta * x[t];
+            see += prev * prev;
+            sde += prev * (e - prev);
+            prev = e;
+        }
+        if (see < 1e-18) return false;
+
+        double gamma = sde / see;
+
+        double sse = 0.0;
+        prev = y[0] - alpha - beta * x[0];
+        for (size_t t = 1; t < n; ++t) {
+            double e = y[t] - alpha - beta * x[t];
+            double u = (e - prev) - gamma * prev;
+            sse += u * u;
+            prev = e;
+        }
+        double se = std::sqrt(sse / static_cast<double>(n - 2) / see);
+        if (se <= 0.0) return false;
+
+        double adf = gamma / se;
+        if (adf > config_.adf_critical_value || gamma >= 0.0 || gamma <= -1.0) return false;
+
+        double half_life = -std::log(2.0) / std::log(1.0 + gamma);
+        if (half_life < config_.min_half_life || half_life > config_.max_half_life) return false;
+
+        result.correlation = correlation;
+        result.hedge_ratio = beta;
+        result.adf_statistic = adf;
+        result.half_life = half_life;
+        return true;
+    }
+};
+
+} // namespace trading
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "../core/types.hpp"
+#include "../core/fee_engine.hpp"
+#include "../core/order_intent.hpp"
 #include "../market_data/order_book.hpp"
+#include "../market_data/consolidated_bbo.hpp"
+#include "arb_sizing.hpp"
+#include "triangular_arbitrage.hpp"
 #include <unordered_map>
 #include <optional>
 
@@ -16,7 +21,7 @@ public:
         double max_execution_latency_us;    // Max execution time (100-500μs)
         double position_size_usd;           // Size per arb
         int max_concurrent_arbs;            // Max simultaneous arbitrages
-        double fee_bps;                     // Total fees (both sides)
+        double fee_bps;                     // Total fees (both sides) without a fee engine
         
         Config()
             : venues({Venue::BINANCE, Venue::BYBIT, Venue::COINBASE})
@@ -76,16 +81,40 @@ public:
     {
         // Precompute all venue pairs once
         for (size_t i = 0; i < config_.venues.size(); ++i) {
+            venue_mask_ |= venue_bit(config_.venues[i]);
             for (size_t j = i + 1; j < config_.venues.size(); ++j) {
                 venue_pairs_.emplace_back(config_.venues[i], config_.venues[j]);
             }
         }
     }
     
-    // Detect arbitrage opportunities across venues
+    // Detect arbitrage opportunities across venues (per-venue books)
     std::optional<ArbitrageOpportunity> detect_opportunity(
         const std::string& symbol,
         const std::unordered_map<Venue, OrderBook>& books)
+    {
+        InstrumentBBO bbo;
+        for (Venue venue : config_.venues) {
+            auto it = books.find(venue);
+            if (it != books.end()) {
+                bbo.update(venue, it->second);
+            }
+        }
+        return detect_opportunity(symbol, bbo, &books);
+    }
+    
+    // Detect arbitrage from the consolidated BBO - O(1) when the global best
+    // bid and ask sit on two monitored venues, O(log V) when one venue holds
+    // both (runner-up on either side). Falls back to the venue pairs only
+    // when a best quote or runner-up is on an unmonitored venue. With a fee engine,
+    // venue fees can reorder the pairs, so every pair is checked - but only
+    // once the raw touch edge (an upper bound on any pair's) clears the
+    // threshold. With books, the chosen venue pair is sized against depth
+    // (see size_with_depth).
+    std::optional<ArbitrageOpportunity> detect_opportunity(
+        const std::string& symbol,
+        const InstrumentBBO& bbo,
+        const std::unordered_map<Venue, OrderBook>* books = nullptr)
     {
         auto start = Clock::now();
         
@@ -96,25 +125,38 @@ public:
         
         ArbitrageOpportunity best_opp;
         best_opp.symbol = symbol;
+        SymbolRegistry::SymbolId symbol_id = fee_engine_ ? get_symbol_id(symbol) : SymbolRegistry::INVALID_SYMBOL;
         
-        // Use precomputed venue pairs - O(n) not O(n²)
-        for (const auto& pair : venue_pairs_) {
-            Venue venue1 = pair.first;
-            Venue venue2 = pair.second;
-            
-            auto book1_it = books.find(venue1);
-            auto book2_it = books.find(venue2);
-            
-            if (book1_it == books.end() || book2_it == books.end()) {
-                continue;
+        Venue buy_venue = bbo.best_ask_venue();
+        Venue sell_venue = bbo.best_bid_venue();
+        
+        if (fee_engine_) {
+            double best_ask = bbo.best_ask();
+            double raw_edge_bps = best_ask > 0.0 ? (bbo.best_bid() - best_ask) / best_ask * 10000.0 : 0.0;
+            if (raw_edge_bps >= config_.min_profit_bps) {
+                check_venue_pairs(symbol_id, bbo, best_opp);
             }
-            
-            const auto& book1 = book1_it->second;
-            const auto& book2 = book2_it->second;
-            
-            // Check both directions
-            check_arb_direction(symbol, venue1, book1, venue2, book2, best_opp);
-            check_arb_direction(symbol, venue2, book2, venue1, book1, best_opp);
+        } else if (monitored(buy_venue) && monitored(sell_venue)) {
+            if (buy_venue != sell_venue) {
+                check_arb_direction(symbol_id, buy_venue, sell_venue, bbo, best_opp);
+            } else {
+                Venue other_buy = bbo.best_ask_venue_excluding(sell_venue);
+                Venue other_sell = bbo.best_bid_venue_excluding(buy_venue);
+                if ((other_buy != Venue::UNKNOWN && !monitored(other_buy)) ||
+                    (other_sell != Venue::UNKNOWN && !monitored(other_sell))) {
+                    // A runner-up is unmonitored: the best monitored one may sit behind it
+                    check_venue_pairs(symbol_id, bbo, best_opp);
+                } else {
+                    if (monitored(other_buy)) check_arb_direction(symbol_id, other_buy, sell_venue, bbo, best_opp);
+                    if (monitored(other_sell)) check_arb_direction(symbol_id, buy_venue, other_sell, bbo, best_opp);
+                }
+            }
+        } else {
+            check_venue_pairs(symbol_id, bbo, best_opp);
+        }
+        
+        if (books && best_opp.net_profit_bps >= config_.min_profit_bps) {
+            size_with_depth(symbol_id, *books, best_opp);
         }
         
         auto end = Clock::now();
@@ -134,6 +176,12 @@ public:
         return std::nullopt;
     }
     
+    // Per-venue taker fees (optional; replaces Config::fee_bps). Taker fees
+    // are assumed non-negative - see detect_opportunity().
+    void attach_fee_engine(const FeeEngine* fees) {
+        fee_engine_ = fees;
+    }
+    
     // Create orders for arbitrage execution
     std::pair<Order, Order> create_arb_orders(const ArbitrageOpportunity& opp) {
         // Buy order (cheap venue)
@@ -145,6 +193,7 @@ public:
         buy_order.price = opp.buy_price;
         buy_order.quantity = opp.execute_quantity;
         buy_order.strategy_name = "LATENCY_ARB";
+        buy_order.strategy = StrategyKind::LATENCY_ARB;
         buy_order.created_time = Clock::now();
         
         // Sell order (expensive venue)
@@ -156,6 +205,7 @@ public:
         sell_order.price = opp.sell_price;
         sell_order.quantity = opp.execute_quantity;
         sell_order.strategy_name = "LATENCY_ARB";
+        sell_order.strategy = StrategyKind::LATENCY_ARB;
         sell_order.created_time = Clock::now();
         
         // Track active arb
@@ -164,6 +214,18 @@ public:
         return {buy_order, sell_order};
     }
     
+    // Same legs (buy, then sell) appended to the tick's intent buffer
+    void emplace_arb_orders(OrderIntentBuffer& out, SymbolRegistry::SymbolId symbol,
+                            const ArbitrageOpportunity& opp) {
+        TimePoint now = Clock::now();
+        out.emplace(symbol, opp.buy_venue, Side::BUY, OrderType::LIMIT_IOC,
+                    opp.buy_price, opp.execute_quantity, StrategyKind::LATENCY_ARB, now);
+        out.emplace(symbol, opp.sell_venue, Side::SELL, OrderType::LIMIT_IOC,
+                    opp.sell_price, opp.execute_quantity, StrategyKind::LATENCY_ARB, now);
+        
+        active_arbs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
     // Mark arb as completed
     void complete_arbitrage() {
         active_arbs_.fetch_sub(1, std::memory_order_relaxed);
@@ -231,17 +293,44 @@ private:
     
     // Precomputed venue pairs for efficient iteration
     std::vector<std::pair<Venue, Venue>> venue_pairs_;
+    uint32_t venue_mask_ = 0;               // Bit per configured venue
+    const FeeEngine* fee_engine_ = nullptr;
+    
+    static uint32_t venue_bit(Venue venue) {
+        return uint32_t(1) << static_cast<uint32_t>(venue);
+    }
+    
+    bool monitored(Venue venue) const {
+        return venue != Venue::UNKNOWN && (venue_mask_ & venue_bit(venue));
+    }
+    
+    // Both directions of every monitored venue pair
+    void check_venue_pairs(SymbolRegistry::SymbolId symbol_id, const InstrumentBBO& bbo,
+                           ArbitrageOpportunity& best_opp) {
+        for (const auto& [venue1, venue2] : venue_pairs_) {
+            check_arb_direction(symbol_id, venue1, venue2, bbo, best_opp);
+            check_arb_direction(symbol_id, venue2, venue1, bbo, best_opp);
+        }
+    }
+    
+    // Taker fee for one leg (IOC orders always take)
+    double leg_fee_bps(SymbolRegistry::SymbolId symbol_id, Venue venue) const {
+        return fee_engine_ ? fee_engine_->taker_bps(symbol_id, venue) : config_.fee_bps / 2.0;
+    }
     
-    // Check arbitrage in one direction
+    // Check arbitrage in one direction (buy the ask on buy_venue, sell the
+    // bid on sell_venue)
     void check_arb_direction(
-        const std::string& symbol,
-        Venue buy_venue, const OrderBook& buy_book,
-        Venue sell_venue, const OrderBook& sell_book,
+        SymbolRegistry::SymbolId symbol_id,
+        Venue buy_venue, Venue sell_venue,
+        const InstrumentBBO& bbo,
         ArbitrageOpportunity& best_opp)
     {
-        // Get best bid/ask from each venue
-        double buy_ask = buy_book.get_best_ask();   // Buy here (cross the spread)
-        double sell_bid = sell_book.get_best_bid(); // Sell here (cross the spread)
+        const auto& buy_touch = bbo.touch(buy_venue);
+        const auto& sell_touch = bbo.touch(sell_venue);
+        
+        double buy_ask = buy_touch.ask;     // Buy here (cross the spread)
+        double sell_bid = sell_touch.bid;   // Sell here (cross the spread)
         
         if (buy_ask <= 0.0 || sell_bid <= 0.0) {
             return;
@@ -249,23 +338,21 @@ private:
         
         // Calculate profit
         double gross_profit_bps = ((sell_bid - buy_ask) / buy_ask) * 10000.0;
-        double net_profit_bps = gross_profit_bps - config_.fee_bps;
+        double net_profit_bps = gross_profit_bps - leg_fee_bps(symbol_id, buy_venue)
+                                                 - leg_fee_bps(symbol_id, sell_venue);
         
         if (net_profit_bps <= best_opp.net_profit_bps) {
             return;  // Not better than current best
         }
         
-        // Get available quantities
-        const auto& buy_asks = buy_book.get_asks();
-        const auto& sell_bids = sell_book.get_bids();
+        // Available quantities at the touch
+        double buy_qty = buy_touch.ask_qty;
+        double sell_qty = sell_touch.bid_qty;
         
-        if (buy_asks.empty() || sell_bids.empty()) {
+        if (buy_qty <= 0.0 || sell_qty <= 0.0) {
             return;
         }
         
-        double buy_qty = buy_asks.begin()->second;
-        double sell_qty = sell_bids.begin()->second;
-        
         // Execute quantity is minimum of both sides
         double max_qty = std::min(buy_qty, sell_qty);
         double max_notional = max_qty * buy_ask;
@@ -286,51 +373,41 @@ private:
         best_opp.execute_quantity = execute_qty;
         best_opp.expected_profit_usd = (net_profit_bps / 10000.0) * target_notional;
     }
-};
-
-// Triangular arbitrage (e.g., BTC → ETH → SOL → BTC)
-class TriangularArbitrageStrategy {
-public:
-    struct Config {
-        std::vector<std::string> triangle;  // e.g., ["BTC", "ETH", "SOL"]
-        double min_profit_bps;
-        double max_slippage_bps;
-        
-        Config()
-            : triangle({"BTC", "ETH", "SOL"})
-            , min_profit_bps(15.0)
-            , max_slippage_bps(5.0)
-        {}
-    };
     
-    struct TriangularOpportunity {
-        std::vector<std::string> symbols;
-        std::vector<Side> sides;
-        std::vector<double> prices;
-        double net_profit_bps;
-        bool is_valid;
-        
-        TriangularOpportunity() 
-            : net_profit_bps(0.0), is_valid(false) {}
-    };
-    
-    explicit TriangularArbitrageStrategy(const Config& config) : config_(config) {}
-    
-    // Detect triangular arbitrage
-    std::optional<TriangularOpportunity> detect_opportunity(
-        const std::unordered_map<std::string, OrderBook>& books)
+    // Re-size a touch opportunity against both books' depth ladders. Prices
+    // become the worst level crossed so the IOC limits reach every level in
+    // the size; the edge is recomputed for the sized notional, so validation
+    // and logging see what the trade actually earns.
+    void size_with_depth(SymbolRegistry::SymbolId symbol_id,
+                         const std::unordered_map<Venue, OrderBook>& books,
+                         ArbitrageOpportunity& opp) const
     {
-        // Implementation for BTC → ETH → SOL → BTC cycle
-        // Calculate if (BTC/USD) * (ETH/BTC) * (SOL/ETH) * (USD/SOL) > 1.0
+        auto buy_it = books.find(opp.buy_venue);
+        auto sell_it = books.find(opp.sell_venue);
+        if (buy_it == books.end() || sell_it == books.end()) {
+            return;
+        }
         
-        // This requires cross-rate calculations and proper symbol mapping
-        // Left as exercise - would need more complex price chain logic
+        const auto& asks = buy_it->second.ask_ladder();
+        const auto& bids = sell_it->second.bid_ladder();
+        auto sizing = optimize_arb_size(asks, leg_fee_bps(symbol_id, opp.buy_venue),
+                                        bids, leg_fee_bps(symbol_id, opp.sell_venue),
+                                        config_.position_size_usd);
+        if (sizing.quantity <= 0.0) {
+            return;
+        }
         
-        return std::nullopt;
+        opp.buy_price = sizing.buy_limit;
+        opp.sell_price = sizing.sell_limit;
+        opp.buy_quantity_available = asks.cum_quantity[sizing.buy_levels - 1];
+        opp.sell_quantity_available = bids.cum_quantity[sizing.sell_levels - 1];
+        opp.execute_quantity = sizing.quantity;
+        opp.expected_profit_usd = sizing.expected_pnl;
+        
+        // Edge of the sized trade (average fill over the levels), not the touch
+        opp.gross_profit_bps = (sizing.sell_notional - sizing.buy_notional) / sizing.buy_notional * 10000.0;
+        opp.net_profit_bps = sizing.expected_pnl / sizing.buy_notional * 10000.0;
     }
-    
-private:
-    Config config_;
 };
 
 } // namespace trading
@@ -2,6 +2,9 @@
 
 #include "../core/types.hpp"
 #include "../market_data/order_book.hpp"
+#include "../market_data/feature_pipeline.hpp"
+#include "../core/symbol_map.hpp"
+#include "../core/order_intent.hpp"
 #include <deque>
 #include <cmath>
 
@@ -50,10 +53,6 @@ public:
     
     // Analyze order book and generate signal
     OBISignal analyze(const std::string& symbol, const OrderBook& book) {
-        OBISignal signal;
-        signal.symbol = symbol;
-        signal.generated_at = Clock::now();
-        
         // Calculate bid/ask volume in top N levels - EFFICIENT O(1)
         double bid_volume = 0.0;
         double ask_volume = 0.0;
@@ -76,49 +75,24 @@ public:
             ++ask_count;
         }
         
-        // Check minimum volume threshold
-        double total_volume = bid_volume + ask_volume;
-        if (total_volume < config_.min_volume_threshold) {
-            return signal;  // Not enough volume, skip
-        }
-        
-        // Calculate imbalance ratio: -1 (all asks) to +1 (all bids)
-        double imbalance = (bid_volume - ask_volume) / total_volume;
-        signal.imbalance_ratio = imbalance;
-        
-        // Generate signal if imbalance exceeds threshold
-        double abs_imbalance = std::abs(imbalance);
-        
-        if (abs_imbalance < config_.imbalance_threshold) {
-            return signal;  // Imbalance too small
-        }
-        
-        // Strong bid volume → predict price UP
-        if (imbalance > config_.imbalance_threshold) {
-            signal.predicted_direction = Side::BUY;
-            signal.confidence = std::min(abs_imbalance / 0.7, 1.0);  // Scale to 0-1
-            
-            double mid = book.get_mid_price();
-            signal.entry_price = mid;
-            signal.target_price = mid * (1.0 + config_.target_profit_bps / 10000.0);
-            signal.stop_price = mid * (1.0 - config_.stop_loss_bps / 10000.0);
-            signal.is_valid = true;
-        }
-        // Strong ask volume → predict price DOWN
-        else if (imbalance < -config_.imbalance_threshold) {
-            signal.predicted_direction = Side::SELL;
-            signal.confidence = std::min(abs_imbalance / 0.7, 1.0);
-            
-            double mid = book.get_mid_price();
-            signal.entry_price = mid;
-            signal.target_price = mid * (1.0 - config_.target_profit_bps / 10000.0);
-            signal.stop_price = mid * (1.0 + config_.stop_loss_bps / 10000.0);
-            signal.is_valid = true;
+        return make_signal(symbol, bid_volume, ask_volume, book.get_microprice());
+    }
+    
+    // Same signal from pipeline features (no book walk); invalid when the
+    // pipeline does not compute num_levels
+    OBISignal analyze(const std::string& symbol, const BookFeatures& features) {
+        int slot = features.depth_slot(static_cast<size_t>(config_.num_levels));
+        if (slot < 0) {
+            OBISignal signal;
+            signal.symbol = symbol;
+            signal.generated_at = Clock::now();
+            return signal;
         }
-        
-        return signal;
+        return make_signal(symbol, features.bid_volume[slot], features.ask_volume[slot], features.microprice);
     }
     
+    int num_levels() const { return config_.num_levels; }
+    
     // Check if signal has expired
     bool is_signal_expired(const OBISignal& signal) const {
         auto now = Clock::now();
@@ -138,11 +112,19 @@ public:
         order.price = signal.entry_price;
         order.quantity = quantity;
         order.strategy_name = "OBI";
+        order.strategy = StrategyKind::OBI;
         order.created_time = Clock::now();
         
         return order;
     }
     
+    // Same, appended to the tick's intent buffer (no strings, no allocation)
+    OrderIntent& emplace_order(OrderIntentBuffer& out, SymbolRegistry::SymbolId symbol, Venue venue,
+                               const OBISignal& signal, double quantity) const {
+        return out.emplace(symbol, venue, signal.predicted_direction, OrderType::LIMIT,
+                           signal.entry_price, quantity, StrategyKind::OBI);
+    }
+    
     // Historical tracking for analysis
     struct OBIStats {
         int total_signals;
@@ -186,6 +168,54 @@ public:
 private:
     Config config_;
     OBIStats stats_;
+    
+    // Signal from top-N bid/ask volume; entry, target and stop are set off
+    // the touch microprice rather than the raw mid
+    OBISignal make_signal(const std::string& symbol, double bid_volume, double ask_volume, double fair) const {
+        OBISignal signal;
+        signal.symbol = symbol;
+        signal.generated_at = Clock::now();
+        
+        // Check minimum volume threshold
+        double total_volume = bid_volume + ask_volume;
+        if (total_volume < config_.min_volume_threshold) {
+            return signal;  // Not enough volume, skip
+        }
+        
+        // Calculate imbalance ratio: -1 (all asks) to +1 (all bids)
+        double imbalance = (bid_volume - ask_volume) / total_volume;
+        signal.imbalance_ratio = imbalance;
+        
+        // Generate signal if imbalance exceeds threshold
+        double abs_imbalance = std::abs(imbalance);
+        
+        if (abs_imbalance < config_.imbalance_threshold) {
+            return signal;  // Imbalance too small
+        }
+        
+        // Strong bid volume → predict price UP
+        if (imbalance > config_.imbalance_threshold) {
+            signal.predicted_direction = Side::BUY;
+            signal.confidence = std::min(abs_imbalance / 0.7, 1.0);  // Scale to 0-1
+            
+            signal.entry_price = fair;
+            signal.target_price = fair * (1.0 + config_.target_profit_bps / 10000.0);
+            signal.stop_price = fair * (1.0 - config_.stop_loss_bps / 10000.0);
+            signal.is_valid = true;
+        }
+        // Strong ask volume → predict price DOWN
+        else if (imbalance < -config_.imbalance_threshold) {
+            signal.predicted_direction = Side::SELL;
+            signal.confidence = std::min(abs_imbalance / 0.7, 1.0);
+            
+            signal.entry_price = fair;
+            signal.target_price = fair * (1.0 - config_.target_profit_bps / 10000.0);
+            signal.stop_price = fair * (1.0 + config_.stop_loss_bps / 10000.0);
+            signal.is_valid = true;
+        }
+        
+        return signal;
+    }
 };
 
 // Multi-level imbalance (weighted by distance from mid)
@@ -237,6 +267,11 @@ public:
         return (weighted_bid_volume - weighted_ask_volume) / total;
     }
     
+    // Pipeline value, computed with FeaturePipeline::Config::level_weights
+    double calculate_weighted_imbalance(const BookFeatures& features) const {
+        return features.weighted_imbalance;
+    }
+    
 private:
     Config config_;
 };
@@ -254,6 +289,14 @@ public:
     explicit OBITracker(int history_size = 100) 
         : max_history_(history_size) {}
     
+    // Volumes from pipeline features (0 if it doesn't compute TRACKED_LEVELS)
+    void add_snapshot(const std::string& symbol, const BookFeatures& features, double imbalance) {
+        int slot = features.depth_slot(TRACKED_LEVELS);
+        record(symbol, imbalance,
+               slot < 0 ? 0.0 : features.bid_volume[slot],
+               slot < 0 ? 0.0 : features.ask_volume[slot]);
+    }
+    
     void add_snapshot(const std::string& symbol, const OrderBook& book, double imbalance) {
         const auto& bids = book.get_bids();
         const auto& asks = book.get_asks();
@@ -263,41 +306,29 @@ public:
         
         int count = 0;
         for (const auto& [price, qty] : bids) {
-            if (count >= 5) break;
+            if (count >= static_cast<int>(TRACKED_LEVELS)) break;
             bid_vol += qty;
             ++count;
         }
         
         count = 0;
         for (const auto& [price, qty] : asks) {
-            if (count >= 5) break;
+            if (count >= static_cast<int>(TRACKED_LEVELS)) break;
             ask_vol += qty;
             ++count;
         }
         
-        Snapshot snap;
-        snap.timestamp = Clock::now();
-        snap.imbalance = imbalance;
-        snap.bid_volume = bid_vol;
-        snap.ask_volume = ask_vol;
-        
-        auto& history = history_[symbol];
-        history.push_back(snap);
-        
-        // Bounded history - prevent memory leak
-        if (history.size() > max_history_) {
-            history.erase(history.begin());
-        }
+        record(symbol, imbalance, bid_vol, ask_vol);
     }
     
     // Get recent trend (are we getting more bullish or bearish?)
     double get_trend(const std::string& symbol, int lookback = 10) const {
-        auto it = history_.find(symbol);
-        if (it == history_.end() || it->second.size() < 2) {
+        const auto* history = history_.find(symbol);
+        if (!history || history->size() < 2) {
             return 0.0;
         }
         
-        const auto& hist = it->second;
+        const auto& hist = *history;
         int n = std::min(lookback, static_cast<int>(hist.size()));
         
         if (n < 2) return 0.0;
@@ -310,13 +341,31 @@ public:
     
     const std::vector<Snapshot>& get_history(const std::string& symbol) const {
         static std::vector<Snapshot> empty;
-        auto it = history_.find(symbol);
-        return it != history_.end() ? it->second : empty;
+        const auto* history = history_.find(symbol);
+        return history ? *history : empty;
     }
     
 private:
+    static constexpr size_t TRACKED_LEVELS = 5;
+    
     int max_history_;
-    std::unordered_map<std::string, std::vector<Snapshot>> history_;
+    SymbolMap<std::vector<Snapshot>> history_;  // Indexed by SymbolId
+    
+    void record(const std::string& symbol, double imbalance, double bid_vol, double ask_vol) {
+        Snapshot snap;
+        snap.timestamp = Clock::now();
+        snap.imbalance = imbalance;
+        snap.bid_volume = bid_vol;
+        snap.ask_volume = ask_vol;
+        
+        auto& history = history_[symbol];
+        history.push_back(snap);
+        
+        // Bounded history - prevent memory leak
+        if (history.size() > max_history_) {
+            history.erase(history.begin());
+        }
+    }
 };
 
 } // namespace trading
@@ -2,9 +2,18 @@
 
 #include "../core/types.hpp"
 #include "../core/circular_buffer.hpp"
+#include "../core/symbol_map.hpp"
+#include "../core/fee_engine.hpp"
+#include "../core/order_intent.hpp"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace trading {
 
 // Incremental statistics calculation (Welford's algorithm)
@@ -45,6 +54,112 @@ private:
     double m2_;  // Sum of squared differences from mean
 };
 
+// Rolling co-moments of (x, y) - O(1) add/remove (Welford-style)
+// Caller owns the window: remove() the value leaving before add()ing the new one.
+struct CoMoments {
+    int count = 0;
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    double m2_x = 0.0;          // Sum of squared deviations
+    double m2_y = 0.0;
+    double c_xy = 0.0;          // Sum of co-deviations
+    
+    void add(double x, double y) {
+        count++;
+        double dx = x - mean_x;
+        mean_x += dx / count;
+        double dy = y - mean_y;
+        mean_y += dy / count;
+        m2_x += dx * (x - mean_x);
+        m2_y += dy * (y - mean_y);
+        c_xy += dx * (y - mean_y);
+    }
+    
+    void remove(double x, double y) {
+        if (count <= 1) {
+            *this = CoMoments();
+            return;
+        }
+        count--;
+        double dx = x - mean_x;
+        mean_x -= dx / count;
+        double dy = y - mean_y;
+        mean_y -= dy / count;
+        m2_x -= dx * (x - mean_x);
+        m2_y -= dy * (y - mean_y);
+        c_xy -= (x - mean_x) * dy;      // Inverse of add(): new-mean x, old-mean y
+    }
+    
+    // Exact two-pass recomputation over a full window (drops add/remove drift)
+    void resum(const double* x, const double* y, size_t n) {
+        *this = CoMoments();
+        if (n == 0) return;
+        count = static_cast<int>(n);
+        for (size_t i = 0; i < n; ++i) {
+            mean_x += x[i];
+            mean_y += y[i];
+        }
+        mean_x /= count;
+        mean_y /= count;
+        for (size_t i = 0; i < n; ++i) {
+            double dx = x[i] - mean_x;
+            double dy = y[i] - mean_y;
+            m2_x += dx * dx;
+            m2_y += dy * dy;
+            c_xy += dx * dy;
+        }
+    }
+    
+    double correlation() const {
+        double denominator = std::sqrt(std::max(m2_x, 0.0) * std::max(m2_y, 0.0));
+        if (count < 2 || denominator < 1e-12) return 0.0;
+        return std::clamp(c_xy / denominator, -1.0, 1.0);
+    }
+};
+
+// Kalman-filter hedge ratio: y = alpha + beta * x + noise, with (alpha, beta)
+// a random walk. One 2-state update per tick; the innovation is the spread
+// and its forecast variance normalizes it into a z-score.
+struct KalmanHedgeRatio {
+    double alpha = 0.0;
+    double beta = 1.0;
+    double p00 = 1.0;           // State covariance (symmetric 2x2)
+    double p01 = 0.0;
+    double p11 = 1.0;
+    double spread = 0.0;        // Last innovation y - (alpha + beta * x)
+    double spread_var = 0.0;    // Its forecast variance
+    int updates = 0;
+    
+    void update(double x, double y, double delta, double observation_var) {
+        // Predict: P += W, W = delta / (1 - delta) * I
+        double w = delta / (1.0 - delta);
+        double r00 = p00 + w;
+        double r01 = p01;
+        double r11 = p11 + w;
+        
+        // Innovation with F = [1, x]
+        spread = y - (alpha + beta * x);
+        double f0 = r00 + r01 * x;          // R * F'
+        double f1 = r01 + r11 * x;
+        spread_var = f0 + f1 * x + observation_var;
+        
+        double k0 = f0 / spread_var;        // Kalman gain
+        double k1 = f1 / spread_var;
+        alpha += k0 * spread;
+        beta += k1 * spread;
+        
+        // P = R - K * F * R
+        p00 = r00 - k0 * f0;
+        p01 = r01 - k0 * f1;
+        p11 = r11 - k1 * f1;
+        updates++;
+    }
+    
+    double spread_z() const {
+        return spread_var > 0.0 ? spread / std::sqrt(spread_var) : 0.0;
+    }
+};
+
 // Pairs Trading - Mean reversion on correlated pairs
 class PairsTradingStrategy {
 public:
@@ -58,7 +173,12 @@ public:
         double stop_loss_z_score;           // Stop loss (3.0-4.0)
         
         double position_size_usd;           // Size per leg
-        double min_correlation;             // Min correlation (0.7-0.9)
+        double min_correlation;             // Min correlation (0.7-0.9) to enter
+        
+        // Kalman hedge ratio on log prices (log p1 = alpha + beta * log p2)
+        double kalman_delta;                // State drift (higher = adapts faster)
+        double kalman_observation_var;      // Spread noise variance
+        bool use_hedge_ratio;               // Size leg2 at beta x leg1 notional
         
         Config()
             : symbol1("ETHUSDT")
@@ -69,6 +189,9 @@ public:
             , stop_loss_z_score(3.5)
             , position_size_usd(5000.0)
             , min_correlation(0.75)
+            , kalman_delta(0.0001)
+            , kalman_observation_var(0.0001)
+            , use_hedge_ratio(false)
         {}
     };
     
@@ -83,6 +206,8 @@ public:
         double mean_ratio;                  // Historical mean
         double std_ratio;                   // Historical std dev
         double z_score;                     // How many std devs from mean
+        double correlation;                 // Rolling correlation of log prices
+        double hedge_ratio;                 // Kalman beta
         
         double entry_price1;
         double entry_price2;
@@ -102,6 +227,8 @@ public:
             , mean_ratio(0.0)
             , std_ratio(0.0)
             , z_score(0.0)
+            , correlation(0.0)
+            , hedge_ratio(1.0)
             , entry_price1(0.0)
             , entry_price2(0.0)
             , target_price1(0.0)
@@ -117,21 +244,31 @@ public:
         : config_(config)
         , stats_calculator_()
         , ratio_history_(config.lookback_period)
+        , log_price1_history_(config.lookback_period)
+        , log_price2_history_(config.lookback_period)
     {}
     
     // Update with new prices - EFFICIENT O(1) with circular buffer
     void update_prices(double price1, double price2) {
         double ratio = price1 / price2;
+        double log1 = std::log(price1);
+        double log2 = std::log(price2);
         
         // Circular buffer auto-overwrites oldest
         if (ratio_history_.full()) {
             double old_ratio = ratio_history_.front();
             stats_calculator_.pop_front(old_ratio);
+            comoments_.remove(log_price2_history_.front(), log_price1_history_.front());
         }
         
         ratio_history_.push_back(ratio);
         stats_calculator_.push(ratio);
         
+        log_price1_history_.push_back(log1);
+        log_price2_history_.push_back(log2);
+        comoments_.add(log2, log1);
+        kalman_.update(log2, log1, config_.kalman_delta, config_.kalman_observation_var);
+        
         // Update cached statistics
         if (stats_calculator_.count() >= 20) {
             mean_ratio_ = stats_calculator_.mean();
@@ -162,12 +299,18 @@ public:
         
         double z_score = (current_ratio - mean_ratio_) / std_ratio_;
         signal.z_score = z_score;
+        signal.correlation = calculate_correlation();
+        signal.hedge_ratio = kalman_.beta;
         
         // Check entry conditions
         if (std::abs(z_score) < config_.entry_z_score) {
             return signal;  // Not far enough from mean
         }
         
+        if (signal.correlation < config_.min_correlation) {
+            return signal;  // Pair has decoupled - divergence may not revert
+        }
+        
         // Ratio too high → short symbol1, long symbol2
         if (z_score > config_.entry_z_score) {
             signal.symbol1_side = Side::SELL;  // Short expensive
@@ -247,6 +390,9 @@ public:
         // Calculate quantities to maintain dollar-neutral
         double qty1 = config_.position_size_usd / signal.entry_price1;
         double qty2 = config_.position_size_usd / signal.entry_price2;
+        if (config_.use_hedge_ratio) {
+            qty2 *= std::abs(signal.hedge_ratio);
+        }
         
         // Order for symbol1
         Order order1;
@@ -256,6 +402,7 @@ public:
         order1.price = signal.entry_price1;
         order1.quantity = qty1;
         order1.strategy_name = "PAIRS_TRADING";
+        order1.strategy = StrategyKind::PAIRS;
         order1.created_time = Clock::now();
         
         // Order for symbol2
@@ -266,45 +413,28 @@ public:
         order2.price = signal.entry_price2;
         order2.quantity = qty2;
         order2.strategy_name = "PAIRS_TRADING";
+        order2.strategy = StrategyKind::PAIRS;
         order2.created_time = Clock::now();
         
         return {order1, order2};
     }
     
-    // Calculate correlation between the pair
+    // Rolling correlation of log prices over the lookback window - O(1)
     double calculate_correlation() const {
-        if (price1_history_.size() < 20 || price2_history_.size() < 20) {
-            return 0.0;
-        }
-        
-        size_t n = std::min(price1_history_.size(), price2_history_.size());
-        
-        // Calculate means
-        double mean1 = 0.0, mean2 = 0.0;
-        for (size_t i = 0; i < n; ++i) {
-            mean1 += price1_history_[i];
-            mean2 += price2_history_[i];
-        }
-        mean1 /= n;
-        mean2 /= n;
-        
-        // Calculate correlation
-        double numerator = 0.0;
-        double sum_sq1 = 0.0, sum_sq2 = 0.0;
-        
-        for (size_t i = 0; i < n; ++i) {
-            double diff1 = price1_history_[i] - mean1;
-            double diff2 = price2_history_[i] - mean2;
-            
-            numerator += diff1 * diff2;
-            sum_sq1 += diff1 * diff1;
-            sum_sq2 += diff2 * diff2;
-        }
-        
-        double denominator = std::sqrt(sum_sq1 * sum_sq2);
-        if (denominator < 0.000001) return 0.0;
-        
-        return numerator / denominator;
+        return comoments_.count >= 20 ? comoments_.correlation() : 0.0;
+    }
+    
+    double get_hedge_ratio() const {
+        return kalman_.beta;
+    }
+    
+    // Kalman spread (log p1 - alpha - beta * log p2) and its z-score
+    double get_kalman_spread() const {
+        return kalman_.spread;
+    }
+    
+    double get_kalman_z_score() const {
+        return kalman_.spread_z();
     }
     
     // Statistics
@@ -365,8 +495,11 @@ private:
     Config config_;
     
     CircularBuffer<double> ratio_history_;
-    std::deque<double> price1_history_;  // Keep for correlation calc
-    std::deque<double> price2_history_;  // Keep for correlation calc
+    CircularBuffer<double> log_price1_history_;     // Window for comoments_ removal
+    CircularBuffer<double> log_price2_history_;
+    
+    CoMoments comoments_;
+    KalmanHedgeRatio kalman_;
     
     // Incremental statistics - O(1) updates
     RunningStats stats_calculator_;
@@ -377,37 +510,522 @@ private:
     PairsStats stats_;
 };
 
-// Multi-pair manager
+// Multi-pair manager - batched pairs engine for hundreds of pairs
+//
+// Per-pair state lives in SoA arrays (ratio ring, running mean/M2, cached
+// stddev, z-score, position state) so a tick touches only the numbers it
+// needs. A price update for one symbol refreshes every pair containing it,
+// then z-scores for those pairs are computed in one vectorized pass.
+// Only threshold crossings are emitted:
+//   FLAT -> |z| > entry      ENTRY (trade the divergence)
+//   IN   -> |z| < exit       EXIT  (ratio back near mean)
+//   IN   -> z beyond stop    STOP  (divergence kept going)
+// Each pair also tracks a rolling correlation and a Kalman hedge ratio of
+// log prices (O(1) per tick); entries need the pair to be active and its
+// correlation above min_correlation. Pairs added with add_pair() stay active;
+// scanner-discovered pairs are toggled with set_active().
+// Not thread-safe: driven from the market data thread.
 class MultiPairManager {
 public:
-    void add_pair(const std::string& symbol1, const std::string& symbol2,
-                  const PairsTradingStrategy::Config& config) {
-        std::string pair_key = symbol1 + "_" + symbol2;
-        pairs_[pair_key] = std::make_unique<PairsTradingStrategy>(config);
+    using SymbolId = SymbolRegistry::SymbolId;
+    using PairId = uint32_t;
+    
+    enum class CrossingKind : uint8_t {
+        ENTRY,
+        EXIT,
+        STOP
+    };
+    
+    // A pair crossed a threshold; sides are what to trade now on each leg
+    struct Crossing {
+        PairId pair;
+        CrossingKind kind;
+        Side symbol1_side;
+        Side symbol2_side;
+        double z_score;
+        double ratio;
+        double mean_ratio;
+        double std_ratio;
+        double price1;
+        double price2;
+        double correlation;
+        double hedge_ratio;
+    };
+    
+    static constexpr uint32_t MIN_STATS_SAMPLES = 20;     // Before stddev is trusted
+    
+    MultiPairManager() = default;
+    
+    // Fees for profit estimates (optional): legs trade as makers on `venue`
+    void set_fee_engine(const FeeEngine* fees, Venue venue) {
+        fee_engine_ = fees;
+        fee_venue_ = venue;
+    }
+    
+    // Entry + exit on both legs, in bps of leg1 notional (0 without a fee engine)
+    double round_trip_cost_bps(PairId pair, double hedge_ratio) const {
+        if (!fee_engine_) return 0.0;
+        
+        double leg2_weight = use_hedge_ratio_[pair] ? std::abs(hedge_ratio) : 1.0;
+        return 2.0 * (fee_engine_->maker_bps(leg1_[pair], fee_venue_) +
+                      fee_engine_->maker_bps(leg2_[pair], fee_venue_) * leg2_weight);
+    }
+    
+    PairId add_pair(const std::string& symbol1, const std::string& symbol2,
+                    const PairsTradingStrategy::Config& config, bool pinned = true) {
+        if (config.lookback_period <= 0) {
+            throw std::invalid_argument("Pair lookback_period must be > 0");
+        }
+        
+        PairId pair = static_cast<PairId>(leg1_.size());
+        SymbolId id1 = register_symbol(symbol1);
+        SymbolId id2 = register_symbol(symbol2);
+        
+        names_.push_back(symbol1 + "_" + symbol2);
+        leg1_.push_back(id1);
+        leg2_.push_back(id2);
+        
+        lookback_.push_back(static_cast<uint32_t>(config.lookback_period));
+        history_offset_.push_back(history_.size());
+        history_.resize(history_.size() + static_cast<size_t>(config.lookback_period), 0.0);
+        log_history1_.resize(history_.size(), 0.0);
+        log_history2_.resize(history_.size(), 0.0);
+        head_.push_back(0);
+        count_.push_back(0);
+        
+        mean_.push_back(0.0);
+        m2_.push_back(0.0);
+        ratio_.push_back(0.0);
+        stddev_.push_back(0.0);
+        z_.push_back(0.0);
+        position_.push_back(0);
+        comoments_.emplace_back();
+        kalman_.emplace_back();
+        active_.push_back(1);
+        pinned_.push_back(pinned ? 1 : 0);
+        
+        entry_z_.push_back(config.entry_z_score);
+        exit_z_.push_back(config.exit_z_score);
+        stop_z_.push_back(config.stop_loss_z_score);
+        position_size_.push_back(config.position_size_usd);
+        min_correlation_.push_back(config.min_correlation);
+        kalman_delta_.push_back(config.kalman_delta);
+        kalman_observation_var_.push_back(config.kalman_observation_var);
+        use_hedge_ratio_.push_back(config.use_hedge_ratio ? 1 : 0);
+        
+        by_symbol_[id1].push_back(pair);
+        if (id2 != id1) by_symbol_[id2].push_back(pair);
+        
+        // Batch scratch sized for the worst case (every pair on one symbol)
+        size_t num_pairs = leg1_.size();
+        batch_.resize(num_pairs);
+        batch_ratio_.resize(num_pairs);
+        batch_mean_.resize(num_pairs);
+        batch_std_.resize(num_pairs);
+        batch_z_.resize(num_pairs);
+        return pair;
+    }
+    
+    // Symbol ticked: refresh every pair containing it (legs priced from prices)
+    void on_price(SymbolId symbol, const SymbolMap<double>& prices, std::vector<Crossing>& out) {
+        const std::vector<PairId>* pairs = by_symbol_.find(symbol);
+        if (!pairs) return;
+        
+        size_t n = 0;
+        for (PairId pair : *pairs) {
+            if (refresh(pair, prices)) {
+                batch_[n++] = pair;
+            }
+        }
+        if (n == 0) return;
+        
+        // Gather -> contiguous z pass -> scan for crossings
+        for (size_t k = 0; k < n; ++k) {
+            PairId pair = batch_[k];
+            batch_ratio_[k] = ratio_[pair];
+            batch_mean_[k] = mean_[pair];
+            batch_std_[k] = stddev_[pair];
+        }
+        compute_z_scores(batch_ratio_.data(), batch_mean_.data(), batch_std_.data(),
+                         batch_z_.data(), n);
+        
+        for (size_t k = 0; k < n; ++k) {
+            PairId pair = batch_[k];
+            z_[pair] = batch_z_[k];
+            detect_crossing(pair, prices, out);
+        }
+    }
+    
+    // Refresh every pair from a full price snapshot
+    void update_all(const SymbolMap<double>& prices, std::vector<Crossing>& out) {
+        size_t num_pairs = leg1_.size();
+        for (PairId pair = 0; pair < num_pairs; ++pair) {
+            refresh(pair, prices);
+        }
+        compute_z_scores(ratio_.data(), mean_.data(), stddev_.data(), z_.data(), num_pairs);
+        
+        for (PairId pair = 0; pair < num_pairs; ++pair) {
+            if (prices.contains(leg1_[pair]) && prices.contains(leg2_[pair])) {
+                detect_crossing(pair, prices, out);
+            }
+        }
+    }
+    
+    // Existing pair on symbols {symbol1, symbol2} in either leg order, or INVALID_PAIR
+    static constexpr PairId INVALID_PAIR = ~PairId(0);
+    
+    PairId find_pair(SymbolId symbol1, SymbolId symbol2) const {
+        const std::vector<PairId>* pairs = by_symbol_.find(symbol1);
+        if (!pairs) return INVALID_PAIR;
+        for (PairId pair : *pairs) {
+            if ((leg1_[pair] == symbol1 && leg2_[pair] == symbol2) ||
+                (leg1_[pair] == symbol2 && leg2_[pair] == symbol1)) {
+                return pair;
+            }
+        }
+        return INVALID_PAIR;
+    }
+    
+    // Start the Kalman filter from a known hedge ratio (e.g. the scanner's OLS beta)
+    // instead of 1.0; only meaningful before the pair has seen prices
+    void seed_hedge_ratio(PairId pair, double beta) {
+        kalman_[pair].beta = beta;
+    }
+    
+    // Inactive pairs keep their statistics warm and can still exit, but don't enter
+    void set_active(PairId pair, bool active) {
+        active_[pair] = active ? 1 : 0;
+    }
+    
+    bool is_active(PairId pair) const { return active_[pair] != 0; }
+    bool is_pinned(PairId pair) const { return pinned_[pair] != 0; }
+    
+    // Crossing's orders weren't sent (risk/gate rejected): restore the prior
+    // position state so the crossing can fire again
+    void revert(const Crossing& crossing) {
+        if (crossing.kind == CrossingKind::ENTRY) {
+            position_[crossing.pair] = 0;
+        } else {
+            position_[crossing.pair] = crossing.symbol1_side == Side::BUY ? -1 : 1;
+        }
+    }
+    
+    // Full signal (targets/stops) for an ENTRY crossing
+    PairsTradingStrategy::PairSignal make_signal(const Crossing& crossing) const {
+        PairsTradingStrategy::PairSignal signal;
+        signal.symbol1 = std::string(get_symbol_name(leg1_[crossing.pair]));
+        signal.symbol2 = std::string(get_symbol_name(leg2_[crossing.pair]));
+        signal.symbol1_side = crossing.symbol1_side;
+        signal.symbol2_side = crossing.symbol2_side;
+        signal.ratio = crossing.ratio;
+        signal.mean_ratio = crossing.mean_ratio;
+        signal.std_ratio = crossing.std_ratio;
+        signal.z_score = crossing.z_score;
+        signal.correlation = crossing.correlation;
+        signal.hedge_ratio = crossing.hedge_ratio;
+        signal.entry_price1 = crossing.price1;
+        signal.entry_price2 = crossing.price2;
+        signal.generated_at = Clock::now();
+        
+        double stop_z = crossing.symbol1_side == Side::SELL ? stop_z_[crossing.pair]
+                                                           : -stop_z_[crossing.pair];
+        signal.target_price1 = crossing.mean_ratio * crossing.price2;
+        signal.target_price2 = crossing.price2;
+        signal.stop_price1 = (crossing.mean_ratio + stop_z * crossing.std_ratio) * crossing.price2;
+        signal.stop_price2 = crossing.price2;
+        
+        // Reversion to the mean, net of round-trip fees
+        signal.expected_profit_bps =
+            std::abs((crossing.mean_ratio - crossing.ratio) / crossing.ratio) * 10000.0 -
+            round_trip_cost_bps(crossing.pair, crossing.hedge_ratio);
+        signal.is_valid = crossing.kind == CrossingKind::ENTRY;
+        return signal;
+    }
+    
+    // Dollar-neutral leg orders for a crossing (entry, or the closing trade)
+    std::pair<Order, Order> create_pair_orders(const Crossing& crossing) const {
+        double notional = position_size_[crossing.pair];
+        
+        Order order1;
+        order1.symbol = std::string(get_symbol_name(leg1_[crossing.pair]));
+        order1.side = crossing.symbol1_side;
+        order1.type = OrderType::LIMIT;
+        order1.price = crossing.price1;
+        order1.quantity = notional / crossing.price1;
+        order1.strategy_name = "PAIRS_TRADING";
+        order1.strategy = StrategyKind::PAIRS;
+        order1.created_time = Clock::now();
+        
+        Order order2;
+        order2.symbol = std::string(get_symbol_name(leg2_[crossing.pair]));
+        order2.side = crossing.symbol2_side;
+        order2.type = OrderType::LIMIT;
+        order2.price = crossing.price2;
+        order2.quantity = notional / crossing.price2;
+        if (use_hedge_ratio_[crossing.pair]) {
+            order2.quantity *= std::abs(crossing.hedge_ratio);
+        }
+        order2.strategy_name = "PAIRS_TRADING";
+        order2.strategy = StrategyKind::PAIRS;
+        order2.created_time = Clock::now();
+        
+        return {order1, order2};
     }
     
-    void update_all_prices(const std::unordered_map<std::string, double>& prices) {
-        for (auto& [pair_key, strategy] : pairs_) {
-            // Parse pair_key to get symbols
-            // Update strategy with prices
+    // Same legs appended to the tick's intent buffer, both on `venue`
+    void emplace_pair_orders(OrderIntentBuffer& out, const Crossing& crossing, Venue venue) const {
+        double notional = position_size_[crossing.pair];
+        double qty2 = notional / crossing.price2;
+        if (use_hedge_ratio_[crossing.pair]) {
+            qty2 *= std::abs(crossing.hedge_ratio);
         }
+        
+        TimePoint now = Clock::now();
+        out.emplace(leg1_[crossing.pair], venue, crossing.symbol1_side, OrderType::LIMIT,
+                    crossing.price1, notional / crossing.price1, StrategyKind::PAIRS, now);
+        out.emplace(leg2_[crossing.pair], venue, crossing.symbol2_side, OrderType::LIMIT,
+                    crossing.price2, qty2, StrategyKind::PAIRS, now);
     }
     
-    std::vector<PairsTradingStrategy::PairSignal> generate_all_signals(
-        const std::unordered_map<std::string, double>& prices)
-    {
-        std::vector<PairsTradingStrategy::PairSignal> signals;
+    void record_trade_result(const Crossing& entry, double pnl, double hold_minutes) {
+        stats_.total_trades++;
+        stats_.total_pnl += pnl;
         
-        for (auto& [pair_key, strategy] : pairs_) {
-            // Generate signal for each pair
-            // Add to signals vector if valid
+        if (pnl > 0) {
+            stats_.winning_trades++;
+        } else {
+            stats_.losing_trades++;
         }
         
-        return signals;
+        stats_.avg_z_score_at_entry = (stats_.avg_z_score_at_entry * (stats_.total_trades - 1) +
+                                       std::abs(entry.z_score)) / stats_.total_trades;
+        stats_.avg_hold_time_minutes = (stats_.avg_hold_time_minutes * (stats_.total_trades - 1) +
+                                        hold_minutes) / stats_.total_trades;
+        stats_.win_rate = static_cast<double>(stats_.winning_trades) / stats_.total_trades;
     }
     
+    const PairsTradingStrategy::PairsStats& get_stats() const { return stats_; }
+    
+    size_t size() const { return leg1_.size(); }
+    const std::string& name(PairId pair) const { return names_[pair]; }
+    SymbolId leg1(PairId pair) const { return leg1_[pair]; }
+    SymbolId leg2(PairId pair) const { return leg2_[pair]; }
+    double z_score(PairId pair) const { return z_[pair]; }
+    double correlation(PairId pair) const {
+        return comoments_[pair].count >= static_cast<int>(MIN_STATS_SAMPLES)
+            ? comoments_[pair].correlation() : 0.0;
+    }
+    double hedge_ratio(PairId pair) const { return kalman_[pair].beta; }
+    double kalman_spread(PairId pair) const { return kalman_[pair].spread; }
+    double kalman_z_score(PairId pair) const { return kalman_[pair].spread_z(); }
+    int position(PairId pair) const { return position_[pair]; }
+    
 private:
-    std::unordered_map<std::string, std::unique_ptr<PairsTradingStrategy>> pairs_;
+    // Identity / config
+    std::vector<std::string> names_;
+    std::vector<SymbolId> leg1_;
+    std::vector<SymbolId> leg2_;
+    std::vector<double> entry_z_;
+    std::vector<double> exit_z_;
+    std::vector<double> stop_z_;
+    std::vector<double> position_size_;
+    std::vector<double> min_correlation_;
+    std::vector<double> kalman_delta_;
+    std::vector<double> kalman_observation_var_;
+    std::vector<uint8_t> use_hedge_ratio_;
+    std::vector<uint8_t> active_;
+    std::vector<uint8_t> pinned_;       // Configured pairs: never deactivated by the scanner
+    
+    // Ratio rings, flattened (pair i owns lookback_[i] slots at history_offset_[i])
+    std::vector<double> history_;
+    std::vector<double> log_history1_;  // Log prices, same layout as history_
+    std::vector<double> log_history2_;
+    std::vector<size_t> history_offset_;
+    std::vector<uint32_t> lookback_;
+    std::vector<uint32_t> head_;
+    std::vector<uint32_t> count_;
+    
+    // Running statistics (Welford mean/M2 over the ring) and latest z
+    std::vector<double> mean_;
+    std::vector<double> m2_;
+    std::vector<double> ratio_;
+    std::vector<double> stddev_;
+    std::vector<double> z_;
+    std::vector<int8_t> position_;      // 0 flat, +1 long symbol1, -1 short symbol1
+    std::vector<CoMoments> comoments_;  // Rolling correlation of log prices
+    std::vector<KalmanHedgeRatio> kalman_;
+    
+    SymbolMap<std::vector<PairId>> by_symbol_;
+    
+    // Scratch for the per-tick batch (pairs sharing one symbol)
+    std::vector<PairId> batch_;
+    std::vector<double> batch_ratio_;
+    std::vector<double> batch_mean_;
+    std::vector<double> batch_std_;
+    std::vector<double> batch_z_;
+    
+    PairsTradingStrategy::PairsStats stats_;
+    
+    const FeeEngine* fee_engine_ = nullptr;
+    Venue fee_venue_ = Venue::BINANCE;
+    
+    // Push the current ratio into the pair's ring and running stats
+    bool refresh(PairId pair, const SymbolMap<double>& prices) {
+        const double* price1 = prices.find(leg1_[pair]);
+        const double* price2 = prices.find(leg2_[pair]);
+        if (!price1 || !price2 || *price2 <= 0.0) return false;
+        
+        double ratio = *price1 / *price2;
+        double log1 = std::log(*price1);
+        double log2 = std::log(*price2);
+        double* ring = history_.data() + history_offset_[pair];
+        double* log_ring1 = log_history1_.data() + history_offset_[pair];
+        double* log_ring2 = log_history2_.data() + history_offset_[pair];
+        uint32_t capacity = lookback_[pair];
+        uint32_t& head = head_[pair];
+        uint32_t& count = count_[pair];
+        double& mean = mean_[pair];
+        double& m2 = m2_[pair];
+        
+        // Ring full: remove the oldest from the running stats
+        if (count == capacity) {
+            comoments_[pair].remove(log_ring2[head], log_ring1[head]);
+            
+            double old = ring[head];
+            --count;
+            if (count == 0) {
+                mean = 0.0;
+                m2 = 0.0;
+            } else {
+                double delta = old - mean;
+                mean -= delta / count;
+                m2 -= delta * (old - mean);
+            }
+        }
+        
+        ring[head] = ratio;
+        log_ring1[head] = log1;
+        log_ring2[head] = log2;
+        head = head + 1 == capacity ? 0 : head + 1;
+        
+        ++count;
+        double delta = ratio - mean;
+        mean += delta / count;
+        m2 += delta * (ratio - mean);
+        
+        comoments_[pair].add(log2, log1);
+        if (head == 0 && count == capacity) {
+            resum(pair);        // Once per lap: re-anchor the running stats
+        }
+        kalman_[pair].update(log2, log1, kalman_delta_[pair], kalman_observation_var_[pair]);
+        
+        ratio_[pair] = ratio;
+        stddev_[pair] = count >= MIN_STATS_SAMPLES ? std::sqrt(std::max(m2, 0.0) / (count - 1)) : 0.0;
+        return true;
+    }
+    
+    // Recompute mean/M2 and the co-moments exactly from the full ring; the
+    // O(1) remove/add updates accumulate rounding error over long runs
+    void resum(PairId pair) {
+        const double* ring = history_.data() + history_offset_[pair];
+        size_t n = count_[pair];
+        double mean = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            mean += ring[i];
+        }
+        mean /= static_cast<double>(n);
+        double m2 = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double delta = ring[i] - mean;
+            m2 += delta * delta;
+        }
+        mean_[pair] = mean;
+        m2_[pair] = m2;
+        comoments_[pair].resum(log_history2_.data() + history_offset_[pair],
+                               log_history1_.data() + history_offset_[pair], n);
+    }
+    
+    // z = (ratio - mean) / stddev, 0 where stddev is degenerate
+    static void compute_z_scores(const double* __restrict ratio, const double* __restrict mean,
+                                 const double* __restrict stddev, double* __restrict z, size_t n) {
+        constexpr double MIN_STDDEV = 0.000001;
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d min_std = _mm256_set1_pd(MIN_STDDEV);
+        for (; i + 4 <= n; i += 4) {
+            __m256d s = _mm256_loadu_pd(stddev + i);
+            __m256d valid = _mm256_cmp_pd(s, min_std, _CMP_GE_OQ);
+            __m256d safe = _mm256_blendv_pd(_mm256_set1_pd(1.0), s, valid);
+            __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(ratio + i), _mm256_loadu_pd(mean + i));
+            _mm256_storeu_pd(z + i, _mm256_and_pd(_mm256_div_pd(diff, safe), valid));
+        }
+#endif
+        for (; i < n; ++i) {
+            z[i] = stddev[i] >= MIN_STDDEV ? (ratio[i] - mean[i]) / stddev[i] : 0.0;
+        }
+    }
+    
+    void detect_crossing(PairId pair, const SymbolMap<double>& prices, std::vector<Crossing>& out) {
+        // Same warm-up as PairsTradingStrategy::generate_signal
+        if (count_[pair] < lookback_[pair] / 2 || stddev_[pair] == 0.0) return;
+        
+        double z = z_[pair];
+        int8_t& position = position_[pair];
+        
+        CrossingKind kind;
+        Side side1;
+        if (position == 0) {
+            if (!active_[pair] || correlation(pair) < min_correlation_[pair]) {
+                return;
+            }
+            if (z > entry_z_[pair]) {
+                kind = CrossingKind::ENTRY;
+                side1 = Side::SELL;             // Ratio rich: short symbol1, long symbol2
+                position = -1;
+            } else if (z < -entry_z_[pair]) {
+                kind = CrossingKind::ENTRY;
+                side1 = Side::BUY;              // Ratio cheap: long symbol1, short symbol2
+                position = 1;
+            } else {
+                return;
+            }
+        } else {
+            bool stopped = position < 0 ? z > stop_z_[pair] : z < -stop_z_[pair];
+            if (stopped) {
+                kind = CrossingKind::STOP;
+            } else if (std::abs(z) < exit_z_[pair]) {
+                kind = CrossingKind::EXIT;
+            } else {
+                return;
+            }
+            side1 = position < 0 ? Side::BUY : Side::SELL;  // Close the position
+            position = 0;
+        }
+        
+        Crossing crossing;
+        crossing.pair = pair;
+        crossing.kind = kind;
+        crossing.symbol1_side = side1;
+        crossing.symbol2_side = side1 == Side::BUY ? Side::SELL : Side::BUY;
+        crossing.z_score = z;
+        crossing.ratio = ratio_[pair];
+        crossing.mean_ratio = mean_[pair];
+        crossing.std_ratio = stddev_[pair];
+        crossing.price1 = *prices.find(leg1_[pair]);
+        crossing.price2 = *prices.find(leg2_[pair]);
+        crossing.correlation = correlation(pair);
+        crossing.hedge_ratio = kalman_[pair].beta;
+        out.push_back(crossing);
+    }
 };
 
+inline const char* to_string(MultiPairManager::CrossingKind kind) {
+    switch (kind) {
+        case MultiPairManager::CrossingKind::ENTRY: return "ENTRY";
+        case MultiPairManager::CrossingKind::EXIT: return "EXIT";
+        case MultiPairManager::CrossingKind::STOP: return "STOP";
+        default: return "UNKNOWN";
+    }
+}
+
 } // namespace trading
@@ -3,222 +3,433 @@
 #include "order_book_imbalance.hpp"
 #include "latency_arbitrage.hpp"
 #include "pairs_trading.hpp"
+#include "cointegration_scanner.hpp"
 #include "adverse_selection_filter.hpp"
 #include "volatility_arbitrage.hpp"
 #include "../core/types.hpp"
 #include "../core/risk_manager.hpp"
-#include <memory>
+#include "../core/order_gate.hpp"
+#include "../core/order_intent.hpp"
+#include "../core/instrument_master.hpp"
+#include "../core/fee_engine.hpp"
+#include "../core/markout_engine.hpp"
+#include "../core/toxicity_board.hpp"
+#include "../core/symbol_map.hpp"
+#include "../market_data/consolidated_bbo.hpp"
+#include "../market_data/feature_pipeline.hpp"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace trading {
 
+// Coordinator configuration (shared by every strategy set)
+struct StrategyCoordinatorConfig {
+    bool enable_obi = true;
+    bool enable_latency_arb = true;
+    bool enable_pairs = true;
+    bool enable_adverse_filter = true;
+    bool enable_vol_arb = true;
+    
+    OrderBookImbalanceStrategy::Config obi_config;
+    LatencyArbitrageStrategy::Config latency_arb_config;
+    PairsTradingStrategy::Config pairs_config;
+    VolatilityArbitrageStrategy::Config vol_arb_config;
+    
+    // Shared book features (OBI depth and vol arb volatility are added)
+    FeaturePipeline::Config feature_config;
+    
+    // Adverse selection: fill markouts per symbol and venue
+    MarkoutEngine::Config markout_config;
+    size_t toxicity_horizon = 1;            // Markout horizon index scored (500ms)
+    double max_mm_toxicity = 0.7;           // MM orders filtered above this
+    size_t max_symbols = 1024;              // Toxicity board capacity (SymbolId)
+    
+    // Global limits
+    int max_total_positions = 20;
+    double max_total_notional = 150000.0;
+    
+    // Venue for single-venue strategies (OBI, pairs, vol arb)
+    Venue primary_venue = Venue::BINANCE;
+    
+    // Single-leg intents held back by venue rate limits are retried (risk
+    // and gate re-run) once tokens free up, until max_defer_time old
+    size_t max_deferred_intents = 16;
+    std::chrono::nanoseconds max_defer_time = std::chrono::milliseconds(50);
+    
+    // Pairs traded (symbol1, symbol2) with pairs_config thresholds
+    std::vector<std::pair<std::string, std::string>> pairs = {
+        {"ETHUSDT", "BTCUSDT"},
+        {"SOLUSDT", "BTCUSDT"}
+    };
+};
+
+// Strategy set marker: every strategy compiled in, each switched on by its
+// StrategyCoordinatorConfig::enable_* flag
+struct RuntimeStrategies {};
+
 // Master Strategy Coordinator - Manages all 5 money-making algorithms
-class StrategyCoordinator {
+//
+// Strategies... is either RuntimeStrategies or a type list drawn from
+// OrderBookImbalanceStrategy, LatencyArbitrageStrategy, MultiPairManager,
+// VolatilityArbitrageStrategy and AdverseSelectionFilter. With a type list
+// the set is fixed at compile time: stages not listed are discarded by
+// if constexpr, listed ones run unconditionally (enable_* flags ignored),
+// and the update path inlines straight through.
+template<typename... Strategies>
+class BasicStrategyCoordinator {
+    static constexpr bool RUNTIME = (std::is_same_v<Strategies, RuntimeStrategies> || ...);
+    
+    template<typename S>
+    static constexpr bool COMPILED = RUNTIME || (std::is_same_v<S, Strategies> || ...);
+    
+    template<typename S>
+    static constexpr bool KNOWN = std::is_same_v<S, RuntimeStrategies> ||
+                                  std::is_same_v<S, OrderBookImbalanceStrategy> ||
+                                  std::is_same_v<S, LatencyArbitrageStrategy> ||
+                                  std::is_same_v<S, MultiPairManager> ||
+                                  std::is_same_v<S, VolatilityArbitrageStrategy> ||
+                                  std::is_same_v<S, AdverseSelectionFilter>;
+    
+    static_assert(sizeof...(Strategies) > 0 && (KNOWN<Strategies> && ...),
+                  "Strategies must be RuntimeStrategies or coordinator strategy types");
+    
 public:
-    struct Config {
-        bool enable_obi = true;
-        bool enable_latency_arb = true;
-        bool enable_pairs = true;
-        bool enable_adverse_filter = true;
-        bool enable_vol_arb = true;
-        
-        OrderBookImbalanceStrategy::Config obi_config;
-        LatencyArbitrageStrategy::Config latency_arb_config;
-        PairsTradingStrategy::Config pairs_config;
-        AdverseSelectionFilter::Config adverse_filter_config;
-        VolatilityArbitrageStrategy::Config vol_arb_config;
-        
-        // Global limits
-        int max_total_positions = 20;
-        double max_total_notional = 150000.0;
-    };
+    using Config = StrategyCoordinatorConfig;
     
-    explicit StrategyCoordinator(const Config& config, RiskManager& risk_manager)
+    explicit BasicStrategyCoordinator(const Config& config, RiskManager& risk_manager)
         : config_(config)
         , risk_manager_(risk_manager)
+        , features_(pipeline_config(config))
     {
+        deferred_.reserve(config_.max_deferred_intents);
+        
         // Initialize enabled strategies
-        if (config_.enable_obi) {
-            obi_strategy_ = std::make_unique<OrderBookImbalanceStrategy>(config_.obi_config);
+        if (enabled<OrderBookImbalanceStrategy>()) {
+            obi_strategy_.emplace(config_.obi_config);
             LOG_INFO("OBI Strategy enabled");
         }
         
-        if (config_.enable_latency_arb) {
-            latency_arb_strategy_ = std::make_unique<LatencyArbitrageStrategy>(config_.latency_arb_config);
+        if (enabled<LatencyArbitrageStrategy>()) {
+            latency_arb_strategy_.emplace(config_.latency_arb_config);
             LOG_INFO("Latency Arbitrage enabled");
         }
         
-        if (config_.enable_pairs) {
-            // Initialize pairs (ETH/BTC, SOL/BTC, LINK/BTC)
-            auto eth_btc_config = config_.pairs_config;
-            eth_btc_config.symbol1 = "ETHUSDT";
-            eth_btc_config.symbol2 = "BTCUSDT";
-            pairs_strategies_["ETH_BTC"] = std::make_unique<PairsTradingStrategy>(eth_btc_config);
-            
-            auto sol_btc_config = config_.pairs_config;
-            sol_btc_config.symbol1 = "SOLUSDT";
-            sol_btc_config.symbol2 = "BTCUSDT";
-            pairs_strategies_["SOL_BTC"] = std::make_unique<PairsTradingStrategy>(sol_btc_config);
+        if (enabled<MultiPairManager>()) {
+            for (const auto& [symbol1, symbol2] : config_.pairs) {
+                auto pair_config = config_.pairs_config;
+                pair_config.symbol1 = symbol1;
+                pair_config.symbol2 = symbol2;
+                pairs_.add_pair(symbol1, symbol2, pair_config);
+            }
             
-            LOG_INFO("Pairs Trading enabled (2 pairs)");
+            LOG_INFO("Pairs Trading enabled (" << pairs_.size() << " pairs)");
         }
         
-        if (config_.enable_adverse_filter) {
-            adverse_filter_ = std::make_unique<AdverseSelectionFilter>(config_.adverse_filter_config);
+        if (enabled<AdverseSelectionFilter>()) {
+            markouts_.emplace(config_.markout_config);
+            toxicity_.emplace(config_.max_symbols);
+            markouts_->attach_board(&*toxicity_, config_.toxicity_horizon);
+            features_.attach_toxicity(&*toxicity_);
             LOG_INFO("Adverse Selection Filter enabled");
         }
         
-        if (config_.enable_vol_arb) {
+        if (enabled<VolatilityArbitrageStrategy>()) {
             // One vol arb per symbol
-            vol_arb_strategies_["BTCUSDT"] = std::make_unique<VolatilityArbitrageStrategy>(config_.vol_arb_config);
-            vol_arb_strategies_["ETHUSDT"] = std::make_unique<VolatilityArbitrageStrategy>(config_.vol_arb_config);
+            vol_arb_strategies_[symbols::BTCUSDT].emplace(config_.vol_arb_config);
+            vol_arb_strategies_[symbols::ETHUSDT].emplace(config_.vol_arb_config);
             LOG_INFO("Volatility Arbitrage enabled (2 symbols)");
         }
     }
     
+    // Kill switch / breaker gate (optional) - strategies on tripped venues are skipped
+    void attach_order_gate(OrderGate* gate) {
+        order_gate_ = gate;
+    }
+    
     // Process market data and generate signals from ALL strategies
-    std::vector<Order> process_market_update(
+    // Hot path: intents land in a buffer the coordinator reuses every tick, so
+    // once it has grown to the working size a tick does no heap allocation.
+    // The span is valid until the next call (market data thread only).
+    // `book` is `venue`'s book for `symbol` - the one that just changed;
+    // all_books holds every venue's current book for the symbol.
+    std::span<const OrderIntent> generate_intents(
         const std::string& symbol,
+        Venue venue,
         const OrderBook& book,
-        const std::unordered_map<std::string, OrderBook>& all_books,
-        const std::unordered_map<std::string, double>& current_prices)
+        const std::unordered_map<Venue, OrderBook>& all_books,
+        const SymbolMap<double>& current_prices)
     {
-        std::vector<Order> orders;
+        intents_.clear();
         double current_price = book.get_mid_price();
         
+        if (order_gate_ && order_gate_->is_killed()) {
+            deferred_.clear();
+            return intents_.view();
+        }
+        bool primary_available = venue_available(config_.primary_venue);
+        retry_deferred(current_prices);
+        
+        // Every venue feeds the consolidated BBO; the feature pipeline and the
+        // single-venue strategies (which trade on the primary venue) only see
+        // the primary venue's book, so their state never mixes venues
+        SymbolRegistry::SymbolId symbol_id = register_symbol(symbol);
+        bool primary_tick = venue == config_.primary_venue;
+        
+        // Shared per-symbol features and volatility, computed once per primary tick
+        const BookFeatures* features = primary_tick ? &features_.update(symbol_id, book) : nullptr;
+        
         // 1. ORDER BOOK IMBALANCE
-        if (obi_strategy_ && config_.enable_obi) {
-            auto obi_signal = obi_strategy_->analyze(symbol, book);
-            
-            if (obi_signal.is_valid && !obi_strategy_->is_signal_expired(obi_signal)) {
-                // Check risk limits
-                auto risk_check = risk_manager_.check_order(
-                    Order{}, // Would need to construct proper order
-                    current_price
-                );
+        if constexpr (COMPILED<OrderBookImbalanceStrategy>) {
+            if (enabled<OrderBookImbalanceStrategy>() && primary_tick && primary_available) {
+                auto obi_signal = obi_strategy_->analyze(symbol, *features);
                 
-                if (risk_check.passed) {
-                    double quantity = calculate_position_size(symbol, current_price, "OBI");
-                    Order order = obi_strategy_->create_order_from_signal(obi_signal, quantity);
-                    order.symbol = symbol;
-                    orders.push_back(order);
+                if (obi_signal.is_valid && !obi_strategy_->is_signal_expired(obi_signal)) {
+                    size_t mark = intents_.size();
+                    double quantity = calculate_position_size(symbol_id, current_price, StrategyKind::OBI);
+                    obi_strategy_->emplace_order(intents_, symbol_id, config_.primary_venue, obi_signal, quantity);
                     
-                    LOG_INFO("OBI Signal: " << symbol << " " << to_string(obi_signal.predicted_direction)
-                             << " confidence=" << obi_signal.confidence);
+                    // Check risk limits, then the venue gate
+                    if (admit(mark, current_price)) {
+                        LOG_INFO("OBI Signal: " << symbol << " " << to_string(obi_signal.predicted_direction)
+                                 << " confidence=" << obi_signal.confidence);
+                    }
                 }
             }
         }
         
         // 2. LATENCY ARBITRAGE
-        if (latency_arb_strategy_ && config_.enable_latency_arb && all_books.size() > 1) {
-            auto arb_opp = latency_arb_strategy_->detect_opportunity(symbol, all_books);
-            
-            if (arb_opp.has_value() && arb_opp->is_valid) {
-                auto [buy_order, sell_order] = latency_arb_strategy_->create_arb_orders(*arb_opp);
+        if constexpr (COMPILED<LatencyArbitrageStrategy>) {
+            if (enabled<LatencyArbitrageStrategy>()) {
+                // Only the venue that ticked changes the consolidated BBO (O(log V))
+                const InstrumentBBO& bbo = consolidated_bbo_.update(symbol_id, venue, book);
                 
-                // Check risk for both legs
-                auto buy_check = risk_manager_.check_order(buy_order, arb_opp->buy_price);
-                auto sell_check = risk_manager_.check_order(sell_order, arb_opp->sell_price);
+                auto arb_opp = all_books.size() > 1
+                    ? latency_arb_strategy_->detect_opportunity(symbol, bbo, &all_books)
+                    : std::nullopt;
                 
-                if (buy_check.passed && sell_check.passed) {
-                    orders.push_back(buy_order);
-                    orders.push_back(sell_order);
+                if (arb_opp.has_value() && arb_opp->is_valid) {
+                    size_t mark = intents_.size();
+                    latency_arb_strategy_->emplace_arb_orders(intents_, symbol_id, *arb_opp);
                     
-                    LOG_INFO("Latency Arb: " << symbol 
-                             << " buy@" << to_string(arb_opp->buy_venue)
-                             << " sell@" << to_string(arb_opp->sell_venue)
-                             << " profit=" << arb_opp->net_profit_bps << "bps");
+                    // Reserve exposure for both legs atomically
+                    if (reserve_legs(mark, 2)) {
+                        LOG_INFO("Latency Arb: " << symbol 
+                                 << " buy@" << to_string(arb_opp->buy_venue)
+                                 << " sell@" << to_string(arb_opp->sell_venue)
+                                 << " profit=" << arb_opp->net_profit_bps << "bps");
+                    } else {
+                        latency_arb_strategy_->complete_arbitrage();  // Never sent
+                    }
                 }
             }
         }
         
-        // 3. PAIRS TRADING
-        if (config_.enable_pairs) {
-            for (auto& [pair_name, strategy] : pairs_strategies_) {
-                // Update prices
-                auto it1 = current_prices.find(strategy->config_.symbol1);
-                auto it2 = current_prices.find(strategy->config_.symbol2);
+        // 3. PAIRS TRADING (only pairs containing this symbol; crossings only)
+        if constexpr (COMPILED<MultiPairManager>) {
+            if (enabled<MultiPairManager>() && primary_tick) {
+                if (pair_scanner_) {
+                    pair_scanner_->record(symbol_id, current_price);
+                    apply_scanner_candidates();
+                }
                 
-                if (it1 != current_prices.end() && it2 != current_prices.end()) {
-                    strategy->update_prices(it1->second, it2->second);
-                    
-                    auto pair_signal = strategy->generate_signal(it1->second, it2->second);
+                pair_crossings_.clear();
+                pairs_.on_price(symbol_id, current_prices, pair_crossings_);
+                
+                for (const auto& crossing : pair_crossings_) {
+                    bool entry = crossing.kind == MultiPairManager::CrossingKind::ENTRY;
+                    size_t mark = intents_.size();
+                    pairs_.emplace_pair_orders(intents_, crossing, config_.primary_venue);
                     
-                    if (pair_signal.is_valid) {
-                        auto [order1, order2] = strategy->create_pair_orders(pair_signal);
-                        
-                        // Risk check both legs
-                        auto check1 = risk_manager_.check_order(order1, it1->second);
-                        auto check2 = risk_manager_.check_order(order2, it2->second);
-                        
-                        if (check1.passed && check2.passed) {
-                            orders.push_back(order1);
-                            orders.push_back(order2);
-                            
-                            LOG_INFO("Pairs Signal: " << pair_name 
-                                     << " z=" << pair_signal.z_score
-                                     << " expected=" << pair_signal.expected_profit_bps << "bps");
+                    // Reserve both legs atomically
+                    if (primary_available && reserve_legs(mark, 2)) {
+                        if (entry) {
+                            LOG_INFO("Pairs Signal: " << pairs_.name(crossing.pair)
+                                     << " z=" << crossing.z_score
+                                     << " expected=" << pairs_.make_signal(crossing).expected_profit_bps << "bps");
+                        } else {
+                            LOG_INFO("Pairs " << to_string(crossing.kind) << ": " << pairs_.name(crossing.pair)
+                                     << " z=" << crossing.z_score);
                         }
+                    } else {
+                        intents_.truncate(mark);
+                        pairs_.revert(crossing);  // Not sent: re-evaluate on the next tick
                     }
                 }
             }
         }
         
         // 4. VOLATILITY ARBITRAGE
-        if (config_.enable_vol_arb) {
-            auto vol_it = vol_arb_strategies_.find(symbol);
-            if (vol_it != vol_arb_strategies_.end()) {
-                vol_it->second->update_price(current_price);
-                
-                auto vol_signal = vol_it->second->generate_signal(current_price);
+        if constexpr (COMPILED<VolatilityArbitrageStrategy>) {
+            if (enabled<VolatilityArbitrageStrategy>() && primary_tick) {
+                auto* vol_arb = vol_arb_strategies_.find(symbol_id);
+                if (vol_arb) {
+                    (*vol_arb)->update_price(current_price, *features_.volatility().get(symbol_id));
+                }
                 
-                if (vol_signal.is_valid) {
-                    double quantity = calculate_position_size(symbol, current_price, "VOL_ARB");
-                    Order order = vol_it->second->create_order_from_signal(vol_signal, quantity);
-                    order.symbol = symbol;
+                if (vol_arb && primary_available) {
+                    // Enter at the microprice: size-weighted fair value, not raw mid
+                    auto vol_signal = (*vol_arb)->generate_signal(features->microprice);
                     
-                    auto risk_check = risk_manager_.check_order(order, current_price);
-                    
-                    if (risk_check.passed) {
-                        orders.push_back(order);
+                    if (vol_signal.is_valid) {
+                        size_t mark = intents_.size();
+                        double quantity = calculate_position_size(symbol_id, current_price, StrategyKind::VOL_ARB);
+                        (*vol_arb)->emplace_order(intents_, symbol_id, config_.primary_venue, vol_signal, quantity);
                         
-                        LOG_INFO("Vol Arb Signal: " << symbol
-                                 << " regime=" << static_cast<int>(vol_signal.regime)
-                                 << " strategy=" << vol_signal.strategy_type);
+                        if (admit(mark, current_price)) {
+                            LOG_INFO("Vol Arb Signal: " << symbol
+                                     << " regime=" << static_cast<int>(vol_signal.regime)
+                                     << " strategy=" << vol_signal.strategy_type);
+                        }
                     }
                 }
             }
         }
         
         // 5. ADVERSE SELECTION FILTER (applies to market making)
-        if (adverse_filter_ && config_.enable_adverse_filter) {
-            adverse_filter_->update_current_price(current_price);
-            
-            auto toxicity = adverse_filter_->calculate_toxicity();
-            
-            // If toxicity high, don't send market making orders
-            // Or widen spreads if we do
-            if (toxicity.toxicity_score > 0.7) {
-                LOG_WARN("High toxicity detected: " << symbol 
-                         << " score=" << toxicity.toxicity_score
-                         << " - filtering MM orders");
+        if constexpr (COMPILED<AdverseSelectionFilter>) {
+            if (enabled<AdverseSelectionFilter>() && primary_tick) {
+                // Marks out fills due before this tick; republishes only their symbols
+                markouts_->on_price(symbol_id, current_price);
+                
+                double toxicity = toxicity_->toxicity(symbol_id, config_.primary_venue);
                 
-                // Remove any market making orders from the list
-                orders.erase(
-                    std::remove_if(orders.begin(), orders.end(),
-                        [](const Order& o) { return o.strategy_name == "MM"; }),
-                    orders.end()
-                );
+                // If toxicity high, don't send market making orders
+                // Or widen spreads if we do
+                if (toxicity > config_.max_mm_toxicity) {
+                    LOG_WARN("High toxicity detected: " << symbol 
+                             << " score=" << toxicity
+                             << " - filtering MM orders");
+                    
+                    // Remove any market making intents
+                    intents_.erase_if(
+                        [](const OrderIntent& i) { return i.strategy == StrategyKind::MARKET_MAKING; });
+                }
             }
         }
         
+        return intents_.view();
+    }
+    
+    // Same tick, materialized as full Orders (allocates; for callers that
+    // still want std::vector<Order>)
+    std::vector<Order> process_market_update(
+        const std::string& symbol,
+        Venue venue,
+        const OrderBook& book,
+        const std::unordered_map<Venue, OrderBook>& all_books,
+        const SymbolMap<double>& current_prices)
+    {
+        auto intents = generate_intents(symbol, venue, book, all_books, current_prices);
+        
+        std::vector<Order> orders;
+        orders.reserve(intents.size());
+        for (const auto& intent : intents) {
+            orders.push_back(intent.to_order());
+        }
         return orders;
     }
     
-    // Record fill (updates adverse selection filter)
+    // Same tick into caller-owned Orders: `out` only ever grows and its
+    // Orders are overwritten in place, so once warmed up this doesn't
+    // allocate. Returns the first intents().size() entries of `out`.
+    std::span<const Order> process_market_update(
+        const std::string& symbol,
+        Venue venue,
+        const OrderBook& book,
+        const std::unordered_map<Venue, OrderBook>& all_books,
+        const SymbolMap<double>& current_prices,
+        std::vector<Order>& out)
+    {
+        auto intents = generate_intents(symbol, venue, book, all_books, current_prices);
+        
+        if (out.size() < intents.size()) {
+            out.resize(intents.size());
+        }
+        for (size_t i = 0; i < intents.size(); ++i) {
+            intents[i].to_order(out[i]);
+        }
+        return std::span<const Order>(out.data(), intents.size());
+    }
+    
+    // Background pair discovery (optional) - its active set is merged into the
+    // pairs engine on the market data thread; configured pairs stay active
+    void attach_pair_scanner(CointegrationScanner* scanner) {
+        pair_scanner_ = scanner;
+        scanner_version_ = 0;
+    }
+    
+    // Tiered venue fees (optional) - arb thresholds and pairs estimates use
+    // its rates; fills advance its 30-day volume tiers
+    void attach_fee_engine(FeeEngine* fees) {
+        fee_engine_ = fees;
+        if (latency_arb_strategy_) {
+            latency_arb_strategy_->attach_fee_engine(fees);
+        }
+        pairs_.set_fee_engine(fees, config_.primary_venue);
+    }
+    
+    // Per-symbol ATR / realized / EWMA volatility (e.g. for OBI adaptive thresholds)
+    const VolatilityService& volatility() const {
+        return features_.volatility();
+    }
+    
+    // Per-symbol book / flow features from the latest update
+    const FeaturePipeline& features() const {
+        return features_;
+    }
+    
+    // Public trade print (aggressor side) - feeds the trade-flow feature
+    void on_trade(const std::string& symbol, Side aggressor, double quantity) {
+        features_.on_trade(register_symbol(symbol), aggressor, quantity);
+    }
+    
+    // Latest toxicity per symbol / (symbol, venue) - lock-free reads for
+    // quoting threads; nullptr when the adverse filter is disabled
+    const ToxicityBoard* toxicity() const {
+        return toxicity_ ? &*toxicity_ : nullptr;
+    }
+    
+    // Cross-venue best bid/offer per symbol, as seen by latency arb
+    const ConsolidatedBBO& consolidated_bbo() const {
+        return consolidated_bbo_;
+    }
+    
+    // Single-leg intents waiting for venue rate-limit tokens
+    size_t deferred_intents() const {
+        return deferred_.size();
+    }
+    
+    // Order for a reserved leg was rejected or canceled by the venue
+    void on_order_terminated(const Order& order) {
+        if (order.reservation_id != 0) {
+            risk_manager_.release_reserved_quantity(order.reservation_id, order.reservation_leg,
+                                                    order.quantity - order.filled_quantity);
+        }
+    }
+    
+    // Record fill: books the position (turning a reserved leg's exposure
+    // into position), schedules its markouts and updates fee tiers
+    // Call from the market data thread: markouts are evaluated there
     void on_fill(const Fill& fill) {
-        if (adverse_filter_ && config_.enable_adverse_filter) {
-            adverse_filter_->record_fill(fill.side, fill.price, fill.quantity);
+        if (fill.reservation_id != 0) {
+            risk_manager_.commit_fill(fill.reservation_id, fill.reservation_leg, fill);
+        } else {
+            risk_manager_.on_fill(fill);
+        }
+        
+        if (fee_engine_) {
+            fee_engine_->on_fill(fill);
+        }
+        
+        if (markouts_) {
+            TimePoint fill_time = fill.received_time != TimePoint{} ? fill.received_time : Clock::now();
+            markouts_->on_fill(get_symbol_id(fill.symbol), fill.venue,
+                               fill.is_maker ? FLOW_MAKER : FLOW_TAKER,
+                               fill.side, fill.price, fill.quantity, fill_time);
         }
         
         // Update strategy-specific tracking
@@ -252,13 +463,7 @@ public:
             stats.latency_arb_stats = latency_arb_strategy_->get_stats();
         }
         
-        // Aggregate pairs stats
-        for (const auto& [name, strategy] : pairs_strategies_) {
-            auto pair_stats = strategy->get_stats();
-            stats.pairs_stats.total_trades += pair_stats.total_trades;
-            stats.pairs_stats.winning_trades += pair_stats.winning_trades;
-            stats.pairs_stats.total_pnl += pair_stats.total_pnl;
-        }
+        stats.pairs_stats = pairs_.get_stats();
         
         // Aggregate vol arb stats
         for (const auto& [symbol, strategy] : vol_arb_strategies_) {
@@ -268,8 +473,8 @@ public:
             stats.vol_arb_stats.total_pnl += vol_stats.total_pnl;
         }
         
-        if (adverse_filter_) {
-            stats.adverse_stats = adverse_filter_->get_stats();
+        if (markouts_) {
+            stats.adverse_stats = adverse_stats();
         }
         
         // Calculate combined metrics
@@ -303,14 +508,14 @@ public:
         LOG_INFO("  STRATEGY PERFORMANCE REPORT");
         LOG_INFO("========================================");
         
-        if (config_.enable_obi) {
+        if (enabled<OrderBookImbalanceStrategy>()) {
             LOG_INFO("OBI Strategy:");
             LOG_INFO("  Signals: " << stats.obi_stats.total_signals);
             LOG_INFO("  Win Rate: " << (stats.obi_stats.win_rate * 100.0) << "%");
             LOG_INFO("  P&L: $" << stats.obi_stats.total_pnl);
         }
         
-        if (config_.enable_latency_arb) {
+        if (enabled<LatencyArbitrageStrategy>()) {
             LOG_INFO("Latency Arbitrage:");
             LOG_INFO("  Executed: " << stats.latency_arb_stats.executed_arbs);
             LOG_INFO("  Win Rate: " << (stats.latency_arb_stats.win_rate * 100.0) << "%");
@@ -318,21 +523,21 @@ public:
             LOG_INFO("  Avg Profit: " << stats.latency_arb_stats.avg_profit_bps << " bps");
         }
         
-        if (config_.enable_pairs) {
+        if (enabled<MultiPairManager>()) {
             LOG_INFO("Pairs Trading:");
             LOG_INFO("  Trades: " << stats.pairs_stats.total_trades);
             LOG_INFO("  Win Rate: " << (stats.pairs_stats.win_rate * 100.0) << "%");
             LOG_INFO("  P&L: $" << stats.pairs_stats.total_pnl);
         }
         
-        if (config_.enable_vol_arb) {
+        if (enabled<VolatilityArbitrageStrategy>()) {
             LOG_INFO("Volatility Arbitrage:");
             LOG_INFO("  Trades: " << stats.vol_arb_stats.total_trades);
             LOG_INFO("  Win Rate: " << (stats.vol_arb_stats.win_rate * 100.0) << "%");
             LOG_INFO("  P&L: $" << stats.vol_arb_stats.total_pnl);
         }
         
-        if (config_.enable_adverse_filter) {
+        if (enabled<AdverseSelectionFilter>()) {
             LOG_INFO("Adverse Selection:");
             LOG_INFO("  Fills: " << stats.adverse_stats.total_fills);
             LOG_INFO("  Adverse Rate: " << (stats.adverse_stats.adverse_fill_rate * 100.0) << "%");
@@ -350,31 +555,246 @@ private:
     Config config_;
     RiskManager& risk_manager_;
     
-    // Strategy instances
-    std::unique_ptr<OrderBookImbalanceStrategy> obi_strategy_;
-    std::unique_ptr<LatencyArbitrageStrategy> latency_arb_strategy_;
-    std::unordered_map<std::string, std::unique_ptr<PairsTradingStrategy>> pairs_strategies_;
-    std::unique_ptr<AdverseSelectionFilter> adverse_filter_;
-    std::unordered_map<std::string, std::unique_ptr<VolatilityArbitrageStrategy>> vol_arb_strategies_;
-    
-    // Helper: Calculate position size for strategy
-    double calculate_position_size(const std::string& symbol, double price, const std::string& strategy) {
-        // Base size from config
-        double base_notional = 5000.0;  // $5k per trade
-        
-        // Adjust based on strategy
-        if (strategy == "OBI") {
-            base_notional = 3000.0;  // Smaller for high-frequency OBI
-        } else if (strategy == "LATENCY_ARB") {
-            base_notional = 5000.0;
-        } else if (strategy == "PAIRS") {
-            base_notional = 5000.0;
-        } else if (strategy == "VOL_ARB") {
-            base_notional = 4000.0;
-        }
-        
-        return base_notional / price;
+    // Strategy instances (held inline; engaged when enabled)
+    std::optional<OrderBookImbalanceStrategy> obi_strategy_;
+    std::optional<LatencyArbitrageStrategy> latency_arb_strategy_;
+    MultiPairManager pairs_;
+    std::vector<MultiPairManager::Crossing> pair_crossings_;
+    OrderIntentBuffer intents_;             // This tick's intents (reused)
+    
+    // Rate-limited single-leg intent awaiting retry
+    struct DeferredIntent {
+        OrderIntent intent;
+        TimePoint retry_at;                 // Earliest time the venue has tokens
+        TimePoint expires_at;               // Dropped after this (signal is stale)
+    };
+    std::vector<DeferredIntent> deferred_;  // Capacity max_deferred_intents (no growth)
+    std::optional<MarkoutEngine> markouts_;
+    std::optional<ToxicityBoard> toxicity_;
+    SymbolMap<std::optional<VolatilityArbitrageStrategy>> vol_arb_strategies_;  // Inline per symbol
+    
+    FeaturePipeline features_;
+    ConsolidatedBBO consolidated_bbo_;
+    
+    OrderGate* order_gate_ = nullptr;
+    FeeEngine* fee_engine_ = nullptr;
+    
+    // Markout flows
+    static constexpr MarkoutEngine::FlowId FLOW_MAKER = 0;
+    static constexpr MarkoutEngine::FlowId FLOW_TAKER = 1;
+    
+    // Strategy S runs: compiled in and, for runtime sets, switched on
+    template<typename S>
+    static constexpr bool is_enabled(const Config& config) {
+        if constexpr (!COMPILED<S>) {
+            return false;
+        } else if constexpr (!RUNTIME) {
+            return true;
+        } else if constexpr (std::is_same_v<S, OrderBookImbalanceStrategy>) {
+            return config.enable_obi;
+        } else if constexpr (std::is_same_v<S, LatencyArbitrageStrategy>) {
+            return config.enable_latency_arb;
+        } else if constexpr (std::is_same_v<S, MultiPairManager>) {
+            return config.enable_pairs;
+        } else if constexpr (std::is_same_v<S, VolatilityArbitrageStrategy>) {
+            return config.enable_vol_arb;
+        } else {
+            return config.enable_adverse_filter;
+        }
+    }
+    
+    template<typename S>
+    bool enabled() const {
+        return is_enabled<S>(config_);
+    }
+    
+    // Pipeline config covering what the strategies read from it
+    static FeaturePipeline::Config pipeline_config(const Config& config) {
+        FeaturePipeline::Config pipeline = config.feature_config;
+        pipeline.volatility = VolatilityArbitrageStrategy::volatility_config(config.vol_arb_config);
+        
+        auto& depths = pipeline.imbalance_depths;
+        size_t obi_levels = static_cast<size_t>(config.obi_config.num_levels);
+        if (is_enabled<OrderBookImbalanceStrategy>(config) && std::find(depths.begin(), depths.end(), obi_levels) == depths.end()) {
+            if (depths.size() == BookFeatures::MAX_DEPTHS) depths.pop_back();
+            depths.push_back(obi_levels);
+        }
+        return pipeline;
+    }
+    
+    // Fills marked out at the toxicity horizon, summed over venues
+    AdverseSelectionFilter::AdverseSelectionStats adverse_stats() const {
+        AdverseSelectionFilter::AdverseSelectionStats stats;
+        double adverse_bps = 0.0;
+        
+        for (size_t v = 0; v < MarkoutEngine::NUM_VENUES; ++v) {
+            const MarkoutStats& venue = markouts_->venue_stats(static_cast<Venue>(v))[config_.toxicity_horizon];
+            stats.total_fills += static_cast<int>(venue.count);
+            stats.adverse_fills += static_cast<int>(venue.adverse_count);
+            stats.total_adverse_cost += venue.adverse_cost;
+            adverse_bps += venue.adverse_bps_sum;
+        }
+        
+        if (stats.total_fills > 0) {
+            stats.adverse_fill_rate = static_cast<double>(stats.adverse_fills) / stats.total_fills;
+        }
+        if (stats.adverse_fills > 0) {
+            stats.avg_adverse_move_bps = adverse_bps / stats.adverse_fills;
+        }
+        return stats;
+    }
+    
+    CointegrationScanner* pair_scanner_ = nullptr;
+    uint64_t scanner_version_ = 0;
+    
+    // New scanner result: activate its pairs (adding unseen ones), deactivate
+    // scanner pairs that dropped out. Runs only when the version changes.
+    void apply_scanner_candidates() {
+        uint64_t version = pair_scanner_->version();
+        if (version == scanner_version_) return;
+        scanner_version_ = version;
+        
+        auto candidates = pair_scanner_->candidates();
+        for (MultiPairManager::PairId pair = 0; pair < pairs_.size(); ++pair) {
+            if (!pairs_.is_pinned(pair)) pairs_.set_active(pair, false);
+        }
+        
+        for (const auto& candidate : candidates) {
+            auto pair = pairs_.find_pair(candidate.symbol1, candidate.symbol2);
+            if (pair == MultiPairManager::INVALID_PAIR) {
+                auto pair_config = config_.pairs_config;
+                pair_config.symbol1 = std::string(get_symbol_name(candidate.symbol1));
+                pair_config.symbol2 = std::string(get_symbol_name(candidate.symbol2));
+                pair = pairs_.add_pair(pair_config.symbol1, pair_config.symbol2, pair_config, false);
+                pairs_.seed_hedge_ratio(pair, candidate.hedge_ratio);
+            }
+            pairs_.set_active(pair, true);
+        }
+        
+        LOG_INFO("Pairs scanner: " << candidates.size() << " active candidates (v" << version << ")");
+    }
+    
+    bool venue_available(Venue venue) const {
+        return !order_gate_ || order_gate_->venue_available(venue);
+    }
+    
+    OrderGate::Decision gate_check(const OrderIntent& intent) {
+        return order_gate_ ? order_gate_->check(intent) : OrderGate::Decision::ALLOW;
+    }
+    
+    // Every path checks risk first and the gate second, so venue rate-limit
+    // tokens are only charged for orders risk has already passed.
+    
+    // Helper: Risk-check then gate the single intent at `mark`. Drops it from
+    // the buffer unless both allow; a RATE_LIMITED intent is deferred.
+    bool admit(size_t mark, double current_price) {
+        const OrderIntent& intent = intents_[mark];
+        if (risk_manager_.check_order(intent, current_price).passed) {
+            auto decision = gate_check(intent);
+            if (decision == OrderGate::Decision::ALLOW) {
+                return true;
+            }
+            if (decision == OrderGate::Decision::RATE_LIMITED) {
+                defer(intent);
+            }
+        }
+        intents_.truncate(mark);
+        return false;
+    }
+    
+    // Park a rate-limited intent; a newer intent from the same strategy and
+    // symbol replaces the waiting one (no doubled orders once tokens free up)
+    void defer(const OrderIntent& intent) {
+        TimePoint now = Clock::now();
+        DeferredIntent entry{intent, now + order_gate_->retry_after(intent.venue),
+                             now + config_.max_defer_time};
+        for (auto& waiting : deferred_) {
+            if (waiting.intent.symbol == intent.symbol && waiting.intent.strategy == intent.strategy) {
+                waiting = entry;
+                return;
+            }
+        }
+        if (deferred_.size() < config_.max_deferred_intents) {
+            deferred_.push_back(entry);
+        }
+    }
+    
+    // Re-run risk and the gate for deferred intents whose retry time has come;
+    // admitted ones join this tick's intents, expired or rejected ones are dropped
+    void retry_deferred(const SymbolMap<double>& current_prices) {
+        if (deferred_.empty()) return;
+        
+        TimePoint now = Clock::now();
+        size_t kept = 0;
+        for (auto& entry : deferred_) {
+            bool keep = false;
+            if (now < entry.expires_at) {
+                if (now < entry.retry_at) {
+                    keep = true;
+                } else {
+                    const double* price = current_prices.find(entry.intent.symbol);
+                    double current_price = price ? *price : entry.intent.price;
+                    if (risk_manager_.check_order(entry.intent, current_price).passed) {
+                        auto decision = gate_check(entry.intent);
+                        if (decision == OrderGate::Decision::ALLOW) {
+                            intents_.emplace(entry.intent);
+                        } else if (decision == OrderGate::Decision::RATE_LIMITED) {
+                            entry.retry_at = now + order_gate_->retry_after(entry.intent.venue);
+                            keep = true;
+                        }
+                    }
+                }
+            }
+            if (keep) {
+                deferred_[kept++] = entry;
+            }
+        }
+        deferred_.erase(deferred_.begin() + static_cast<std::ptrdiff_t>(kept), deferred_.end());
+    }
+    
+    // Helper: Atomically reserve intents [first, first + count), then gate
+    // them all-or-nothing and tag them with the reservation so fills/cancels
+    // can release it. Drops the legs (releasing the reservation) if risk
+    // rejects the group or the gate refuses any leg. Groups are not deferred:
+    // arb legs are IOC against a touch that is gone by the retry, and a
+    // reverted pairs crossing re-signals on the next tick.
+    bool reserve_legs(size_t first, size_t count) {
+        auto legs = intents_.range(first, count);
+        auto reservation = risk_manager_.reserve_orders(std::span<const OrderIntent>(legs));
+        if (!reservation.passed) {
+            intents_.truncate(first);
+            return false;
+        }
+        if (order_gate_ && order_gate_->check_all(legs) != OrderGate::Decision::ALLOW) {
+            risk_manager_.release_reservation(reservation.reservation_id);
+            intents_.truncate(first);
+            return false;
+        }
+        
+        for (size_t i = 0; i < legs.size(); ++i) {
+            legs[i].reservation_id = reservation.reservation_id;
+            legs[i].reservation_leg = static_cast<uint8_t>(i);
+        }
+        return true;
+    }
+    
+    // Helper: Calculate position size for strategy (per-instrument notional, lot-rounded)
+    double calculate_position_size(SymbolRegistry::SymbolId symbol_id, double price, StrategyKind strategy) {
+        static const Instrument default_instrument;
+        
+        const Instrument* instrument = InstrumentMaster::instance().get(symbol_id);
+        if (!instrument) instrument = &default_instrument;
+        
+        return instrument->round_quantity(instrument->notional_for(strategy) / price);
     }
 };
 
+// Runtime-configured coordinator (enable_* flags pick the strategies)
+using StrategyCoordinator = BasicStrategyCoordinator<RuntimeStrategies>;
+
+// Compile-time strategy set, e.g.
+//   StaticStrategyCoordinator<OrderBookImbalanceStrategy, LatencyArbitrageStrategy>
+template<typename... Strategies>
+using StaticStrategyCoordinator = BasicStrategyCoordinator<Strategies...>;
+
 } // namespace trading
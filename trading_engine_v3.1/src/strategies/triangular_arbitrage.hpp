@@ -0,0 +1,516 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include "../core/instrument_master.hpp"
+#include "../core/symbol_map.hpp"
+#include "../market_data/order_book.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading {
+
+// Currency graph - assets are nodes, each instrument contributes two edges:
+//   quote -> base  (buy base at the ask)    rate = (1 / ask) * (1 - fee)
+//   base  -> quote (sell base at the bid)   rate = bid * (1 - fee)
+// Edge weight is -log(rate), so a cycle is profitable when its weights sum
+// below zero. Every simple cycle up to max_hops is enumerated once at build
+// time and indexed by edge; a touch change re-prices only the cycles through
+// the instrument's two edges (a few adds each).
+class CurrencyGraph {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+    using AssetId = uint16_t;
+    using EdgeId = uint32_t;
+    using CycleId = uint32_t;
+
+    static constexpr size_t MAX_HOPS = 4;
+    static constexpr double NO_QUOTE = std::numeric_limits<double>::infinity();
+
+    struct Edge {
+        AssetId from;
+        AssetId to;
+        SymbolId instrument;
+        Side side;                      // BUY = spend quote for base, SELL = base for quote
+        double fee;                     // Fraction, e.g. 0.001
+    };
+
+    struct Cycle {
+        std::array<EdgeId, MAX_HOPS> edges;
+        uint8_t hops;
+    };
+
+    CurrencyGraph() = default;
+
+    // Add an instrument (base/quote from the instrument master); no-op if unknown
+    bool add_instrument(SymbolId instrument, double fee_bps) {
+        const Instrument* info = InstrumentMaster::instance().get(instrument);
+        if (!info || edges_of_.contains(instrument)) return false;
+
+        AssetId base = asset_id(info->base_asset);
+        AssetId quote = asset_id(info->quote_asset);
+        double fee = fee_bps / 10000.0;
+
+        EdgeId buy = add_edge(Edge{quote, base, instrument, Side::BUY, fee});
+        EdgeId sell = add_edge(Edge{base, quote, instrument, Side::SELL, fee});
+        edges_of_[instrument] = {buy, sell};
+        return true;
+    }
+
+    // Enumerate cycles (call after all instruments are added)
+    void build_cycles(size_t max_hops) {
+        max_hops = std::clamp<size_t>(max_hops, 2, MAX_HOPS);
+        cycles_.clear();
+        cycles_of_edge_.assign(edges_.size(), {});
+
+        std::vector<std::vector<EdgeId>> out_edges(asset_names_.size());
+        for (EdgeId e = 0; e < edges_.size(); ++e) {
+            out_edges[edges_[e].from].push_back(e);
+        }
+
+        // Each cycle found once: from its smallest asset, through larger assets only
+        Cycle path{};
+        std::vector<uint8_t> visited(asset_names_.size(), 0);
+        for (AssetId start = 0; start < asset_names_.size(); ++start) {
+            extend(start, start, 0, max_hops, out_edges, visited, path);
+        }
+    }
+
+    // Top-of-book for an instrument; returns true if either edge weight changed
+    bool update_touch(SymbolId instrument, double bid, double ask) {
+        const auto* pair = edges_of_.find(instrument);
+        if (!pair) return false;
+
+        auto [buy, sell] = *pair;
+        double buy_weight = ask > 0.0 ? std::log(ask) - std::log1p(-edges_[buy].fee) : NO_QUOTE;
+        double sell_weight = bid > 0.0 ? -std::log(bid) - std::log1p(-edges_[sell].fee) : NO_QUOTE;
+
+        bool changed = buy_weight != weights_[buy] || sell_weight != weights_[sell];
+        weights_[buy] = buy_weight;
+        weights_[sell] = sell_weight;
+        return changed;
+    }
+
+    // Most negative cycle weight among cycles through this instrument's edges
+    std::optional<CycleId> best_cycle_through(SymbolId instrument, double* weight_out = nullptr) const {
+        const auto* pair = edges_of_.find(instrument);
+        if (!pair) return std::nullopt;
+
+        std::optional<CycleId> best;
+        double best_weight = 0.0;
+        for (EdgeId e : {pair->first, pair->second}) {
+            for (CycleId c : cycles_of_edge_[e]) {
+                double weight = cycle_weight(c);
+                if (weight < best_weight) {
+                    best_weight = weight;
+                    best = c;
+                }
+            }
+        }
+        if (weight_out) *weight_out = best_weight;
+        return best;
+    }
+
+    // Most negative cycle weight over the whole graph (full rescan)
+    std::optional<CycleId> best_cycle(double* weight_out = nullptr) const {
+        std::optional<CycleId> best;
+        double best_weight = 0.0;
+        for (CycleId c = 0; c < cycles_.size(); ++c) {
+            double weight = cycle_weight(c);
+            if (weight < best_weight) {
+                best_weight = weight;
+                best = c;
+            }
+        }
+        if (weight_out) *weight_out = best_weight;
+        return best;
+    }
+
+    double cycle_weight(CycleId c) const {
+        const Cycle& cycle = cycles_[c];
+        double weight = 0.0;
+        for (uint8_t h = 0; h < cycle.hops; ++h) {
+            weight += weights_[cycle.edges[h]];
+        }
+        return weight;
+    }
+
+    const Cycle& cycle(CycleId c) const { return cycles_[c]; }
+    const Edge& edge(EdgeId e) const { return edges_[e]; }
+    const std::string& asset_name(AssetId a) const { return asset_names_[a]; }
+
+    size_t num_assets() const { return asset_names_.size(); }
+    size_t num_edges() const { return edges_.size(); }
+    size_t num_cycles() const { return cycles_.size(); }
+
+private:
+    std::vector<std::string> asset_names_;
+    std::unordered_map<std::string, AssetId> asset_ids_;
+
+    std::vector<Edge> edges_;
+    std::vector<double> weights_;                       // -log(rate), NO_QUOTE until priced
+    SymbolMap<std::pair<EdgeId, EdgeId>> edges_of_;     // Instrument -> (buy, sell)
+
+    std::vector<Cycle> cycles_;
+    std::vector<std::vector<CycleId>> cycles_of_edge_;
+
+    AssetId asset_id(const std::string& name) {
+        auto it = asset_ids_.find(name);
+        if (it != asset_ids_.end()) return it->second;
+
+        AssetId id = static_cast<AssetId>(asset_names_.size());
+        asset_names_.push_back(name);
+        asset_ids_.emplace(name, id);
+        return id;
+    }
+
+    EdgeId add_edge(const Edge& edge) {
+        edges_.push_back(edge);
+        weights_.push_back(NO_QUOTE);
+        return static_cast<EdgeId>(edges_.size() - 1);
+    }
+
+    void extend(AssetId start, AssetId at, size_t depth, size_t max_hops,
+                const std::vector<std::vector<EdgeId>>& out_edges,
+                std::vector<uint8_t>& visited, Cycle& path) {
+        for (EdgeId e : out_edges[at]) {
+            AssetId next = edges_[e].to;
+            path.edges[depth] = e;
+
+            if (next == start) {
+                if (depth + 1 >= 3 || (depth + 1 == 2 && edges_[path.edges[0]].instrument !=
+                                                         edges_[e].instrument)) {
+                    path.hops = static_cast<uint8_t>(depth + 1);
+                    record_cycle(path);
+                }
+                continue;
+            }
+            if (next < start || visited[next] || depth + 1 >= max_hops) continue;
+
+            visited[next] = 1;
+            extend(start, next, depth + 1, max_hops, out_edges, visited, path);
+            visited[next] = 0;
+        }
+    }
+
+    void record_cycle(const Cycle& cycle) {
+        CycleId id = static_cast<CycleId>(cycles_.size());
+        cycles_.push_back(cycle);
+        for (uint8_t h = 0; h < cycle.hops; ++h) {
+            cycles_of_edge_[cycle.edges[h]].push_back(id);
+        }
+    }
+};
+
+// Triangular / multi-hop arbitrage on one venue (e.g. USDT -> BTC -> ETH -> USDT)
+//
+// on_book_update() re-prices the instrument's two graph edges from its touch,
+// checks only the cycles through them, and walks the real book levels of the
+// best candidate to size it and confirm the profit survives depth and fees.
+class TriangularArbitrageStrategy {
+public:
+    using SymbolId = SymbolRegistry::SymbolId;
+
+    struct Config {
+        std::vector<std::string> instruments;  // Canonical symbols forming the graph
+        Venue venue;                        // Fees and orders for this venue
+        size_t max_hops;                    // Cycle length (3 = triangles, up to 4)
+        double min_profit_bps;              // After fees and depth
+        double max_slippage_bps;            // Worst fill vs touch, per leg
+        double max_notional_usd;            // Cap on the starting amount
+        size_t depth_levels;                // Book levels walked per leg
+        std::string usd_asset;              // Asset used to value the start amount
+
+        Config()
+            : instruments({"BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT",
+                           "ETHBTC", "SOLBTC", "BNBBTC"})
+            , venue(Venue::BINANCE)
+            , max_hops(3)
+            , min_profit_bps(15.0)
+            , max_slippage_bps(5.0)
+            , max_notional_usd(5000.0)
+            , depth_levels(10)
+            , usd_asset("USDT")
+        {}
+    };
+
+    struct Leg {
+        std::string symbol;
+        Side side;
+        double price;                       // Limit: worst level touched
+        double quantity;                    // Base quantity
+        double vwap;
+    };
+
+    struct TriangularOpportunity {
+        std::vector<std::string> symbols;
+        std::vector<Side> sides;
+        std::vector<double> prices;
+        std::vector<Leg> legs;
+        std::string start_asset;
+        double start_amount;                // In start_asset
+        double end_amount;
+        double top_of_book_bps;             // Edge before depth
+        double net_profit_bps;              // After fees and depth
+        TimePoint detected_at;
+        bool is_valid;
+
+        TriangularOpportunity()
+            : start_amount(0.0), end_amount(0.0), top_of_book_bps(0.0)
+            , net_profit_bps(0.0), is_valid(false) {}
+    };
+
+    explicit TriangularArbitrageStrategy(const Config& config) : config_(config) {
+        for (const auto& symbol : config_.instruments) {
+            SymbolId id = InstrumentMaster::instance().resolve_any(symbol);
+            if (id == SymbolRegistry::INVALID_SYMBOL) continue;
+
+            const Instrument* info = InstrumentMaster::instance().get(id);
+            graph_.add_instrument(id, info->fees_on(config_.venue).taker_bps);
+        }
+        graph_.build_cycles(config_.max_hops);
+        min_profit_weight_ = -std::log1p(config_.min_profit_bps / 10000.0);
+        
+        // Instrument valuing each asset in usd_asset (e.g. ETH -> ETHUSDT)
+        usd_instrument_.assign(graph_.num_assets(), SymbolRegistry::INVALID_SYMBOL);
+        for (CurrencyGraph::AssetId a = 0; a < graph_.num_assets(); ++a) {
+            usd_instrument_[a] = InstrumentMaster::instance().resolve_any(
+                graph_.asset_name(a) + config_.usd_asset);
+        }
+    }
+
+    // Incremental: one instrument's book changed. `books` maps every graph
+    // instrument to its current book on config.venue (nullptr / absent = no book).
+    std::optional<TriangularOpportunity> on_book_update(
+        SymbolId instrument,
+        const SymbolMap<const OrderBook*>& books)
+    {
+        const OrderBook* const* book = books.find(instrument);
+        if (!book || !*book) return std::nullopt;
+
+        if (!graph_.update_touch(instrument, (*book)->get_best_bid(), (*book)->get_best_ask())) {
+            return std::nullopt;  // Touch unchanged: no cycle moved
+        }
+
+        double weight = 0.0;
+        auto cycle = graph_.best_cycle_through(instrument, &weight);
+        if (!cycle || weight > min_profit_weight_) return std::nullopt;
+
+        return evaluate(*cycle, weight, books);
+    }
+
+    // Full rebuild from a snapshot of books (string keyed)
+    std::optional<TriangularOpportunity> detect_opportunity(
+        const std::unordered_map<std::string, OrderBook>& books)
+    {
+        SymbolMap<const OrderBook*> lookup;
+        for (const auto& [symbol, book] : books) {
+            SymbolId id = InstrumentMaster::instance().resolve_any(symbol);
+            if (id == SymbolRegistry::INVALID_SYMBOL) continue;
+
+            lookup[id] = &book;
+            graph_.update_touch(id, book.get_best_bid(), book.get_best_ask());
+        }
+
+        double weight = 0.0;
+        auto cycle = graph_.best_cycle(&weight);
+        if (!cycle || weight > min_profit_weight_) return std::nullopt;
+
+        return evaluate(*cycle, weight, lookup);
+    }
+
+    // One IOC order per leg, in cycle order
+    std::vector<Order> create_orders(const TriangularOpportunity& opp) const {
+        std::vector<Order> orders;
+        orders.reserve(opp.legs.size());
+        for (const auto& leg : opp.legs) {
+            Order order;
+            order.symbol = leg.symbol;
+            order.venue = config_.venue;
+            order.side = leg.side;
+            order.type = OrderType::LIMIT_IOC;
+            order.price = leg.price;
+            order.quantity = leg.quantity;
+            order.strategy_name = "TRI_ARB";
+            order.created_time = Clock::now();
+            orders.push_back(order);
+        }
+        return orders;
+    }
+
+    const CurrencyGraph& graph() const { return graph_; }
+
+private:
+    Config config_;
+    CurrencyGraph graph_;
+    double min_profit_weight_ = 0.0;
+    std::vector<SymbolId> usd_instrument_;      // By AssetId
+
+    // Result of pushing an amount through one leg's book levels
+    struct Fill {
+        double output = 0.0;
+        double base_quantity = 0.0;
+        double worst_price = 0.0;
+        double notional = 0.0;          // Quote traded (for VWAP)
+        bool complete = false;
+    };
+
+    std::optional<TriangularOpportunity> evaluate(
+        CurrencyGraph::CycleId cycle_id, double weight,
+        const SymbolMap<const OrderBook*>& books) const
+    {
+        const auto& cycle = graph_.cycle(cycle_id);
+
+        std::array<const OrderBook*, CurrencyGraph::MAX_HOPS> leg_books{};
+        for (uint8_t h = 0; h < cycle.hops; ++h) {
+            const OrderBook* const* book = books.find(graph_.edge(cycle.edges[h]).instrument);
+            if (!book || !*book) return std::nullopt;
+            leg_books[h] = *book;
+        }
+
+        // Largest start amount the walked depth supports (touch rates between legs)
+        double capacity = std::numeric_limits<double>::infinity();
+        double rate_so_far = 1.0;
+        for (uint8_t h = 0; h < cycle.hops; ++h) {
+            const auto& edge = graph_.edge(cycle.edges[h]);
+            capacity = std::min(capacity, input_capacity(edge, *leg_books[h]) / rate_so_far);
+            rate_so_far *= touch_rate(edge, *leg_books[h]);
+        }
+
+        double budget = std::min(capacity, start_budget(graph_.edge(cycle.edges[0]).from, books));
+        if (!(budget > 0.0) || !std::isfinite(budget)) return std::nullopt;
+
+        // Try a few sizes; keep the one with the largest absolute profit
+        TriangularOpportunity best;
+        double best_profit = 0.0;
+        for (double fraction : {1.0, 0.5, 0.25, 0.125, 0.0625}) {
+            TriangularOpportunity opp;
+            if (!walk_cycle(cycle, leg_books, budget * fraction, opp)) continue;
+
+            double profit = opp.end_amount - opp.start_amount;
+            if (opp.net_profit_bps >= config_.min_profit_bps && profit > best_profit) {
+                best_profit = profit;
+                best = std::move(opp);
+            }
+        }
+        if (best_profit <= 0.0) return std::nullopt;
+
+        best.start_asset = graph_.asset_name(graph_.edge(cycle.edges[0]).from);
+        best.top_of_book_bps = std::expm1(-weight) * 10000.0;
+        best.detected_at = Clock::now();
+        best.is_valid = true;
+        return best;
+    }
+
+    bool walk_cycle(const CurrencyGraph::Cycle& cycle,
+                    const std::array<const OrderBook*, CurrencyGraph::MAX_HOPS>& leg_books,
+                    double start_amount, TriangularOpportunity& opp) const {
+        double amount = start_amount;
+        for (uint8_t h = 0; h < cycle.hops; ++h) {
+            const auto& edge = graph_.edge(cycle.edges[h]);
+            const OrderBook& book = *leg_books[h];
+
+            Fill fill = edge.side == Side::BUY ? walk_asks(book, amount, edge.fee)
+                                               : walk_bids(book, amount, edge.fee);
+            if (!fill.complete) return false;
+
+            double touch = edge.side == Side::BUY ? book.get_best_ask() : book.get_best_bid();
+            double slippage_bps = std::abs(fill.worst_price - touch) / touch * 10000.0;
+            if (slippage_bps > config_.max_slippage_bps) return false;
+
+            Leg leg;
+            leg.symbol = std::string(get_symbol_name(edge.instrument));
+            leg.side = edge.side;
+            leg.price = fill.worst_price;
+            leg.quantity = fill.base_quantity;
+            leg.vwap = fill.notional / fill.base_quantity;
+
+            opp.symbols.push_back(leg.symbol);
+            opp.sides.push_back(leg.side);
+            opp.prices.push_back(leg.price);
+            opp.legs.push_back(std::move(leg));
+            amount = fill.output;
+        }
+
+        opp.start_amount = start_amount;
+        opp.end_amount = amount;
+        opp.net_profit_bps = (amount / start_amount - 1.0) * 10000.0;
+        return true;
+    }
+
+    // Spend `quote_amount` of quote buying base up the asks
+    Fill walk_asks(const OrderBook& book, double quote_amount, double fee) const {
+        Fill fill;
+        double remaining = quote_amount;
+        size_t levels = 0;
+        for (const auto& [price, quantity] : book.get_asks()) {
+            if (levels++ >= config_.depth_levels || remaining <= 0.0) break;
+            double spend = std::min(remaining, price * quantity);
+            double base = spend / price;
+            fill.base_quantity += base;
+            fill.notional += spend;
+            fill.worst_price = price;
+            remaining -= spend;
+        }
+        fill.complete = remaining <= quote_amount * 1e-12;
+        fill.output = fill.base_quantity * (1.0 - fee);
+        return fill;
+    }
+
+    // Sell `base_amount` of base down the bids
+    Fill walk_bids(const OrderBook& book, double base_amount, double fee) const {
+        Fill fill;
+        double remaining = base_amount;
+        size_t levels = 0;
+        for (const auto& [price, quantity] : book.get_bids()) {
+            if (levels++ >= config_.depth_levels || remaining <= 0.0) break;
+            double sell = std::min(remaining, quantity);
+            fill.base_quantity += sell;
+            fill.notional += sell * price;
+            fill.worst_price = price;
+            remaining -= sell;
+        }
+        fill.complete = remaining <= base_amount * 1e-12;
+        fill.output = fill.notional * (1.0 - fee);
+        return fill;
+    }
+
+    // Input units (quote for BUY, base for SELL) available in the walked levels
+    double input_capacity(const CurrencyGraph::Edge& edge, const OrderBook& book) const {
+        double total = 0.0;
+        size_t levels = 0;
+        if (edge.side == Side::BUY) {
+            for (const auto& [price, quantity] : book.get_asks()) {
+                if (levels++ >= config_.depth_levels) break;
+                total += price * quantity;
+            }
+        } else {
+            for (const auto& [price, quantity] : book.get_bids()) {
+                if (levels++ >= config_.depth_levels) break;
+                total += quantity;
+            }
+        }
+        return total;
+    }
+
+    static double touch_rate(const CurrencyGraph::Edge& edge, const OrderBook& book) {
+        double rate = edge.side == Side::BUY ? 1.0 / book.get_best_ask() : book.get_best_bid();
+        return rate * (1.0 - edge.fee);
+    }
+
+    // max_notional_usd expressed in the start asset (unbounded if it can't be valued)
+    double start_budget(CurrencyGraph::AssetId start, const SymbolMap<const OrderBook*>& books) const {
+        if (graph_.asset_name(start) == config_.usd_asset) return config_.max_notional_usd;
+
+        const OrderBook* const* book = books.find(usd_instrument_[start]);
+        double mid = book && *book ? (*book)->get_mid_price() : 0.0;
+        return mid > 0.0 ? config_.max_notional_usd / mid : std::numeric_limits<double>::infinity();
+    }
+};
+
+} // namespace trading
@@ -2,6 +2,8 @@
 
 #include "../core/types.hpp"
 #include "../core/circular_buffer.hpp"
+#include "../core/volatility_estimator.hpp"
+#include "../core/order_intent.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -79,29 +81,32 @@ public:
     
     explicit VolatilityArbitrageStrategy(const Config& config)
         : config_(config)
-        , price_history_(config.atr_period * 2)
-        , atr_history_(50)
+        , price_history_(std::max(config.atr_period * 2, 10))
+        , volatility_(volatility_config(config))
     {}
     
-    // Update with new price - circular buffer auto-manages size
+    // Estimator settings matching this strategy's ATR (for a shared VolatilityService)
+    static VolatilityEstimator::Config volatility_config(const Config& config) {
+        VolatilityEstimator::Config vol_config;
+        vol_config.atr_period = static_cast<size_t>(std::max(config.atr_period, 1));
+        vol_config.atr_mean_window = 50;
+        vol_config.atr_mean_min_samples = 10;
+        return vol_config;
+    }
+    
+    // Update with new price - feeds the strategy's own estimator
     void update_price(double price) {
+        volatility_.update(price);
+        update_price(price, volatility_);
+    }
+    
+    // Update with new price - ATR read from a shared estimator already fed this tick
+    void update_price(double price, const VolatilityEstimator& volatility) {
         price_history_.push_back(price);
         
-        // Calculate ATR when we have enough data
-        if (price_history_.size() >= config_.atr_period + 1) {
-            current_atr_ = calculate_atr();
-            
-            atr_history_.push_back(current_atr_);
-            
-            // Calculate average ATR
-            if (atr_history_.size() >= 10) {
-                double sum = 0.0;
-                for (size_t i = 0; i < atr_history_.size(); ++i) {
-                    sum += atr_history_[i];
-                }
-                avg_atr_ = sum / atr_history_.size();
-            }
-        }
+        atr_ready_ = volatility.has_atr();
+        current_atr_ = volatility.atr();
+        avg_atr_ = volatility.avg_atr();
     }
     
     // Detect volatility regime
@@ -129,7 +134,7 @@ public:
         signal.current_atr = current_atr_;
         signal.avg_atr = avg_atr_;
         
-        if (avg_atr_ < 0.000001 || price_history_.size() < config_.atr_period + 1) {
+        if (avg_atr_ < 0.000001 || !atr_ready_) {
             return signal;  // Not enough data
         }
         
@@ -193,11 +198,19 @@ public:
         order.price = signal.entry_price;
         order.quantity = quantity;
         order.strategy_name = "VOL_ARB";
+        order.strategy = StrategyKind::VOL_ARB;
         order.created_time = Clock::now();
         
         return order;
     }
     
+    // Same, appended to the tick's intent buffer
+    OrderIntent& emplace_order(OrderIntentBuffer& out, SymbolRegistry::SymbolId symbol, Venue venue,
+                               const VolSignal& signal, double quantity) const {
+        return out.emplace(symbol, venue, signal.primary_side, OrderType::LIMIT,
+                           signal.entry_price, quantity, StrategyKind::VOL_ARB);
+    }
+    
     // Should exit based on time or volatility regime change?
     bool should_exit(const VolSignal& entry_signal) {
         // Check hold time
@@ -281,46 +294,15 @@ public:
 private:
     Config config_;
     
-    CircularBuffer<double> price_history_;
-    CircularBuffer<double> atr_history_;
+    CircularBuffer<double> price_history_;      // Recent prices for spike detection
+    VolatilityEstimator volatility_;            // Used when no shared estimator is given
     
+    bool atr_ready_ = false;
     double current_atr_ = 0.0;
     double avg_atr_ = 0.0;
     
     VolArbStats stats_;
     
-    // Calculate ATR (Average True Range) - uses circular buffer
-    double calculate_atr() {
-        size_t history_size = price_history_.size();
-        if (history_size < config_.atr_period + 1) {
-            return 0.0;
-        }
-        
-        double sum_tr = 0.0;
-        size_t start_idx = history_size - config_.atr_period;
-        
-        for (size_t i = start_idx; i < history_size; ++i) {
-            double high = price_history_[i];
-            double low = price_history_[i];
-            double prev_close = price_history_[i-1];
-            
-            // True Range = max of:
-            // 1. high - low
-            // 2. abs(high - prev_close)
-            // 3. abs(low - prev_close)
-            
-            double tr = std::max({
-                high - low,
-                std::abs(high - prev_close),
-                std::abs(low - prev_close)
-            });
-            
-            sum_tr += tr;
-        }
-        
-        return sum_tr / config_.atr_period;
-    }
-    
     // Check if recent price spiked up
     bool is_recent_price_spike_up() const {
         if (price_history_.size() < 10) {
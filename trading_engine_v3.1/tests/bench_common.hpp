@@ -0,0 +1,34 @@
+#pragma once
+
+// Minimal benchmark support: wall-clock timing of a repeated body.
+// Benchmarks build under BUILD_TESTS but are not registered with ctest.
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace trading::bench {
+
+// Keep the optimizer from discarding a result
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Nanoseconds per call of body(), after one warm-up call
+template<typename F>
+double ns_per_op(uint64_t iterations, F&& body) {
+    body();
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        body();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+inline void report(const char* name, size_t n, double ns) {
+    std::printf("%-44s n=%-6zu %12.1f ns/op\n", name, n, ns);
+}
+
+} // namespace trading::bench
@@ -0,0 +1,138 @@
+#include "bench_common.hpp"
+#include "core/risk_manager.hpp"
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+// ===== Mark-to-market: SoA PositionBook vs the string-keyed map it replaced =====
+
+struct MapPosition {
+    double quantity = 0.0;
+    double avg_price = 0.0;
+    double unrealized_pnl = 0.0;
+    double notional_value = 0.0;
+};
+
+void bench_mark_to_market(size_t num_symbols) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> qty(-5.0, 5.0);
+    std::uniform_real_distribution<double> px(10.0, 1000.0);
+
+    PositionBook book;
+    std::unordered_map<std::string, MapPosition> map_positions;
+    std::unordered_map<std::string, double> map_prices;
+    std::vector<double> prices(num_symbols);
+
+    for (size_t i = 0; i < num_symbols; ++i) {
+        auto id = static_cast<PositionBook::SymbolId>(i);
+        double q = qty(rng);
+        double p = px(rng);
+        book.apply_fill(id, q > 0 ? Side::BUY : Side::SELL, p, std::abs(q), 0.0, TimePoint{});
+
+        std::string name = "SYM" + std::to_string(i);
+        map_positions[name] = MapPosition{q, p, 0.0, 0.0};
+        map_prices[name] = p * 1.01;
+        prices[i] = p * 1.01;
+    }
+
+    uint64_t iterations = num_symbols >= 10000 ? 2000 : 20000;
+
+    double soa = bench::ns_per_op(iterations, [&] {
+        auto totals = book.mark_to_market(prices);
+        bench::do_not_optimize(totals.gross_exposure);
+    });
+
+    double map = bench::ns_per_op(iterations, [&] {
+        double unrealized = 0.0;
+        double gross = 0.0;
+        for (auto& [symbol, pos] : map_positions) {
+            auto it = map_prices.find(symbol);
+            if (it == map_prices.end()) continue;
+            pos.unrealized_pnl = pos.quantity * (it->second - pos.avg_price);
+            pos.notional_value = std::abs(pos.quantity * it->second);
+            unrealized += pos.unrealized_pnl;
+            gross += pos.notional_value;
+        }
+        bench::do_not_optimize(unrealized);
+        bench::do_not_optimize(gross);
+    });
+
+    bench::report("mark_to_market PositionBook (SoA)", num_symbols, soa);
+    bench::report("mark_to_market unordered_map<string>", num_symbols, map);
+}
+
+// ===== Reservations: reserve + release with N groups already in flight =====
+
+void bench_reservations(size_t in_flight, size_t num_threads) {
+    RiskLimits limits;
+    limits.max_order_size = 1e12;
+    limits.max_position_per_symbol = 1e15;
+    limits.max_total_gross_exposure = 1e18;
+    limits.max_single_symbol_pct = 1.0;
+    limits.max_orders_per_second = 0;
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+
+    const auto& symbols = COMMON_SYMBOLS;
+    auto pair_legs = [&](size_t k) {
+        std::array<Order, 2> legs;
+        legs[0].symbol = std::string(symbols[k % symbols.size()]);
+        legs[0].side = Side::BUY;
+        legs[0].price = 100.0;
+        legs[0].quantity = 1.0;
+        legs[1].symbol = std::string(symbols[(k + 1) % symbols.size()]);
+        legs[1].side = Side::SELL;
+        legs[1].price = 100.0;
+        legs[1].quantity = 1.0;
+        return legs;
+    };
+
+    for (size_t k = 0; k < in_flight; ++k) {
+        auto legs = pair_legs(k);
+        risk.reserve_orders(std::span<const Order>(legs));
+    }
+
+    constexpr uint64_t OPS_PER_THREAD = 50000;
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint64_t i = 0; i < OPS_PER_THREAD; ++i) {
+                auto legs = pair_legs(t * 7 + i);
+                auto result = risk.reserve_orders(std::span<const Order>(legs));
+                if (result.passed) {
+                    risk.release_reservation(result.reservation_id);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+                static_cast<double>(OPS_PER_THREAD);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "reserve+release, %zu threads (per thread)", num_threads);
+    bench::report(name, in_flight, ns);
+}
+
+} // namespace
+
+int main() {
+    for (size_t n : {size_t(1000), size_t(10000)}) {
+        bench_mark_to_market(n);
+    }
+    for (size_t n : {size_t(1000), size_t(10000)}) {
+        bench_reservations(n, 1);
+        bench_reservations(n, 4);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "bench_common.hpp"
+#include "strategies/strategy_coordinator.hpp"
+#include <string>
+#include <unordered_map>
+
+using namespace trading;
+
+namespace {
+
+// Balanced two-venue book: no strategy signals, so a tick measures the
+// dispatch and feature path rather than order handling
+struct Market {
+    std::string symbol = "BTCUSDT";
+    std::unordered_map<Venue, OrderBook> books;
+    SymbolMap<double> prices;
+
+    Market() {
+        for (Venue venue : {Venue::BINANCE, Venue::BYBIT}) {
+            OrderBook& book = books[venue];
+            for (int i = 0; i < 10; ++i) {
+                book.update_bid(50000.0 - i, 2.0);
+                book.update_ask(50001.0 + i, 2.0);
+            }
+        }
+        prices[symbols::BTCUSDT] = 50000.5;
+        prices[symbols::ETHUSDT] = 2500.0;
+    }
+};
+
+template<typename Coordinator>
+double ns_per_tick(Coordinator& coordinator, Market& market) {
+    Venue venues[2] = {Venue::BINANCE, Venue::BYBIT};
+    uint64_t tick = 0;
+    return bench::ns_per_op(200000, [&] {
+        Venue venue = venues[tick++ & 1];
+        auto intents = coordinator.generate_intents(market.symbol, venue, market.books[venue],
+                                                    market.books, market.prices);
+        bench::do_not_optimize(intents.size());
+    });
+}
+
+StrategyCoordinatorConfig only_obi() {
+    StrategyCoordinatorConfig config;
+    config.enable_latency_arb = false;
+    config.enable_pairs = false;
+    config.enable_vol_arb = false;
+    config.enable_adverse_filter = false;
+    return config;
+}
+
+} // namespace
+
+// Runtime (enable_* flags) vs compile-time strategy sets, per generate_intents tick
+int main() {
+    Market market;
+    RiskLimits limits;
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+
+    {
+        StrategyCoordinator runtime(only_obi(), risk);
+        StaticStrategyCoordinator<OrderBookImbalanceStrategy> compiled(StrategyCoordinatorConfig(), risk);
+        bench::report("OBI only: runtime flags", 1, ns_per_tick(runtime, market));
+        bench::report("OBI only: compile-time set", 1, ns_per_tick(compiled, market));
+    }
+
+    {
+        StrategyCoordinatorConfig config;
+        config.pairs.clear();
+        StrategyCoordinator runtime(config, risk);
+        StaticStrategyCoordinator<OrderBookImbalanceStrategy, LatencyArbitrageStrategy,
+                                  MultiPairManager, VolatilityArbitrageStrategy,
+                                  AdverseSelectionFilter> compiled(config, risk);
+        bench::report("all five: runtime flags", 5, ns_per_tick(runtime, market));
+        bench::report("all five: compile-time set", 5, ns_per_tick(compiled, market));
+    }
+
+    return 0;
+}
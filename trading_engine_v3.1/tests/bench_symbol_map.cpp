@@ -0,0 +1,92 @@
+#include "bench_common.hpp"
+#include "core/symbol_map.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+// Per-symbol state: SymbolMap indexed by SymbolId vs the
+// unordered_map<std::string, T> it replaced (per-op times are per symbol)
+void bench_symbol_map(size_t num_symbols) {
+    std::vector<std::string> names;
+    std::vector<SymbolRegistry::SymbolId> ids;
+    SymbolMap<double> dense;
+    std::unordered_map<std::string, double> by_name;
+
+    for (size_t i = 0; i < num_symbols; ++i) {
+        names.push_back("BENCH" + std::to_string(i) + "USDT");
+        ids.push_back(register_symbol(names.back()));
+        dense[ids.back()] = 100.0 + i;
+        by_name[names.back()] = 100.0 + i;
+    }
+
+    // Random access order, same for both
+    std::vector<size_t> order(num_symbols);
+    for (size_t i = 0; i < num_symbols; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    uint64_t iterations = 2000000 / num_symbols;
+    double per_symbol = static_cast<double>(num_symbols);
+
+    double id_lookup = bench::ns_per_op(iterations, [&] {
+        double sum = 0.0;
+        for (size_t k : order) {
+            double* price = dense.find(ids[k]);
+            *price += 1e-9;
+            sum += *price;
+        }
+        bench::do_not_optimize(sum);
+    }) / per_symbol;
+
+    double name_lookup = bench::ns_per_op(iterations, [&] {
+        double sum = 0.0;
+        for (size_t k : order) {
+            auto it = by_name.find(names[k]);
+            it->second += 1e-9;
+            sum += it->second;
+        }
+        bench::do_not_optimize(sum);
+    }) / per_symbol;
+
+    double registry_lookup = bench::ns_per_op(iterations, [&] {
+        double sum = 0.0;
+        for (size_t k : order) {
+            double* price = dense.find(std::string_view(names[k]));
+            *price += 1e-9;
+            sum += *price;
+        }
+        bench::do_not_optimize(sum);
+    }) / per_symbol;
+
+    double dense_scan = bench::ns_per_op(iterations, [&] {
+        double sum = 0.0;
+        for (auto [id, price] : dense) sum += price;
+        bench::do_not_optimize(sum);
+    }) / per_symbol;
+
+    double map_scan = bench::ns_per_op(iterations, [&] {
+        double sum = 0.0;
+        for (const auto& [name, price] : by_name) sum += price;
+        bench::do_not_optimize(sum);
+    }) / per_symbol;
+
+    bench::report("lookup SymbolMap by SymbolId", num_symbols, id_lookup);
+    bench::report("lookup SymbolMap by name (registry + index)", num_symbols, registry_lookup);
+    bench::report("lookup unordered_map<string>", num_symbols, name_lookup);
+    bench::report("scan SymbolMap", num_symbols, dense_scan);
+    bench::report("scan unordered_map<string>", num_symbols, map_scan);
+}
+
+} // namespace
+
+int main() {
+    for (size_t n : {size_t(16), size_t(1000), size_t(5000)}) {
+        bench_symbol_map(n);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// Minimal test support: no framework, each test is an executable whose
+// exit code ctest checks. Engine headers expect the LOG_* macros from the
+// including translation unit; tests log to the console.
+// Shared fixtures (orders, books) live here rather than in each test.
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#ifndef LOG_ERROR
+#define LOG_ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl
+#define LOG_WARN(msg) std::cerr << "[WARN] " << msg << std::endl
+#define LOG_INFO(msg) std::cout << "[INFO] " << msg << std::endl
+#endif
+
+#include "core/types.hpp"
+#include "market_data/order_book.hpp"
+
+namespace trading::test {
+
+inline int failures = 0;
+
+inline int result() {
+    if (failures == 0) {
+        std::cout << "PASS" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    std::cout << failures << " check(s) FAILED" << std::endl;
+    return EXIT_FAILURE;
+}
+
+// Limit order leg for risk checks and reservations
+inline Order leg(const char* symbol, Side side, double price, double quantity,
+                 Venue venue = Venue::BINANCE) {
+    Order order;
+    order.symbol = symbol;
+    order.venue = venue;
+    order.side = side;
+    order.price = price;
+    order.quantity = quantity;
+    return order;
+}
+
+// Book with `depth` levels per side, one price unit apart from the touch
+inline OrderBook make_book(double bid, double ask, double bid_qty = 1.0, double ask_qty = 1.0,
+                           int depth = 5) {
+    OrderBook book;
+    for (int i = 0; i < depth; ++i) {
+        book.update_bid(bid - i, bid_qty);
+        book.update_ask(ask + i, ask_qty);
+    }
+    return book;
+}
+
+} // namespace trading::test
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" \
+                      << std::endl;                                             \
+            ++trading::test::failures;                                          \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps)                                                   \
+    do {                                                                        \
+        double check_a_ = (a), check_b_ = (b);                                  \
+        if (std::abs(check_a_ - check_b_) > (eps)) {                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_NEAR(" #a ", " #b \
+                      << ") failed: " << check_a_ << " vs " << check_b_ << std::endl; \
+            ++trading::test::failures;                                          \
+        }                                                                       \
+    } while (0)
@@ -0,0 +1,105 @@
+#include "test_common.hpp"
+#include "strategies/strategy_coordinator.hpp"
+
+using namespace trading;
+
+// The consolidated BBO takes each tick from the venue that ticked only
+int main() {
+    RiskLimits limits;
+    limits.max_single_symbol_pct = 1.0;
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+    StrategyCoordinatorConfig config;
+    config.latency_arb_config.max_execution_latency_us = 1e9;
+    StaticStrategyCoordinator<LatencyArbitrageStrategy> coordinator(config, risk);
+
+    const std::string symbol = "BTCUSDT";
+    SymbolMap<double> prices;
+    std::unordered_map<Venue, OrderBook> books;
+    books[Venue::BINANCE] = test::make_book(50000.0, 50001.0, 1.0, 1.0, 1);
+    books[Venue::BYBIT] = test::make_book(50200.0, 50201.0, 1.0, 1.0, 1);
+
+    // First tick: only Bybit has been seen
+    CHECK(coordinator.generate_intents(symbol, Venue::BYBIT, books[Venue::BYBIT], books, prices).empty());
+    const InstrumentBBO* bbo = coordinator.consolidated_bbo().get(symbols::BTCUSDT);
+    CHECK(bbo != nullptr);
+    CHECK(bbo->best_bid_venue() == Venue::BYBIT);
+    CHECK(bbo->best_ask_venue() == Venue::BYBIT);
+    CHECK(coordinator.features().get(symbols::BTCUSDT) == nullptr);  // Primary venue only
+
+    // Binance ticks: cheap ask there, rich bid on Bybit -> both arb legs
+    auto intents = coordinator.generate_intents(symbol, Venue::BINANCE, books[Venue::BINANCE], books, prices);
+    CHECK(intents.size() == 2);
+    CHECK(bbo->best_ask_venue() == Venue::BINANCE);
+    CHECK_NEAR(bbo->best_ask(), 50001.0, 1e-9);
+    CHECK_NEAR(bbo->best_bid(), 50200.0, 1e-9);
+    CHECK_NEAR(coordinator.features().get(symbols::BTCUSDT)->mid, 50000.5, 1e-9);
+
+    // Bybit's book moves without a Bybit tick: a Binance tick doesn't re-read it
+    books[Venue::BYBIT] = test::make_book(49000.0, 49001.0, 1.0, 1.0, 1);
+    coordinator.generate_intents(symbol, Venue::BINANCE, books[Venue::BINANCE], books, prices);
+    CHECK_NEAR(bbo->best_bid(), 50200.0, 1e-9);
+
+    // Its own tick does
+    coordinator.generate_intents(symbol, Venue::BYBIT, books[Venue::BYBIT], books, prices);
+    CHECK(bbo->best_bid_venue() == Venue::BINANCE);
+    CHECK_NEAR(bbo->best_ask(), 49001.0, 1e-9);
+    CHECK_NEAR(coordinator.features().get(symbols::BTCUSDT)->mid, 50000.5, 1e-9);
+
+    // One monitored venue holds both best quotes (crossed feed) with both
+    // runners-up on an unmonitored venue: the arb against the other
+    // monitored venue is still found
+    {
+        LatencyArbitrageStrategy::Config arb_config;
+        arb_config.venues = {Venue::BINANCE, Venue::BYBIT};
+        arb_config.max_execution_latency_us = 1e9;
+        LatencyArbitrageStrategy arb(arb_config);
+
+        std::unordered_map<Venue, OrderBook> crossed;
+        crossed[Venue::BINANCE] = test::make_book(50100.0, 49900.0, 1.0, 1.0, 1);
+        crossed[Venue::KRAKEN] = test::make_book(50050.0, 49950.0, 1.0, 1.0, 1);
+        crossed[Venue::BYBIT] = test::make_book(50000.0, 49980.0, 1.0, 1.0, 1);
+        InstrumentBBO touch;
+        for (const auto& [venue, venue_book] : crossed) {
+            touch.update(venue, venue_book);
+        }
+        CHECK(touch.best_bid_venue() == Venue::BINANCE);
+        CHECK(touch.best_ask_venue() == Venue::BINANCE);
+
+        auto opp = arb.detect_opportunity(symbol, touch, &crossed);
+        CHECK(opp.has_value());
+        if (opp) {
+            CHECK(opp->buy_venue != Venue::KRAKEN && opp->sell_venue != Venue::KRAKEN);
+            CHECK(opp->buy_venue != opp->sell_venue);
+        }
+    }
+
+    // Sized against depth, the opportunity reports the edge of the whole
+    // size (average fills), not the touch
+    {
+        LatencyArbitrageStrategy::Config arb_config;
+        arb_config.venues = {Venue::BINANCE, Venue::BYBIT};
+        arb_config.max_execution_latency_us = 1e9;
+        LatencyArbitrageStrategy arb(arb_config);
+
+        std::unordered_map<Venue, OrderBook> deep;
+        deep[Venue::BINANCE] = test::make_book(49990.0, 50000.0, 0.05, 0.05, 5);
+        deep[Venue::BYBIT] = test::make_book(50100.0, 50110.0, 0.05, 0.05, 5);
+        auto opp = arb.detect_opportunity(symbol, deep);
+        CHECK(opp.has_value());
+        if (opp) {
+            double touch_net_bps = (50100.0 - 50000.0) / 50000.0 * 10000.0 - arb_config.fee_bps;
+            double buy_notional = 0.0, remaining = opp->execute_quantity;
+            for (const auto& [price, quantity] : deep[Venue::BINANCE].get_asks()) {
+                double take = std::min(quantity, remaining);
+                buy_notional += take * price;
+                remaining -= take;
+            }
+            CHECK(opp->buy_price > 50000.0);
+            CHECK(opp->net_profit_bps < touch_net_bps);
+            CHECK_NEAR(opp->net_profit_bps, opp->expected_profit_usd / buy_notional * 10000.0, 1e-9);
+        }
+    }
+
+    return test::result();
+}
@@ -0,0 +1,75 @@
+#include "test_common.hpp"
+#include <random>
+
+using namespace trading;
+
+namespace {
+
+// Ladder rebuilt from scratch over the side's first LEVELS levels
+template<typename Side>
+bool matches(const DepthLadder& ladder, const Side& side) {
+    size_t expected_levels = std::min(side.size(), DepthLadder::LEVELS);
+    CHECK(ladder.levels == expected_levels);
+    if (ladder.levels != expected_levels) return false;
+
+    double cum_quantity = 0.0;
+    double cum_notional = 0.0;
+    size_t level = 0;
+    bool ok = true;
+    for (auto it = side.begin(); level < expected_levels; ++it, ++level) {
+        cum_quantity += it->second;
+        cum_notional += it->first * it->second;
+        ok = ok && ladder.price[level] == it->first && ladder.quantity[level] == it->second &&
+             std::abs(ladder.cum_quantity[level] - cum_quantity) <= 1e-9 * cum_quantity &&
+             std::abs(ladder.cum_notional[level] - cum_notional) <= 1e-9 * cum_notional;
+    }
+    CHECK(ok);
+    return ok;
+}
+
+} // namespace
+
+// Lazily invalidated ladders match a brute-force rebuild, whatever mix of
+// updates (inside, at the edge of, or beyond the cached levels) came between reads
+int main() {
+    for (int run = 0; run < 200; ++run) {
+        std::mt19937_64 rng(43 + run);
+        OrderBook book;
+
+        // Narrow grids keep sides near the 20-level ladder size, wide ones beyond it
+        int span = 10 + static_cast<int>(rng() % 60);
+        bool ok = true;
+        for (int i = 0; i < 2000 && ok; ++i) {
+            bool bid = rng() % 2 == 0;
+            int offset = static_cast<int>(rng() % span);
+            double price = bid ? 1000.0 - offset * 0.5 : 1000.5 + offset * 0.5;
+            double quantity = rng() % 3 == 0 ? 0.0 : 0.001 * (1 + rng() % 5000);
+            if (bid) {
+                book.update_bid(price, quantity);
+            } else {
+                book.update_ask(price, quantity);
+            }
+
+            // Read after a random number of updates (sometimes every one)
+            if (rng() % 4 == 0) {
+                ok = matches(book.bid_ladder(), book.get_bids()) &&
+                     matches(book.ask_ladder(), book.get_asks());
+            }
+        }
+        ok = ok && matches(book.bid_ladder(), book.get_bids()) &&
+             matches(book.ask_ladder(), book.get_asks());
+
+        // Reading twice with no update in between serves the same ladder
+        ok = ok && matches(book.bid_ladder(), book.get_bids());
+
+        book.clear();
+        ok = ok && matches(book.bid_ladder(), book.get_bids()) &&
+             matches(book.ask_ladder(), book.get_asks());
+        if (!ok) {
+            std::cerr << "run " << run << " failed" << std::endl;
+            break;
+        }
+    }
+
+    return test::result();
+}
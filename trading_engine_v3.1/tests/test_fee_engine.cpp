@@ -0,0 +1,111 @@
+#include "test_common.hpp"
+#include "core/fee_engine.hpp"
+#include <random>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+int64_t day_of(TimePoint when) {
+    return std::chrono::duration_cast<std::chrono::hours>(when.time_since_epoch()).count() / 24;
+}
+
+} // namespace
+
+// 30-day volume and the tier it selects match a brute-force sum over every
+// fill inside the window, through tier moves in both directions, late fills
+// and days that expire with no fills
+int main() {
+    const std::vector<Venue> venues = {Venue::BINANCE, Venue::COINBASE, Venue::KRAKEN};
+    const std::vector<double> binance_thresholds = {0.0, 1e6, 5e6, 20e6, 100e6};
+    const std::vector<double> binance_taker = {10.0, 10.0, 10.0, 6.0, 5.4};
+
+    for (int run = 0; run < 50; ++run) {
+        std::mt19937_64 rng(44 + run);
+        FeeEngine fees;
+        fees.load_defaults();
+
+        struct Recorded {
+            Venue venue;
+            int64_t day;
+            double notional;
+        };
+        std::vector<Recorded> recorded;
+        std::vector<int64_t> latest(FeeEngine::NUM_VENUES, 0);
+
+        TimePoint now = Clock::now();
+        int moves = 0;
+        size_t last_tier = 0;
+        bool ok = true;
+
+        for (int step = 0; step < 2000 && ok; ++step) {
+            // Mostly intraday steps, sometimes quiet stretches past the window
+            int hours = rng() % 40 == 0 ? 24 * static_cast<int>(5 + rng() % 40)
+                                        : static_cast<int>(rng() % 12);
+            now += std::chrono::hours(hours);
+
+            Venue venue = venues[rng() % venues.size()];
+            size_t v = static_cast<size_t>(venue);
+            if (rng() % 5 == 0) {
+                fees.roll(now);
+                for (size_t i = 0; i < latest.size(); ++i) {
+                    latest[i] = std::max(latest[i], day_of(now));
+                }
+            } else {
+                // Late fills land up to 40 days back (some outside the window)
+                TimePoint when = rng() % 6 == 0 ? now - std::chrono::hours(rng() % (40 * 24)) : now;
+                double notional = std::pow(10.0, 2.0 + (rng() % 5500) / 1000.0);
+                fees.record_volume(venue, notional, when);
+                latest[v] = std::max(latest[v], day_of(when));
+                recorded.push_back({venue, day_of(when), notional});
+            }
+
+            for (Venue check : venues) {
+                size_t c = static_cast<size_t>(check);
+                double expected = 0.0;
+                for (const auto& fill : recorded) {
+                    if (fill.venue == check && fill.day > latest[c] - 30 && fill.day <= latest[c]) {
+                        expected += fill.notional;
+                    }
+                }
+                CHECK_NEAR(fees.volume_30d(check), expected, 1e-9 * std::max(expected, 1.0));
+                ok = ok && std::abs(fees.volume_30d(check) - expected) <= 1e-9 * std::max(expected, 1.0);
+            }
+
+            // Binance tier and taker rate follow the brute-force volume
+            double volume = fees.volume_30d(Venue::BINANCE);
+            size_t expected_tier = 0;
+            for (size_t t = 0; t < binance_thresholds.size(); ++t) {
+                if (volume >= binance_thresholds[t]) expected_tier = t;
+            }
+            CHECK(fees.tier(Venue::BINANCE) == expected_tier);
+            CHECK(fees.taker_bps(symbols::BTCUSDT, Venue::BINANCE) == binance_taker[expected_tier]);
+            ok = ok && fees.tier(Venue::BINANCE) == expected_tier;
+            if (expected_tier != last_tier) ++moves;
+            last_tier = expected_tier;
+        }
+
+        // Tiers moved up and back down (expiry) during the run
+        CHECK(moves >= 2);
+        if (!ok) {
+            std::cerr << "run " << run << " failed" << std::endl;
+            break;
+        }
+    }
+
+    // Schedules: venue-wide, per-instrument override, or none (static fees)
+    {
+        FeeEngine fees;
+        CHECK(!fees.has_schedule(symbols::BTCUSDT, Venue::BINANCE));
+        fees.set_instrument_schedule(symbols::ETHUSDT, Venue::BINANCE, {{0.0, 0.0, 0.0}});
+        CHECK(fees.has_schedule(symbols::ETHUSDT, Venue::BINANCE));
+        CHECK(!fees.has_schedule(symbols::BTCUSDT, Venue::BINANCE));
+        CHECK(fees.taker_bps(symbols::ETHUSDT, Venue::BINANCE) == 0.0);
+        fees.load_defaults();
+        CHECK(fees.has_schedule(symbols::BTCUSDT, Venue::KRAKEN));
+        CHECK(!fees.has_schedule(symbols::BTCUSDT, Venue::FTX));
+    }
+
+    return test::result();
+}
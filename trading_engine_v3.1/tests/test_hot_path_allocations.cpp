@@ -0,0 +1,128 @@
+// Steady-state ticks must not touch the heap: intents, risk reservation
+// and release, and materializing Orders into a reused vector.
+// Logging formats strings, so it is compiled out here.
+#define LOG_ERROR(msg) do {} while (0)
+#define LOG_WARN(msg) do {} while (0)
+#define LOG_INFO(msg) do {} while (0)
+
+#include "test_common.hpp"
+#include "strategies/strategy_coordinator.hpp"
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace trading;
+
+int main() {
+    RiskLimits limits;
+    limits.max_single_symbol_pct = 1.0;     // Unhedged legs on a flat book
+    limits.max_orders_per_second = 0;
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+
+    StrategyCoordinatorConfig config;
+    config.latency_arb_config.max_execution_latency_us = 1e9;
+    config.latency_arb_config.max_concurrent_arbs = INT_MAX;    // Never completed here
+    StaticStrategyCoordinator<OrderBookImbalanceStrategy, LatencyArbitrageStrategy> coordinator(config, risk);
+
+    const std::string symbol = "BTCUSDT";
+    SymbolMap<double> prices;
+    prices[symbols::BTCUSDT] = 50100.0;
+    std::unordered_map<Venue, OrderBook> books;
+    books[Venue::BINANCE] = test::make_book(50000.0, 50001.0);
+    books[Venue::BYBIT] = test::make_book(50200.0, 50201.0);
+
+    std::vector<Order> orders;
+    size_t sent = 0;
+
+    // Each tick: both venues update, then every leg sent is canceled
+    auto tick = [&]() {
+        for (Venue venue : {Venue::BYBIT, Venue::BINANCE}) {
+            auto batch = coordinator.process_market_update(symbol, venue, books[venue], books, prices, orders);
+            for (const auto& order : batch) {
+                coordinator.on_order_terminated(order);
+            }
+            sent += batch.size();
+        }
+    };
+
+    for (int i = 0; i < 100; ++i) {
+        tick();
+    }
+    CHECK(sent >= 200);
+
+    sent = 0;
+    counting.store(true);
+    for (int i = 0; i < 10000; ++i) {
+        tick();
+    }
+    counting.store(false);
+
+    CHECK(sent >= 20000);
+    CHECK(allocations.load() == 0);
+    CHECK(risk.active_reservations() == 0);
+    CHECK_NEAR(risk.get_reserved_gross_exposure(), 0.0, 1e-6);
+
+    // Ledger slots are a fixed pool: holding every slot refuses the next group
+    {
+        RiskLimits small = limits;
+        small.max_reservation_groups = 16;
+        small.max_total_gross_exposure = 1e12;
+        small.max_position_per_symbol = 1e12;
+        small.max_order_size = 1e12;
+        RiskManager bounded(small, tracker);
+
+        std::array<OrderIntent, 2> legs = {
+            OrderIntent(symbols::BTCUSDT, Venue::BINANCE, Side::BUY, OrderType::LIMIT_IOC, 50000.0, 0.01, StrategyKind::LATENCY_ARB),
+            OrderIntent(symbols::BTCUSDT, Venue::BYBIT, Side::SELL, OrderType::LIMIT_IOC, 50200.0, 0.01, StrategyKind::LATENCY_ARB)};
+
+        std::vector<uint64_t> held;
+        for (size_t i = 0; i < 16; ++i) {
+            auto result = bounded.reserve_orders(std::span<const OrderIntent>(legs));
+            CHECK(result.passed);
+            held.push_back(result.reservation_id);
+        }
+        double gross = bounded.get_reserved_gross_exposure();
+        auto full = bounded.reserve_orders(std::span<const OrderIntent>(legs));
+        CHECK(!full.passed);
+        CHECK(std::string(full.reason) == "Reservation ledger full");
+        CHECK_NEAR(bounded.get_reserved_gross_exposure(), gross, 1e-9);
+
+        // A released slot is reused under a new id; the old id is dead
+        bounded.release_reservation(held[0]);
+        auto reused = bounded.reserve_orders(std::span<const OrderIntent>(legs));
+        CHECK(reused.passed);
+        CHECK(reused.reservation_id != held[0]);
+        bounded.release_reservation(held[0]);
+        CHECK(bounded.active_reservations() == 16);
+    }
+
+    return test::result();
+}
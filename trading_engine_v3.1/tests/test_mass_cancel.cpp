@@ -0,0 +1,172 @@
+#include "test_common.hpp"
+#include "core/mass_cancel.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace trading;
+
+namespace {
+
+// Simulated venue: cancels are acked into the tracker (at once, or on ack());
+// `drop_first` orders lose their first cancel, `stuck` orders never cancel
+class FakeGateway : public OrderGateway {
+public:
+    explicit FakeGateway(OrderTracker& tracker, bool immediate = true)
+        : tracker_(tracker), immediate_(immediate) {}
+
+    size_t cancel_orders(Venue venue, std::span<const Order> orders) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callers.insert(std::this_thread::get_id());
+        batches[venue].push_back(orders.size());
+        for (const auto& order : orders) {
+            int attempt = ++attempts[order.client_order_id];
+            if (stuck.count(order.client_order_id)) continue;
+            if (drop_first.count(order.client_order_id) && attempt == 1) continue;
+            pending_.push_back(order);
+        }
+        if (immediate_) {
+            ack_locked();
+        }
+        return orders.size();
+    }
+
+    size_t max_cancel_batch(Venue) const override { return 10; }
+
+    void ack() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ack_locked();
+    }
+
+    std::map<Venue, std::vector<size_t>> batches;
+    std::set<std::thread::id> callers;
+    std::map<std::string, int> attempts;
+    std::set<std::string> drop_first;
+    std::set<std::string> stuck;
+
+private:
+    OrderTracker& tracker_;
+    bool immediate_;
+    std::mutex mutex_;
+    std::vector<Order> pending_;
+
+    void ack_locked() {
+        for (auto order : pending_) {
+            order.status = OrderStatus::CANCELED;
+            tracker_.update_order(order.client_order_id, order);
+        }
+        pending_.clear();
+    }
+};
+
+void add_orders(OrderTracker& tracker, Venue venue, const std::string& prefix, int count) {
+    for (int i = 0; i < count; ++i) {
+        Order order;
+        order.client_order_id = prefix + std::to_string(i);
+        order.order_id = "X" + order.client_order_id;
+        order.symbol = "BTCUSDT";
+        order.venue = venue;
+        order.status = OrderStatus::NEW;
+        tracker.track_order(order);
+    }
+}
+
+MassCanceller::Config fast_config() {
+    MassCanceller::Config config;
+    config.flat_timeout = std::chrono::milliseconds(600);
+    config.poll_interval = std::chrono::milliseconds(1);
+    config.max_rounds = 3;
+    return config;
+}
+
+} // namespace
+
+int main() {
+    // Kill switch: cancels go out in venue batches and the handler returns
+    // before the venue acks; confirmation finishes in the background
+    {
+        OrderTracker tracker;
+        add_orders(tracker, Venue::BINANCE, "B", 25);
+        add_orders(tracker, Venue::BYBIT, "Y", 3);
+        FakeGateway gateway(tracker, false);
+        MassCanceller canceller(tracker, gateway, fast_config());
+        KillSwitch kill_switch;
+        canceller.arm(kill_switch);
+
+        kill_switch.activate("test");
+        CHECK(canceller.in_progress());
+        CHECK(!canceller.last_report().has_value());
+        CHECK((gateway.batches[Venue::BINANCE] == std::vector<size_t>{10, 10, 5}));
+        CHECK((gateway.batches[Venue::BYBIT] == std::vector<size_t>{3}));
+        CHECK((gateway.callers == std::set<std::thread::id>{std::this_thread::get_id()}));
+
+        gateway.ack();
+        auto report = canceller.wait();
+        CHECK(report.has_value() && report->flat);
+        CHECK(report->orders_targeted == 28);
+        CHECK(report->cancels_sent == 28);
+        CHECK(report->venues == 2);
+        CHECK(report->remaining_active == 0);
+        CHECK(!canceller.in_progress());
+    }
+
+    // A lost cancel is re-sent in the next round
+    {
+        OrderTracker tracker;
+        add_orders(tracker, Venue::BINANCE, "B", 5);
+        FakeGateway gateway(tracker);
+        gateway.drop_first.insert("B3");
+        MassCanceller canceller(tracker, gateway, fast_config());
+
+        auto report = canceller.cancel_all();
+        CHECK(report.flat);
+        CHECK(gateway.attempts["B3"] == 2);
+        CHECK(gateway.attempts["B0"] == 1);
+        CHECK(report.cancels_sent == 6);
+    }
+
+    // Never flat: every round retries, then the escalation handler runs once
+    {
+        OrderTracker tracker;
+        add_orders(tracker, Venue::BINANCE, "B", 5);
+        FakeGateway gateway(tracker);
+        gateway.stuck.insert("B1");
+        MassCanceller canceller(tracker, gateway, fast_config());
+
+        int escalations = 0;
+        size_t escalated_remaining = 0;
+        canceller.set_escalation_handler([&](const MassCanceller::Report& report) {
+            ++escalations;
+            escalated_remaining = report.remaining_active;
+        });
+
+        auto report = canceller.cancel_all();
+        CHECK(!report.flat);
+        CHECK(report.remaining_active == 1);
+        CHECK(gateway.attempts["B1"] == 3);
+        CHECK(escalations == 1);
+        CHECK(escalated_remaining == 1);
+
+        // Finished: a second mass cancel may start
+        CHECK(!canceller.in_progress());
+        CHECK(canceller.start());
+        canceller.wait();
+    }
+
+    // A canceller destroyed before activation leaves nothing behind on the switch
+    {
+        OrderTracker tracker;
+        add_orders(tracker, Venue::BINANCE, "B", 2);
+        FakeGateway gateway(tracker);
+        KillSwitch kill_switch;
+        {
+            MassCanceller canceller(tracker, gateway, fast_config());
+            canceller.arm(kill_switch);
+        }
+        kill_switch.activate("test");
+        CHECK(gateway.batches.empty());
+    }
+
+    return test::result();
+}
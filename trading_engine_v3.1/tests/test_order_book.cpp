@@ -0,0 +1,105 @@
+#include "test_common.hpp"
+#include <random>
+
+using namespace trading;
+
+namespace {
+
+// Size and notional of the side's first WEIGHTED_MID_LEVELS levels, summed from scratch
+template<typename Side>
+std::pair<double, double> top_levels(const Side& side) {
+    double quantity = 0.0, notional = 0.0;
+    size_t level = 0;
+    for (auto it = side.begin(); it != side.end() && level < OrderBook::WEIGHTED_MID_LEVELS; ++it, ++level) {
+        quantity += it->second;
+        notional += it->first * it->second;
+    }
+    return {quantity, notional};
+}
+
+double brute_weighted_mid(const OrderBook& book) {
+    if (book.get_bids().empty() || book.get_asks().empty()) return 0.0;
+    auto [bid_qty, bid_notional] = top_levels(book.get_bids());
+    auto [ask_qty, ask_notional] = top_levels(book.get_asks());
+    double bid_vwap = bid_notional / bid_qty;
+    double ask_vwap = ask_notional / ask_qty;
+    return (bid_vwap * ask_qty + ask_vwap * bid_qty) / (bid_qty + ask_qty);
+}
+
+// Ladder levels agree with the book's first levels
+template<typename Side>
+bool ladder_matches(const DepthLadder& ladder, const Side& side) {
+    if (ladder.levels != std::min(side.size(), DepthLadder::LEVELS)) return false;
+    size_t level = 0;
+    for (auto it = side.begin(); level < ladder.levels; ++it, ++level) {
+        if (ladder.price[level] != it->first || ladder.quantity[level] != it->second) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// The O(1) top-level window kept by apply() matches a brute-force re-sum
+// after every update: inserts above, inside and below the window, size
+// changes, deletes that pull the next level in, sides emptying and refilling,
+// and deletes of absent levels
+int main() {
+    for (int run = 0; run < 200; ++run) {
+        std::mt19937_64 rng(48 + run);
+        OrderBook book;
+
+        // Narrow grids empty a side often; wide ones keep levels behind the window
+        int span = 3 + static_cast<int>(rng() % 40);
+        bool ok = true;
+        for (int i = 0; i < 5000 && ok; ++i) {
+            bool bid = rng() % 2 == 0;
+            int offset = static_cast<int>(rng() % span);
+            double price = bid ? 1000.0 - offset * 0.25 : 1000.25 + offset * 0.25;
+            double quantity = rng() % 5 < 2 ? 0.0 : 0.001 * (1 + rng() % 100000);
+            if (bid) {
+                book.update_bid(price, quantity);
+            } else {
+                book.update_ask(price, quantity);
+            }
+
+            double expected = brute_weighted_mid(book);
+            double actual = book.get_weighted_mid();
+            bool mid_ok = std::abs(actual - expected) <= 1e-9 * std::max(expected, 1.0);
+            CHECK_NEAR(actual, expected, 1e-9 * std::max(expected, 1.0));
+
+            bool touch_ok = true;
+            if (!book.get_bids().empty() && !book.get_asks().empty()) {
+                const auto& [bid_price, bid_qty] = *book.get_bids().begin();
+                const auto& [ask_price, ask_qty] = *book.get_asks().begin();
+                double microprice = (bid_price * ask_qty + ask_price * bid_qty) / (bid_qty + ask_qty);
+                touch_ok = book.get_microprice() == microprice &&
+                           book.get_queue_imbalance() == (bid_qty - ask_qty) / (bid_qty + ask_qty);
+            } else {
+                touch_ok = book.get_microprice() == 0.0 && book.get_queue_imbalance() == 0.0;
+            }
+            CHECK(touch_ok);
+
+            bool ladders_ok = true;
+            if (rng() % 8 == 0) {
+                ladders_ok = ladder_matches(book.bid_ladder(), book.get_bids()) &&
+                             ladder_matches(book.ask_ladder(), book.get_asks());
+                CHECK(ladders_ok);
+            }
+            ok = mid_ok && touch_ok && ladders_ok;
+        }
+
+        // Clearing drops the window with the levels
+        book.clear();
+        CHECK(book.get_weighted_mid() == 0.0);
+        book.update_bid(99.0, 2.0);
+        book.update_ask(101.0, 1.0);
+        CHECK_NEAR(book.get_weighted_mid(), brute_weighted_mid(book), 1e-12);
+
+        if (!ok) {
+            std::cerr << "run " << run << " failed" << std::endl;
+            break;
+        }
+    }
+
+    return test::result();
+}
@@ -0,0 +1,154 @@
+#include "test_common.hpp"
+#include "strategies/strategy_coordinator.hpp"
+#include <thread>
+
+using namespace trading;
+
+namespace {
+
+// One ORDERS bucket of exactly `limit` orders per interval
+WeightedRateLimiter::Config orders_per(uint32_t limit, std::chrono::nanoseconds interval) {
+    WeightedRateLimiter::Config config;
+    config.buckets = {WeightedRateLimiter::BucketConfig(WeightedRateLimiter::BucketKind::ORDERS, limit, interval)};
+    config.safety_factor = 1.0;
+    return config;
+}
+
+RiskLimits loose_limits() {
+    RiskLimits limits;
+    limits.max_single_symbol_pct = 1.0;     // Unhedged legs on a flat book
+    return limits;
+}
+
+StrategyCoordinatorConfig arb_config() {
+    StrategyCoordinatorConfig config;
+    config.latency_arb_config.max_execution_latency_us = 1e9;
+    return config;
+}
+
+struct Venues {
+    KillSwitch kill_switch;
+    CircuitBreakerRegistry breakers;
+    RateLimiterRegistry rate_limits;
+    OrderGate gate{kill_switch, breakers};
+
+    Venues() { gate.attach_rate_limits(&rate_limits); }
+};
+
+} // namespace
+
+int main() {
+    const std::string symbol = "BTCUSDT";
+    SymbolMap<double> prices;
+
+    // Gate: a group refused on its second leg refunds the first
+    {
+        Venues venues;
+        auto& binance = venues.rate_limits.add(Venue::BINANCE, 0, orders_per(10, std::chrono::minutes(1)));
+        venues.rate_limits.add(Venue::BYBIT, 0, orders_per(1, std::chrono::minutes(1)));
+        CHECK(venues.gate.check(Venue::BYBIT, OrderType::LIMIT) == OrderGate::Decision::ALLOW);
+
+        std::array<OrderIntent, 2> legs = {
+            OrderIntent(symbols::BTCUSDT, Venue::BINANCE, Side::BUY, OrderType::LIMIT_IOC, 50000.0, 0.1, StrategyKind::LATENCY_ARB),
+            OrderIntent(symbols::BTCUSDT, Venue::BYBIT, Side::SELL, OrderType::LIMIT_IOC, 50200.0, 0.1, StrategyKind::LATENCY_ARB)};
+        CHECK(venues.gate.check_all(legs) == OrderGate::Decision::RATE_LIMITED);
+        CHECK_NEAR(binance.utilization(0), 0.0, 1e-12);
+    }
+
+    std::unordered_map<Venue, OrderBook> arb_books;
+    arb_books[Venue::BINANCE] = test::make_book(50000.0, 50001.0);
+    arb_books[Venue::BYBIT] = test::make_book(50200.0, 50201.0);
+
+    // Arb rejected by risk: no venue tokens spent
+    {
+        Venues venues;
+        auto& binance = venues.rate_limits.add(Venue::BINANCE, 0, orders_per(10, std::chrono::minutes(1)));
+        auto& bybit = venues.rate_limits.add(Venue::BYBIT, 0, orders_per(10, std::chrono::minutes(1)));
+
+        RiskLimits limits = loose_limits();
+        limits.max_order_size = 1.0;
+        OrderTracker tracker;
+        RiskManager risk(limits, tracker);
+        StaticStrategyCoordinator<LatencyArbitrageStrategy> coordinator(arb_config(), risk);
+        coordinator.attach_order_gate(&venues.gate);
+
+        coordinator.generate_intents(symbol, Venue::BYBIT, arb_books[Venue::BYBIT], arb_books, prices);
+        auto intents = coordinator.generate_intents(symbol, Venue::BINANCE, arb_books[Venue::BINANCE], arb_books, prices);
+        CHECK(intents.empty());
+        CHECK_NEAR(binance.utilization(0), 0.0, 1e-12);
+        CHECK_NEAR(bybit.utilization(0), 0.0, 1e-12);
+    }
+
+    // Arb gated on one leg: reservation released, other leg's token refunded
+    {
+        Venues venues;
+        auto& binance = venues.rate_limits.add(Venue::BINANCE, 0, orders_per(10, std::chrono::minutes(1)));
+        venues.rate_limits.add(Venue::BYBIT, 0, orders_per(1, std::chrono::minutes(1)));
+        CHECK(venues.gate.check(Venue::BYBIT, OrderType::LIMIT) == OrderGate::Decision::ALLOW);
+
+        OrderTracker tracker;
+        RiskManager risk(loose_limits(), tracker);
+        StaticStrategyCoordinator<LatencyArbitrageStrategy> coordinator(arb_config(), risk);
+        coordinator.attach_order_gate(&venues.gate);
+
+        coordinator.generate_intents(symbol, Venue::BYBIT, arb_books[Venue::BYBIT], arb_books, prices);
+        auto intents = coordinator.generate_intents(symbol, Venue::BINANCE, arb_books[Venue::BINANCE], arb_books, prices);
+        CHECK(intents.empty());
+        CHECK(risk.active_reservations() == 0);
+        CHECK_NEAR(risk.get_reserved_gross_exposure(), 0.0, 1e-9);
+        CHECK_NEAR(binance.utilization(0), 0.0, 1e-12);
+    }
+
+    // Bid-heavy book: OBI buys on every tick
+    OrderBook obi_book = test::make_book(50000.0, 50001.0, 10.0, 1.0);
+    std::unordered_map<Venue, OrderBook> obi_books;
+    obi_books[Venue::BINANCE] = obi_book;
+
+    // OBI rejected by risk: not charged, not deferred
+    {
+        Venues venues;
+        auto& binance = venues.rate_limits.add(Venue::BINANCE, 0, orders_per(10, std::chrono::minutes(1)));
+
+        RiskLimits limits = loose_limits();
+        limits.max_order_size = 1.0;
+        OrderTracker tracker;
+        RiskManager risk(limits, tracker);
+        StaticStrategyCoordinator<OrderBookImbalanceStrategy> coordinator(StrategyCoordinatorConfig(), risk);
+        coordinator.attach_order_gate(&venues.gate);
+
+        CHECK(coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices).empty());
+        CHECK(coordinator.deferred_intents() == 0);
+        CHECK_NEAR(binance.utilization(0), 0.0, 1e-12);
+    }
+
+    // OBI rate limited: deferred (one per strategy/symbol), sent once tokens free up
+    {
+        Venues venues;
+        venues.rate_limits.add(Venue::BINANCE, 0, orders_per(1, std::chrono::milliseconds(100)));
+
+        StrategyCoordinatorConfig config;
+        config.max_defer_time = std::chrono::seconds(5);
+        OrderTracker tracker;
+        RiskManager risk(loose_limits(), tracker);
+        StaticStrategyCoordinator<OrderBookImbalanceStrategy> coordinator(config, risk);
+        coordinator.attach_order_gate(&venues.gate);
+
+        CHECK(coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices).size() == 1);
+        CHECK(coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices).empty());
+        CHECK(coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices).empty());
+        CHECK(coordinator.deferred_intents() == 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        auto intents = coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices);
+        CHECK(intents.size() == 1);
+        CHECK(intents[0].strategy == StrategyKind::OBI);
+        CHECK(coordinator.deferred_intents() == 1);     // This tick's signal waits in turn
+
+        // Kill switch drops everything waiting
+        venues.kill_switch.activate("test");
+        CHECK(coordinator.generate_intents(symbol, Venue::BINANCE, obi_book, obi_books, prices).empty());
+        CHECK(coordinator.deferred_intents() == 0);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,195 @@
+#include "test_common.hpp"
+#include "strategies/pairs_trading.hpp"
+#include <array>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+// Brute-force window of one pair: statistics recomputed from scratch
+struct Window {
+    std::deque<double> ratio;
+    std::deque<double> log1;
+    std::deque<double> log2;
+    int position = 0;
+
+    double mean() const {
+        double sum = 0.0;
+        for (double r : ratio) sum += r;
+        return sum / ratio.size();
+    }
+
+    double stddev() const {
+        if (ratio.size() < MultiPairManager::MIN_STATS_SAMPLES) return 0.0;
+        double m = mean();
+        double sum = 0.0;
+        for (double r : ratio) sum += (r - m) * (r - m);
+        return std::sqrt(sum / (ratio.size() - 1));
+    }
+
+    double z() const {
+        double s = stddev();
+        return s >= 0.000001 ? (ratio.back() - mean()) / s : 0.0;
+    }
+
+    double correlation() const {
+        size_t n = log1.size();
+        if (n < MultiPairManager::MIN_STATS_SAMPLES) return 0.0;
+        double mx = 0.0, my = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            mx += log2[i];
+            my += log1[i];
+        }
+        mx /= n;
+        my /= n;
+        double sxx = 0.0, syy = 0.0, sxy = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sxx += (log2[i] - mx) * (log2[i] - mx);
+            syy += (log1[i] - my) * (log1[i] - my);
+            sxy += (log2[i] - mx) * (log1[i] - my);
+        }
+        double denominator = std::sqrt(sxx * syy);
+        return denominator < 1e-12 ? 0.0 : std::clamp(sxy / denominator, -1.0, 1.0);
+    }
+};
+
+} // namespace
+
+// Rolling statistics and crossings match a brute-force replay of the window
+int main() {
+    PairsTradingStrategy::Config config;
+    config.lookback_period = 60;
+    config.entry_z_score = 1.5;
+    config.exit_z_score = 0.3;
+    config.stop_loss_z_score = 3.0;
+    config.min_correlation = 0.3;
+
+    const std::array<SymbolRegistry::SymbolId, 3> symbols = {
+        get_symbol_id("BTCUSDT"), get_symbol_id("ETHUSDT"), get_symbol_id("SOLUSDT")};
+
+    MultiPairManager manager;
+    const std::array<std::pair<int, int>, 3> legs = {{{1, 0}, {2, 0}, {1, 2}}};
+    std::vector<Window> windows(legs.size());
+    for (const auto& [a, b] : legs) {
+        manager.add_pair(std::string(get_symbol_name(symbols[a])),
+                         std::string(get_symbol_name(symbols[b])), config);
+    }
+
+    // Common factor plus mean-reverting idiosyncratic noise: correlated legs
+    // whose ratios swing through the entry, exit and stop thresholds
+    std::mt19937_64 rng(39);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    double market = std::log(50000.0);
+    std::array<double, 3> base = {0.0, std::log(2500.0 / 50000.0), std::log(100.0 / 50000.0)};
+    std::array<double, 3> idio = {0.0, 0.0, 0.0};
+
+    SymbolMap<double> prices;
+    std::vector<MultiPairManager::Crossing> crossings;
+    int entries = 0, exits = 0, stops = 0, ambiguous = 0;
+
+    for (int tick = 0; tick < 50000; ++tick) {
+        market += 0.002 * noise(rng);
+        size_t s = rng() % symbols.size();
+        idio[s] = 0.9 * idio[s] + 0.004 * noise(rng);
+        prices[symbols[s]] = std::exp(market + base[s] + idio[s]);
+
+        crossings.clear();
+        manager.on_price(symbols[s], prices, crossings);
+
+        for (MultiPairManager::PairId pair = 0; pair < legs.size(); ++pair) {
+            auto [a, b] = legs[pair];
+            if (a != static_cast<int>(s) && b != static_cast<int>(s)) continue;
+            const double* p1 = prices.find(symbols[a]);
+            const double* p2 = prices.find(symbols[b]);
+            if (!p1 || !p2) continue;
+
+            Window& w = windows[pair];
+            w.ratio.push_back(*p1 / *p2);
+            w.log1.push_back(std::log(*p1));
+            w.log2.push_back(std::log(*p2));
+            if (w.ratio.size() > static_cast<size_t>(config.lookback_period)) {
+                w.ratio.pop_front();
+                w.log1.pop_front();
+                w.log2.pop_front();
+            }
+
+            double z = w.z();
+            double correlation = w.correlation();
+            CHECK_NEAR(manager.z_score(pair), z, 1e-6);
+            CHECK_NEAR(manager.correlation(pair), correlation, 1e-9);
+
+            // Expected crossing from the brute-force state machine
+            const MultiPairManager::Crossing* fired = nullptr;
+            for (const auto& crossing : crossings) {
+                if (crossing.pair == pair) fired = &crossing;
+            }
+
+            bool warm = w.ratio.size() >= static_cast<size_t>(config.lookback_period / 2) &&
+                        w.stddev() != 0.0;
+            int expected_position = w.position;
+            if (warm && w.position == 0) {
+                if (correlation >= config.min_correlation) {
+                    if (z > config.entry_z_score) expected_position = -1;
+                    else if (z < -config.entry_z_score) expected_position = 1;
+                }
+            } else if (warm) {
+                bool stopped = w.position < 0 ? z > config.stop_loss_z_score
+                                              : z < -config.stop_loss_z_score;
+                if (stopped || std::abs(z) < config.exit_z_score) expected_position = 0;
+            }
+
+            // z within rounding of a threshold: either outcome is right
+            auto near = [&](double value, double threshold) {
+                return std::abs(std::abs(value) - threshold) < 1e-6;
+            };
+            bool borderline = near(z, config.entry_z_score) || near(z, config.exit_z_score) ||
+                              near(z, config.stop_loss_z_score) ||
+                              std::abs(correlation - config.min_correlation) < 1e-9;
+            int actual_position = manager.position(pair);
+            if (borderline && actual_position != expected_position) {
+                ++ambiguous;
+                expected_position = actual_position;
+            }
+
+            CHECK(actual_position == expected_position);
+            CHECK((fired != nullptr) == (expected_position != w.position));
+            if (fired) {
+                CHECK_NEAR(fired->mean_ratio, w.mean(), 1e-9 * w.mean());
+                CHECK_NEAR(fired->std_ratio, w.stddev(), 1e-9 * w.mean());
+                CHECK_NEAR(fired->ratio, w.ratio.back(), 1e-15);
+                Side expected_side = expected_position < 0 || (expected_position == 0 && w.position > 0)
+                                   ? Side::SELL : Side::BUY;
+                CHECK(fired->symbol1_side == expected_side);
+                if (fired->kind == MultiPairManager::CrossingKind::ENTRY) ++entries;
+                else if (fired->kind == MultiPairManager::CrossingKind::EXIT) ++exits;
+                else ++stops;
+            }
+            w.position = expected_position;
+        }
+        if (test::failures > 0) break;
+    }
+
+    // The stream exercised every kind of crossing
+    CHECK(entries > 10);
+    CHECK(exits > 10);
+    CHECK(stops > 0);
+    CHECK(ambiguous < 5);
+
+    // Either leg order finds the configured pair (no reversed duplicate)
+    CHECK(manager.find_pair(symbols[1], symbols[0]) == 0);
+    CHECK(manager.find_pair(symbols[0], symbols[1]) == 0);
+    CHECK(manager.find_pair(symbols[2], symbols[1]) == 2);
+    CHECK(manager.find_pair(symbols[0], get_symbol_id("BNBUSDT")) == MultiPairManager::INVALID_PAIR);
+
+    // A seeded hedge ratio is where the Kalman filter starts
+    MultiPairManager seeded;
+    auto pair = seeded.add_pair("ETHUSDT", "BTCUSDT", config, false);
+    CHECK(seeded.hedge_ratio(pair) == 1.0);
+    seeded.seed_hedge_ratio(pair, 0.85);
+    CHECK(seeded.hedge_ratio(pair) == 0.85);
+
+    return test::result();
+}
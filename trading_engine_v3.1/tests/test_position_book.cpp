@@ -0,0 +1,38 @@
+#include "test_common.hpp"
+#include "core/position_book.hpp"
+#include <vector>
+
+using namespace trading;
+
+int main() {
+    constexpr SymbolRegistry::SymbolId BTC = symbols::BTCUSDT;
+    constexpr SymbolRegistry::SymbolId ETH = symbols::ETHUSDT;
+    PositionBook book;
+
+    // A fill on a never-marked symbol is marked at the fill price
+    book.apply_fill(BTC, Side::BUY, 50000.0, 0.5, 0.0, TimePoint{});
+    CHECK_NEAR(book.mark_price(BTC), 50000.0, 1e-9);
+    CHECK_NEAR(book.notional(BTC), 25000.0, 1e-9);
+    CHECK_NEAR(book.unrealized_pnl(BTC), 0.0, 1e-9);
+    CHECK_NEAR(book.totals().gross_exposure, 25000.0, 1e-9);
+
+    // Later fills keep the last mark, not their own price
+    book.set_mark(BTC, 51000.0);
+    book.apply_fill(BTC, Side::BUY, 50500.0, 0.5, 0.0, TimePoint{});
+    CHECK_NEAR(book.mark_price(BTC), 51000.0, 1e-9);
+    CHECK_NEAR(book.notional(BTC), 51000.0, 1e-9);
+    CHECK_NEAR(book.unrealized_pnl(BTC), 1.0 * (51000.0 - 50250.0), 1e-6);
+
+    // Short on a fresh symbol: gross counts it, mark_to_market re-marks it
+    book.apply_fill(ETH, Side::SELL, 2500.0, 4.0, 0.0, TimePoint{});
+    CHECK_NEAR(book.notional(ETH), 10000.0, 1e-9);
+    CHECK_NEAR(book.totals().gross_exposure, 61000.0, 1e-9);
+
+    std::vector<double> prices(book.size(), 0.0);
+    prices[ETH] = 2400.0;
+    auto marked = book.mark_to_market(prices);
+    CHECK_NEAR(book.unrealized_pnl(ETH), 400.0, 1e-9);
+    CHECK_NEAR(marked.gross_exposure, 51000.0 + 9600.0, 1e-9);
+
+    return test::result();
+}
@@ -0,0 +1,108 @@
+#include "test_common.hpp"
+#include "strategies/strategy_coordinator.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+Fill fill_for(const Order& order, double quantity) {
+    Fill fill;
+    fill.symbol = order.symbol;
+    fill.venue = order.venue;
+    fill.side = order.side;
+    fill.price = order.price;
+    fill.quantity = quantity;
+    fill.reservation_id = order.reservation_id;
+    fill.reservation_leg = order.reservation_leg;
+    return fill;
+}
+
+} // namespace
+
+// Reserve -> fill -> terminate through the coordinator's fill path
+int main() {
+    RiskLimits limits;
+    limits.max_single_symbol_pct = 1.0;     // Two unhedged legs on a flat book
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+    StaticStrategyCoordinator<LatencyArbitrageStrategy> coordinator(StrategyCoordinatorConfig(), risk);
+    
+    std::array<Order, 2> legs = {test::leg("BTCUSDT", Side::BUY, 50000.0, 0.1),
+                                 test::leg("ETHUSDT", Side::SELL, 2500.0, 2.0)};
+    auto reservation = risk.reserve_orders(std::span<const Order>(legs));
+    CHECK(reservation.passed);
+    CHECK(risk.get_reserved_gross_exposure() > 0.0);
+    CHECK(risk.active_reservations() == 1);
+    
+    for (size_t i = 0; i < legs.size(); ++i) {
+        legs[i].reservation_id = reservation.reservation_id;
+        legs[i].reservation_leg = static_cast<int>(i);
+    }
+    
+    // Leg 0 fills completely: its share of the reservation becomes position
+    double before = risk.get_reserved_gross_exposure();
+    coordinator.on_fill(fill_for(legs[0], 0.1));
+    CHECK_NEAR(risk.get_reserved_gross_exposure(), before - 5000.0, 1e-6);
+    auto btc = risk.get_position("BTCUSDT");
+    CHECK(btc.has_value() && std::abs(btc->quantity - 0.1) < 1e-12);
+    
+    // Leg 1 partially fills, then the venue cancels the remainder
+    coordinator.on_fill(fill_for(legs[1], 0.5));
+    legs[1].filled_quantity = 0.5;
+    coordinator.on_order_terminated(legs[1]);
+    
+    CHECK_NEAR(risk.get_reserved_gross_exposure(), 0.0, 1e-9);
+    CHECK(risk.active_reservations() == 0);
+    auto eth = risk.get_position("ETHUSDT");
+    CHECK(eth.has_value() && std::abs(eth->quantity + 0.5) < 1e-12);
+    
+    // A second terminate of the same order releases nothing more
+    coordinator.on_order_terminated(legs[1]);
+    CHECK_NEAR(risk.get_reserved_gross_exposure(), 0.0, 1e-9);
+    
+    // Single orders are checked against quantity reserved by in-flight groups
+    {
+        RiskLimits tight = limits;
+        tight.max_position_per_symbol = 10000.0;
+        OrderTracker tight_tracker;
+        RiskManager tight_risk(tight, tight_tracker);
+        
+        std::array<Order, 1> held = {test::leg("BTCUSDT", Side::BUY, 50000.0, 0.15)};
+        CHECK(tight_risk.reserve_orders(std::span<const Order>(held)).passed);
+        
+        auto more = tight_risk.check_order(test::leg("BTCUSDT", Side::BUY, 50000.0, 0.06), 50000.0);
+        CHECK(!more.passed);
+        CHECK(std::string(more.reason) == "Symbol position limit exceeded (incl. reserved)");
+        CHECK(tight_risk.check_order(test::leg("BTCUSDT", Side::SELL, 50000.0, 0.06), 50000.0).passed);
+    }
+    
+    // Concurrent checks never pass more orders than the rate limit allows
+    {
+        RiskLimits rated = limits;
+        rated.max_orders_per_second = 100;
+        OrderTracker rated_tracker;
+        RiskManager rated_risk(rated, rated_tracker);
+        
+        std::atomic<int> passed{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 100; ++i) {
+                    if (rated_risk.check_order(test::leg("BTCUSDT", Side::BUY, 100.0, 0.01), 100.0).passed) {
+                        passed.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(passed.load() > 0);
+        CHECK(passed.load() <= 100);
+    }
+    
+    return test::result();
+}
@@ -0,0 +1,140 @@
+#include "test_common.hpp"
+#include "core/risk_manager.hpp"
+#include <random>
+#include <stdexcept>
+#include <string>
+
+using namespace trading;
+
+namespace {
+
+constexpr SymbolRegistry::SymbolId BTC = symbols::BTCUSDT;
+constexpr SymbolRegistry::SymbolId ETH = symbols::ETHUSDT;
+
+ScenarioEngine::Config grid_only(int workers) {
+    ScenarioEngine::Config config;
+    config.max_symbols = 16;
+    config.monte_carlo_scenarios = 0;
+    config.worker_threads = workers;
+    return config;
+}
+
+} // namespace
+
+int main() {
+    std::vector<double> book;  // Signed notional by SymbolId
+    auto source = [&book](std::vector<double>& out) { out = book; };
+
+    // Flat book: a short is hurt by the +10% grid points, not the first (-10%) one
+    {
+        ScenarioEngine engine(source, nullptr, grid_only(1));
+        engine.add_factor_grid(BTC, 0.10, 5);
+        engine.step();
+
+        CHECK_NEAR(engine.worst_loss(), 0.0, 1e-12);
+        CHECK_NEAR(engine.loss_after_trade(BTC, -1e6), 0.10 * 1e6, 1e-6);
+        CHECK_NEAR(engine.loss_after_trade(BTC, 1e6), 0.10 * 1e6, 1e-6);
+
+        // A symbol with no position yet is still shocked (correlated leg)
+        CHECK(engine.loss_after_trade(ETH, 1e6) > 0.0);
+
+        bool threw = false;
+        try {
+            engine.add_factor_grid(ETH);
+        } catch (const std::logic_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Prediction matches a recompute with the trade booked (any scenario may
+    // become the worst), and the worker pool agrees with a single thread
+    {
+        ScenarioEngine::Config config = grid_only(4);
+        config.monte_carlo_scenarios = 512;
+        ScenarioEngine pooled(source, nullptr, config);
+        config.worker_threads = 1;
+        ScenarioEngine single(source, nullptr, config);
+        pooled.add_factor_grid(BTC);
+        single.add_factor_grid(BTC);
+
+        book.assign(16, 0.0);
+        book[BTC] = 400000.0;
+        book[ETH] = -250000.0;
+        for (int i = 0; i < 3; ++i) {
+            pooled.step();
+            single.step();
+        }
+        CHECK_NEAR(pooled.worst_loss(), single.worst_loss(), 1e-6);
+        CHECK(pooled.worst_loss() > 0.0);
+
+        std::array<NotionalDelta, 3> trades = {NotionalDelta{BTC, -900000.0},
+                                               NotionalDelta{ETH, 600000.0},
+                                               NotionalDelta{BTC, 100000.0}};
+        double predicted = pooled.loss_after_trades(trades);
+
+        book[BTC] += -800000.0;
+        book[ETH] += 600000.0;
+        pooled.step();
+        CHECK_NEAR(pooled.worst_loss(), predicted, 1e-6);
+    }
+
+    // Single-leg envelope agrees with re-pricing every scenario (a split
+    // trade on one symbol takes the full scan)
+    {
+        ScenarioEngine::Config config = grid_only(2);
+        config.monte_carlo_scenarios = 1024;
+        ScenarioEngine engine(source, nullptr, config);
+        engine.add_factor_grid(BTC);
+        engine.add_factor_grid(ETH, 0.2, 3);
+
+        std::mt19937_64 rng(7);
+        std::uniform_real_distribution<double> notional(-2e6, 2e6);
+        for (int round = 0; round < 20; ++round) {
+            book.assign(16, 0.0);
+            for (SymbolRegistry::SymbolId id = 1; id < 16; ++id) {
+                book[id] = notional(rng) * 0.2;
+            }
+            engine.step();
+
+            for (int i = 0; i < 50; ++i) {
+                SymbolRegistry::SymbolId id = static_cast<SymbolRegistry::SymbolId>(1 + rng() % 15);
+                double x = notional(rng);
+                std::array<NotionalDelta, 2> halves = {NotionalDelta{id, x * 0.5}, NotionalDelta{id, x * 0.5}};
+                double scanned = engine.loss_after_trades(halves);
+                CHECK_NEAR(engine.loss_after_trade(id, x), scanned, 1e-6 * std::max(1.0, scanned));
+            }
+            CHECK_NEAR(engine.loss_after_trade(BTC, 0.0), engine.worst_loss(), 1e-6);
+        }
+    }
+
+    // Reservations are stress-checked on the net of their legs
+    {
+        book.assign(16, 0.0);
+        ScenarioEngine engine(source, nullptr, grid_only(2));
+        engine.add_factor_grid(BTC, 0.10, 5);
+        engine.step();
+
+        RiskLimits limits;
+        limits.max_order_size = 1e9;
+        limits.max_position_per_symbol = 1e9;
+        limits.max_total_gross_exposure = 1e10;
+        limits.max_single_symbol_pct = 1.0;
+        limits.max_stress_loss = 1000.0;
+        OrderTracker tracker;
+        RiskManager risk(limits, tracker);
+        risk.attach_scenario_engine(&engine);
+
+        std::array<Order, 2> outright = {test::leg("BTCUSDT", Side::SELL, 50000.0, 1.0),
+                                         test::leg("ETHUSDT", Side::SELL, 2500.0, 4.0)};
+        auto rejected = risk.reserve_orders(std::span<const Order>(outright));
+        CHECK(!rejected.passed);
+        CHECK(std::string(rejected.reason) == "Stress loss limit exceeded");
+
+        std::array<Order, 2> arb = {test::leg("BTCUSDT", Side::BUY, 50000.0, 1.0),
+                                    test::leg("BTCUSDT", Side::SELL, 50001.0, 1.0)};
+        CHECK(risk.reserve_orders(std::span<const Order>(arb)).passed);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,87 @@
+#include "test_common.hpp"
+#include "core/sliding_window_counter.hpp"
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+// The running total matches a brute-force count of the events in the window
+int main() {
+    using std::chrono::milliseconds;
+
+    // Random event stream: an event at t counts iff its bucket is in the
+    // window, so #(t >= now - window + bucket) <= count <= #(t > now - window)
+    {
+        SlidingWindowCounter counter(std::chrono::seconds(1), 10);
+        TimePoint now = Clock::now();
+        std::deque<std::pair<TimePoint, uint64_t>> events;
+        std::mt19937_64 rng(11);
+
+        for (int i = 0; i < 20000; ++i) {
+            // Mostly small steps, sometimes a gap longer than the window
+            int64_t step_us = rng() % 50 == 0 ? 1500000 : static_cast<int64_t>(rng() % 20000);
+            now += std::chrono::microseconds(step_us);
+
+            uint64_t n = 1 + rng() % 3;
+            if (rng() % 4 == 0) {
+                if (counter.try_add(n, 200, now)) {
+                    events.emplace_back(now, n);
+                }
+            } else {
+                counter.add(n, now);
+                events.emplace_back(now, n);
+                if (rng() % 10 == 0) {
+                    counter.remove(n, now);
+                    events.pop_back();
+                }
+            }
+
+            uint64_t low = 0, high = 0;
+            for (const auto& [t, count] : events) {
+                if (t > now - std::chrono::seconds(1)) high += count;
+                if (t >= now - milliseconds(900)) low += count;
+            }
+            uint64_t counted = counter.count(now);
+            CHECK(counted >= low && counted <= high);
+            if (!(counted >= low && counted <= high)) break;
+
+            while (!events.empty() && events.front().first <= now - std::chrono::seconds(2)) {
+                events.pop_front();
+            }
+        }
+    }
+
+    // try_add never lets the window exceed the limit
+    {
+        SlidingWindowCounter counter(std::chrono::seconds(1), 10);
+        TimePoint now = Clock::now();
+        int accepted = 0;
+        for (int i = 0; i < 100; ++i) {
+            accepted += counter.try_add(1, 50, now) ? 1 : 0;
+        }
+        CHECK(accepted == 50);
+        CHECK(counter.count(now) == 50);
+        CHECK(counter.count(now + std::chrono::seconds(2)) == 0);
+    }
+
+    // Concurrent writers inside one window: nothing lost
+    {
+        SlidingWindowCounter counter(std::chrono::seconds(60), 60);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 10000; ++i) {
+                    counter.add();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(counter.count() == 80000);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,88 @@
+#include "test_common.hpp"
+#include "core/string_interning.hpp"
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+int main() {
+    auto& registry = SymbolRegistry::instance();
+    CHECK(registry.count() == COMMON_SYMBOLS.size());
+    CHECK(registry.table_size() == registry.count());
+    CHECK(get_symbol_id("BTCUSDT") == symbols::BTCUSDT);
+
+    constexpr int NUM_NEW = 3000;     // Several table growths
+    std::vector<std::string> names;
+    for (int i = 0; i < NUM_NEW; ++i) {
+        names.push_back("SYM" + std::to_string(i) + "USDT");
+    }
+
+    // Readers racing the writer: any ID found by name resolves back to it.
+    // Registration runs in phases; each phase starts only after every reader
+    // has swept the names since the last one, so lookups overlap the writes
+    // and every registered name is looked up at least once.
+    constexpr int NUM_READERS = 2;
+    constexpr int NUM_PHASES = 10;
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+    std::atomic<int> resolved{0};
+    std::array<std::atomic<int>, NUM_READERS> passes{};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < NUM_READERS; ++r) {
+        readers.emplace_back([&, r] {
+            while (!done.load(std::memory_order_acquire)) {
+                for (const auto& name : names) {
+                    SymbolRegistry::SymbolId id = registry.get_id(name);
+                    if (id == SymbolRegistry::INVALID_SYMBOL) continue;
+                    resolved.fetch_add(1, std::memory_order_relaxed);
+                    if (registry.get_symbol(id) != name) {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                passes[r].fetch_add(1, std::memory_order_release);
+            }
+        });
+    }
+
+    // Wait for every reader to begin a new sweep and then finish it
+    auto wait_for_sweeps = [&] {
+        for (auto& count : passes) {
+            int start = count.load(std::memory_order_acquire);
+            while (count.load(std::memory_order_acquire) < start + 2) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<SymbolRegistry::SymbolId> ids;
+    wait_for_sweeps();
+    for (int phase = 0; phase < NUM_PHASES; ++phase) {
+        for (int i = phase * NUM_NEW / NUM_PHASES; i < (phase + 1) * NUM_NEW / NUM_PHASES; ++i) {
+            ids.push_back(registry.register_symbol(names[i]));
+        }
+        wait_for_sweeps();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(mismatches.load() == 0);
+    CHECK(resolved.load() >= NUM_READERS * NUM_NEW);
+
+    // One slot per symbol after growth (no duplicate for the growing entry)
+    CHECK(registry.count() == COMMON_SYMBOLS.size() + NUM_NEW);
+    CHECK(registry.table_size() == registry.count());
+
+    for (int i = 0; i < NUM_NEW; ++i) {
+        CHECK(ids[i] == COMMON_SYMBOLS.size() + 1 + i);
+        CHECK(registry.get_symbol(ids[i]) == names[i]);
+        CHECK(registry.register_symbol(names[i]) == ids[i]);
+    }
+    CHECK(registry.count() == COMMON_SYMBOLS.size() + NUM_NEW);
+
+    return test::result();
+}
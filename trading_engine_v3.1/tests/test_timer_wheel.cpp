@@ -0,0 +1,106 @@
+#include "test_common.hpp"
+#include "core/timer_wheel.hpp"
+#include <random>
+#include <vector>
+
+using namespace trading;
+
+// Every timer fires exactly once, in the first advance() that reaches its
+// deadline tick - never early, never late, never twice - including timers
+// that cascade through every level, park beyond the top level, or are
+// scheduled from inside fire()
+int main() {
+    using std::chrono::microseconds;
+    using std::chrono::milliseconds;
+
+    for (int run = 0; run < 10; ++run) {
+        std::mt19937_64 rng(45 + run);
+        const TimePoint start{milliseconds(1000000)};
+        TimerWheel<size_t> wheel(milliseconds(1), start);
+
+        auto ticks = [](TimePoint t) {
+            return static_cast<uint64_t>(std::chrono::duration_cast<microseconds>(t.time_since_epoch()).count() / 1000);
+        };
+        auto due_tick = [&](TimePoint deadline, uint64_t current) {
+            uint64_t when = ticks(deadline);
+            if (std::chrono::duration_cast<microseconds>(deadline.time_since_epoch()).count() % 1000 != 0) ++when;
+            return std::max(when, current + 1);
+        };
+
+        std::vector<uint64_t> due;              // Brute force: due tick per timer
+        std::vector<char> fired;
+        TimePoint now = start;
+        uint64_t current = ticks(start);
+        size_t pending = 0;
+        bool ok = true;
+
+        auto schedule = [&](TimePoint deadline, uint64_t at_tick) {
+            due.push_back(due_tick(deadline, at_tick));
+            fired.push_back(0);
+            ++pending;
+            wheel.schedule(deadline, due.size() - 1);
+        };
+
+        for (int step = 0; step < 10000 && ok; ++step) {
+            if (rng() % 10 < 4) {
+                // Delays across every level, past the top level's range, and in the past
+                int64_t delay_us;
+                switch (rng() % 5) {
+                    case 0: delay_us = static_cast<int64_t>(rng() % 70000); break;
+                    case 1: delay_us = static_cast<int64_t>(rng() % 5000000); break;
+                    case 2: delay_us = static_cast<int64_t>(rng() % 400000000); break;
+                    case 3: delay_us = static_cast<int64_t>(rng() % 40000000000LL); break;
+                    default: delay_us = -static_cast<int64_t>(rng() % 5000); break;
+                }
+                schedule(now + microseconds(delay_us), current);
+                continue;
+            }
+
+            // Small steps, long jumps, and occasionally hours at once
+            int64_t step_us;
+            switch (rng() % 4) {
+                case 0: step_us = static_cast<int64_t>(rng() % 3000); break;
+                case 1: step_us = static_cast<int64_t>(rng() % 300000); break;
+                case 2: step_us = static_cast<int64_t>(rng() % 1000); break;
+                default: step_us = rng() % 50 == 0 ? static_cast<int64_t>(rng() % 20000000000LL) : 0; break;
+            }
+            now += microseconds(step_us);
+            uint64_t target = ticks(now);
+
+            uint64_t last_fired = 0;
+            wheel.advance(now, [&](size_t& id) {
+                bool valid = !fired[id] && due[id] <= target && due[id] > current && due[id] >= last_fired;
+                CHECK(valid);
+                ok = ok && valid;
+                fired[id] = 1;
+                --pending;
+                last_fired = due[id];
+
+                // Re-arm from inside fire(): may land inside this advance
+                if (rng() % 8 == 0) {
+                    TimePoint deadline = TimePoint{milliseconds(due[id])} +
+                                         microseconds(static_cast<int64_t>(rng() % 200000));
+                    schedule(deadline, due[id]);
+                }
+            });
+            current = std::max(current, target);
+
+            // Nothing due by now is still pending
+            for (size_t id = 0; id < due.size() && ok; ++id) {
+                if (!fired[id] && due[id] <= current) {
+                    CHECK(fired[id]);
+                    ok = false;
+                }
+            }
+            CHECK(wheel.size() == pending);
+            ok = ok && wheel.size() == pending;
+        }
+
+        if (!ok) {
+            std::cerr << "run " << run << " failed" << std::endl;
+            break;
+        }
+    }
+
+    return test::result();
+}
@@ -0,0 +1,93 @@
+#include "test_common.hpp"
+#include "core/risk_manager.hpp"
+#include <random>
+#include <string>
+
+using namespace trading;
+
+namespace {
+
+constexpr SymbolRegistry::SymbolId BTC = symbols::BTCUSDT;
+constexpr SymbolRegistry::SymbolId ETH = symbols::ETHUSDT;
+
+struct LastPrices {
+    double btc;
+    double eth;
+};
+
+// Correlated random walks so the covariance has off-diagonal terms
+LastPrices warm_up(PortfolioVarEngine& engine, int steps) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> shock(0.0, 0.01);
+    LastPrices px{50000.0, 2500.0};
+    for (int i = 0; i < steps; ++i) {
+        double common = shock(rng);
+        px.btc *= std::exp(common + 0.5 * shock(rng));
+        px.eth *= std::exp(0.8 * common + shock(rng));
+        engine.on_price(BTC, px.btc);
+        engine.on_price(ETH, px.eth);
+        engine.step();
+    }
+    return px;
+}
+
+} // namespace
+
+int main() {
+    PortfolioVarEngine::Config config;
+    config.max_symbols = 8;
+    PortfolioVarEngine engine(config);
+    LastPrices px = warm_up(engine, 200);
+
+    // Flat book: VaR and marginal VaR are 0, but a trade still carries risk
+    CHECK_NEAR(engine.portfolio_var(), 0.0, 1e-12);
+    CHECK_NEAR(engine.marginal_var(BTC), 0.0, 1e-12);
+    CHECK_NEAR(engine.var_after_trade(BTC, 1e6),
+               config.confidence_z * 1e6 * engine.volatility(BTC), 1e-6);
+
+    // With a book: a zero trade is the current VaR
+    engine.on_position(BTC, 0.5);
+    engine.on_position(ETH, -4.0);
+    engine.step();  // Prices unchanged: covariance stays put
+    CHECK(engine.portfolio_var() > 0.0);
+    CHECK_NEAR(engine.var_after_trade(BTC, 0.0), engine.portfolio_var(), 1e-9);
+
+    // A group that dominates the book (two BTC legs net to +1.5M)
+    std::array<NotionalDelta, 3> legs = {NotionalDelta{BTC, 2e6},
+                                         NotionalDelta{ETH, -1e6},
+                                         NotionalDelta{BTC, -0.5e6}};
+    double predicted = engine.var_after_trades(legs);
+
+    // Book the same trade and let the engine recompute: exact, not first-order
+    engine.on_position(BTC, 0.5 + 1.5e6 / px.btc);
+    engine.on_position(ETH, -4.0 - 1e6 / px.eth);
+    engine.step();
+    CHECK_NEAR(engine.portfolio_var(), predicted, predicted * 1e-9);
+
+    // Reservations are checked on the group's net VaR
+    RiskLimits limits;
+    limits.max_order_size = 1e9;
+    limits.max_position_per_symbol = 1e9;
+    limits.max_total_gross_exposure = 1e10;
+    limits.max_single_symbol_pct = 1.0;
+    limits.max_portfolio_var = 100.0;
+    OrderTracker tracker;
+    RiskManager risk(limits, tracker);
+
+    PortfolioVarEngine flat(config);
+    warm_up(flat, 200);
+    risk.attach_var_engine(&flat);
+
+    std::array<Order, 2> outright = {test::leg("BTCUSDT", Side::BUY, px.btc, 1.0),
+                                     test::leg("ETHUSDT", Side::BUY, px.eth, 10.0)};
+    auto rejected = risk.reserve_orders(std::span<const Order>(outright));
+    CHECK(!rejected.passed);
+    CHECK(std::string(rejected.reason) == "Portfolio VaR limit exceeded");
+
+    // Same-symbol arb legs net to (almost) nothing
+    std::array<Order, 2> arb = {test::leg("BTCUSDT", Side::BUY, px.btc, 1.0),
+                                test::leg("BTCUSDT", Side::SELL, px.btc * 1.00001, 1.0)};
+    CHECK(risk.reserve_orders(std::span<const Order>(arb)).passed);
+
+    return test::result();
+}